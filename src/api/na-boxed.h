@@ -39,6 +39,16 @@
  * The NABoxed structure is a way of handling various types of data in an
  * opaque structure.
  *
+ * Starting with 3.3, #NABoxed is no more a #GObject, but a small
+ * structure which holds the type of the data and its value. It is
+ * registered as a boxed #GType, so that it may still be stored in a
+ * #GValue when needed.
+ *
+ * This is an ABI change: NABoxedClass and the NA_BOXED_CLASS(),
+ * NA_IS_BOXED_CLASS() and NA_BOXED_GET_CLASS() macros are removed,
+ * NA_BOXED() is a plain cast, and NA_IS_BOXED() only checks that the
+ * pointer is not %NULL. A plugin which uses #NABoxed must be rebuilt.
+ *
  * Since: 3.1
  */
 
@@ -47,29 +57,10 @@
 G_BEGIN_DECLS
 
 #define NA_TYPE_BOXED                ( na_boxed_get_type())
-#define NA_BOXED( object )           ( G_TYPE_CHECK_INSTANCE_CAST( object, NA_TYPE_BOXED, NABoxed ))
-#define NA_BOXED_CLASS( klass )      ( G_TYPE_CHECK_CLASS_CAST( klass, NA_TYPE_BOXED, NABoxedClass ))
-#define NA_IS_BOXED( object )        ( G_TYPE_CHECK_INSTANCE_TYPE( object, NA_TYPE_BOXED ))
-#define NA_IS_BOXED_CLASS( klass )   ( G_TYPE_CHECK_CLASS_TYPE(( klass ), NA_TYPE_BOXED ))
-#define NA_BOXED_GET_CLASS( object ) ( G_TYPE_INSTANCE_GET_CLASS(( object ), NA_TYPE_BOXED, NABoxedClass ))
-
-typedef struct _NABoxedPrivate       NABoxedPrivate;
-
-typedef struct {
-	/*< private >*/
-	GObject         parent;
-	NABoxedPrivate *private;
-}
-	NABoxed;
-
-typedef struct _NABoxedClassPrivate  NABoxedClassPrivate;
+#define NA_BOXED( object )           (( NABoxed * )( object ))
+#define NA_IS_BOXED( object )        (( object ) != NULL )
 
-typedef struct {
-	/*< private >*/
-	GObjectClass         parent;
-	NABoxedClassPrivate *private;
-}
-	NABoxedClass;
+typedef struct _NABoxed              NABoxed;
 
 GType         na_boxed_get_type       ( void );
 void          na_boxed_set_type       ( NABoxed *boxed, guint type );
@@ -77,6 +68,7 @@ void          na_boxed_set_type       ( NABoxed *boxed, guint type );
 gboolean      na_boxed_are_equal      ( const NABoxed *a, const NABoxed *b );
 NABoxed      *na_boxed_copy           ( const NABoxed *boxed );
 void          na_boxed_dump           ( const NABoxed *boxed );
+void          na_boxed_free           ( NABoxed *boxed );
 NABoxed      *na_boxed_new_from_string( guint type, const gchar *string );
 
 gboolean      na_boxed_get_boolean    ( const NABoxed *boxed );
@@ -39,13 +39,24 @@
  * The object which encapsulates an elementary data of #NAIFactoryObject.
  * A #NADataBoxed object has a type and a value.
  *
- * #NADataBoxed class is derived from #NABoxed one, and implements the same
- * types that those defined in na-data-types.h.
+ * #NADataBoxed structure extends the #NABoxed one, and implements the
+ * same types that those defined in na-data-types.h. A #NADataBoxed may
+ * so be used everywhere a #NABoxed is expected, through the NA_BOXED()
+ * cast.
  *
- * Additionally, #NADataBoxed class holds the #NADataDef data definition
+ * Additionally, #NADataBoxed structure holds the #NADataDef data definition
  * suitable for a NAFactoryObject object. It such provides default value
  * and validity status.
  *
+ * Starting with 3.3, #NADataBoxed is no more a #GObject, but a reference
+ * counted structure. This is an ABI change: NADataBoxedClass and the
+ * NA_DATA_BOXED_CLASS(), NA_IS_DATA_BOXED_CLASS() and
+ * NA_DATA_BOXED_GET_CLASS() macros are removed, NA_DATA_BOXED() is a
+ * plain cast, NA_IS_DATA_BOXED() only checks that the pointer is not
+ * %NULL, and na_data_boxed_ref() and na_data_boxed_unref() replace
+ * g_object_ref() and g_object_unref(). A plugin which uses #NADataBoxed
+ * must be rebuilt.
+ *
  * Since: 2.30
  */
 
@@ -57,33 +68,16 @@
 G_BEGIN_DECLS
 
 #define NA_TYPE_DATA_BOXED                ( na_data_boxed_get_type())
-#define NA_DATA_BOXED( object )           ( G_TYPE_CHECK_INSTANCE_CAST( object, NA_TYPE_DATA_BOXED, NADataBoxed ))
-#define NA_DATA_BOXED_CLASS( klass )      ( G_TYPE_CHECK_CLASS_CAST( klass, NA_TYPE_DATA_BOXED, NADataBoxedClass ))
-#define NA_IS_DATA_BOXED( object )        ( G_TYPE_CHECK_INSTANCE_TYPE( object, NA_TYPE_DATA_BOXED ))
-#define NA_IS_DATA_BOXED_CLASS( klass )   ( G_TYPE_CHECK_CLASS_TYPE(( klass ), NA_TYPE_DATA_BOXED ))
-#define NA_DATA_BOXED_GET_CLASS( object ) ( G_TYPE_INSTANCE_GET_CLASS(( object ), NA_TYPE_DATA_BOXED, NADataBoxedClass ))
-
-typedef struct _NADataBoxedPrivate        NADataBoxedPrivate;
-
-typedef struct {
-	/*< private >*/
-	NABoxed             parent;
-	NADataBoxedPrivate *private;
-}
-	NADataBoxed;
-
-typedef struct _NADataBoxedClassPrivate   NADataBoxedClassPrivate;
+#define NA_DATA_BOXED( object )           (( NADataBoxed * )( object ))
+#define NA_IS_DATA_BOXED( object )        (( object ) != NULL )
 
-typedef struct {
-	/*< private >*/
-	NABoxedClass             parent;
-	NADataBoxedClassPrivate *private;
-}
-	NADataBoxedClass;
+typedef struct _NADataBoxed               NADataBoxed;
 
 GType            na_data_boxed_get_type( void );
 
 NADataBoxed     *na_data_boxed_new            ( const NADataDef *def );
+NADataBoxed     *na_data_boxed_ref            ( NADataBoxed *boxed );
+void             na_data_boxed_unref          ( NADataBoxed *boxed );
 
 const NADataDef *na_data_boxed_get_data_def   ( const NADataBoxed *boxed );
 void             na_data_boxed_set_data_def   ( NADataBoxed *boxed, const NADataDef *def );
@@ -92,15 +92,44 @@ typedef struct {
 }
 	NAIContextInterface;
 
+/**
+ * NAIContextIndex:
+ * @ICONTEXT_INDEX_MIMETYPES:  the positive mimetypes conditions.
+ * @ICONTEXT_INDEX_SCHEMES:    the positive schemes conditions.
+ * @ICONTEXT_INDEX_EXTENSIONS: the extensions of the positive basenames
+ *                             conditions.
+ *
+ * The conditions which may be used to index the #NAIContext objects,
+ * see na_icontext_get_index_keys().
+ *
+ * Since: 3.3
+ */
+typedef enum {
+	ICONTEXT_INDEX_MIMETYPES = 1,
+	ICONTEXT_INDEX_SCHEMES,
+	ICONTEXT_INDEX_EXTENSIONS
+}
+	NAIContextIndex;
+
 GType    na_icontext_get_type( void );
 
 gboolean na_icontext_are_equal       ( const NAIContext *a, const NAIContext *b );
 gboolean na_icontext_is_candidate    ( const NAIContext *context, guint target, GList *selection );
+gboolean na_icontext_may_be_candidate( const NAIContext *context, guint target, GList *selection );
+gboolean na_icontext_is_static       ( const NAIContext *context );
+gboolean na_icontext_needs_attributes( const NAIContext *context );
 gboolean na_icontext_is_valid        ( const NAIContext *context );
 
+gboolean na_icontext_get_index_keys  ( const NAIContext *context, NAIContextIndex index, GSList **keys );
+gboolean na_icontext_is_mimetype_of  ( const gchar *mimetype, const gchar *pattern, gboolean is_regular );
+
 void     na_icontext_check_mimetypes ( const NAIContext *context );
 
+void     na_icontext_begin_selection ( GList *selection );
+void     na_icontext_end_selection   ( void );
+
 void     na_icontext_copy            ( NAIContext *context, const NAIContext *source );
+void     na_icontext_data_changed    ( NAIContext *context, const gchar *name );
 void     na_icontext_read_done       ( NAIContext *context );
 void     na_icontext_set_scheme      ( NAIContext *context, const gchar *scheme, gboolean selected );
 void     na_icontext_set_only_desktop( NAIContext *context, const gchar *desktop, gboolean selected );
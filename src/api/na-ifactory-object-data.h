@@ -124,6 +124,7 @@ G_BEGIN_DECLS
 #define NAFO_DATA_STARTUP_NOTIFY            "na-factory-data-startup-notify"
 #define NAFO_DATA_STARTUP_WMCLASS           "na-factory-data-startup-wm-class"
 #define NAFO_DATA_EXECUTE_AS                "na-factory-data-execute-as"
+#define NAFO_DATA_EXECUTION_CHUNKED         "na-factory-data-execution-chunked"
 
 /**
  * NA_FACTORY_OBJECT_CONDITIONS_GROUP:
@@ -0,0 +1,73 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2014 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_NA_BOXED_PRIV_H__
+#define __CORE_NA_BOXED_PRIV_H__
+
+/* @title: NABoxed
+ * @short_description: #NABoxed private data definition.
+ * @include: core/na-boxed-priv.h
+ *
+ * The #NABoxed structure is only known of na-boxed.c and na-data-boxed.c,
+ * the latter embedding it at the head of each #NADataBoxed.
+ *
+ * na_data_boxed_is_shared() lets NAFactoryObject know when a
+ * #NADataBoxed must be replaced rather than modified.
+ */
+
+#include <api/na-boxed.h>
+#include <api/na-data-boxed.h>
+
+G_BEGIN_DECLS
+
+typedef struct _NABoxedDef           NABoxedDef;
+
+struct _NABoxed {
+	const NABoxedDef *def;
+	gboolean          is_set;
+	gboolean          hash_valid;
+	guint             hash;
+	union {
+		gboolean      boolean;
+		void         *pointer;
+		gchar        *string;
+		GSList       *string_list;
+		guint         uint;
+		GList        *uint_list;
+	} u;
+};
+
+void     na_boxed_clear         ( NABoxed *boxed );
+guint    na_boxed_hash          ( const NABoxed *boxed );
+
+gboolean na_data_boxed_is_shared( const NADataBoxed *boxed );
+
+G_END_DECLS
+
+#endif /* __CORE_NA_BOXED_PRIV_H__ */
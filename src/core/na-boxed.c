@@ -38,19 +38,16 @@
 #include <api/na-data-types.h>
 #include <api/na-core-utils.h>
 
-/* private class data
- */
-struct _NABoxedClassPrivate {
-	void *empty;						/* so that gcc -pedantic is happy */
-};
+#include "na-boxed-priv.h"
 
 /* BoxedDef:
  * This is the structure which fully defines the behavior of this data type.
  */
-typedef struct {
+struct _NABoxedDef {
 	guint            type;
 	const gchar     *label;
 	gboolean      ( *are_equal )     ( const NABoxed *, const NABoxed * );
+	guint         ( *hash )          ( const NABoxed * );
 	void          ( *copy )          ( NABoxed *, const NABoxed * );
 	void          ( *free )          ( NABoxed * );
 	void          ( *from_string )   ( NABoxed *, const gchar * );
@@ -64,40 +61,18 @@ typedef struct {
 	GList       * ( *to_uint_list )  ( const NABoxed * );
 	void          ( *to_value )      ( const NABoxed *, GValue * );
 	void        * ( *to_void )       ( const NABoxed * );
-}
-	BoxedDef;
-
-/* private instance data
- */
-struct _NABoxedPrivate {
-	gboolean        dispose_has_run;
-	const BoxedDef *def;
-	gboolean        is_set;
-	union {
-		gboolean    boolean;
-		void       *pointer;
-		gchar      *string;
-		GSList     *string_list;
-		guint       uint;
-		GList      *uint_list;
-	} u;
 };
 
-#define LIST_SEPARATOR						";"
-
-static GObjectClass *st_parent_class   = NULL;
+typedef struct _NABoxedDef           BoxedDef;
 
-static GType           register_type( void );
-static void            class_init( NABoxedClass *klass );
-static void            instance_init( GTypeInstance *instance, gpointer klass );
-static void            instance_dispose( GObject *object );
-static void            instance_finalize( GObject *object );
+#define LIST_SEPARATOR						";"
 
 static NABoxed        *boxed_new( const BoxedDef *def );
 static const BoxedDef *get_boxed_def( guint type );
 static gchar         **string_to_array( const gchar *string );
 
 static gboolean        bool_are_equal( const NABoxed *a, const NABoxed *b );
+static guint           bool_hash( const NABoxed *boxed );
 static void            bool_copy( NABoxed *dest, const NABoxed *src );
 static void            bool_free( NABoxed *boxed );
 static void            bool_from_string( NABoxed *boxed, const gchar *string );
@@ -111,6 +86,7 @@ static void            bool_to_value( const NABoxed *boxed, GValue *value );
 static void           *bool_to_void( const NABoxed *boxed );
 
 static gboolean        pointer_are_equal( const NABoxed *a, const NABoxed *b );
+static guint           pointer_hash( const NABoxed *boxed );
 static void            pointer_copy( NABoxed *dest, const NABoxed *src );
 static void            pointer_free( NABoxed *boxed );
 static void            pointer_from_string( NABoxed *boxed, const gchar *string );
@@ -122,6 +98,7 @@ static void            pointer_to_value( const NABoxed *boxed, GValue *value );
 static void           *pointer_to_void( const NABoxed *boxed );
 
 static gboolean        string_are_equal( const NABoxed *a, const NABoxed *b );
+static guint           string_hash( const NABoxed *boxed );
 static void            string_copy( NABoxed *dest, const NABoxed *src );
 static void            string_free( NABoxed *boxed );
 static void            string_from_string( NABoxed *boxed, const gchar *string );
@@ -133,6 +110,7 @@ static void            string_to_value( const NABoxed *boxed, GValue *value );
 static void           *string_to_void( const NABoxed *boxed );
 
 static gboolean        string_list_are_equal( const NABoxed *a, const NABoxed *b );
+static guint           string_list_hash( const NABoxed *boxed );
 static void            string_list_copy( NABoxed *dest, const NABoxed *src );
 static void            string_list_free( NABoxed *boxed );
 static void            string_list_from_string( NABoxed *boxed, const gchar *string );
@@ -145,8 +123,10 @@ static void            string_list_to_value( const NABoxed *boxed, GValue *value
 static void           *string_list_to_void( const NABoxed *boxed );
 
 static gboolean        locale_are_equal( const NABoxed *a, const NABoxed *b );
+static guint           locale_hash( const NABoxed *boxed );
 
 static gboolean        uint_are_equal( const NABoxed *a, const NABoxed *b );
+static guint           uint_hash( const NABoxed *boxed );
 static void            uint_copy( NABoxed *dest, const NABoxed *src );
 static void            uint_free( NABoxed *boxed );
 static void            uint_from_string( NABoxed *boxed, const gchar *string );
@@ -159,6 +139,7 @@ static void            uint_to_value( const NABoxed *boxed, GValue *value );
 static void           *uint_to_void( const NABoxed *boxed );
 
 static gboolean        uint_list_are_equal( const NABoxed *a, const NABoxed *b );
+static guint           uint_list_hash( const NABoxed *boxed );
 static void            uint_list_copy( NABoxed *dest, const NABoxed *src );
 static void            uint_list_free( NABoxed *boxed );
 static void            uint_list_from_string( NABoxed *boxed, const gchar *string );
@@ -174,6 +155,7 @@ static BoxedDef st_boxed_def[] = {
 		{ NA_DATA_TYPE_BOOLEAN,
 				"boolean",
 				bool_are_equal,
+				bool_hash,
 				bool_copy,
 				bool_free,
 				bool_from_string,
@@ -191,6 +173,7 @@ static BoxedDef st_boxed_def[] = {
 		{ NA_DATA_TYPE_POINTER,
 				"pointer",
 				pointer_are_equal,
+				pointer_hash,
 				pointer_copy,
 				pointer_free,
 				pointer_from_string,
@@ -208,6 +191,7 @@ static BoxedDef st_boxed_def[] = {
 		{ NA_DATA_TYPE_STRING,
 				"string",
 				string_are_equal,
+				string_hash,
 				string_copy,
 				string_free,
 				string_from_string,
@@ -225,6 +209,7 @@ static BoxedDef st_boxed_def[] = {
 		{ NA_DATA_TYPE_STRING_LIST,
 				"string_list",
 				string_list_are_equal,
+				string_list_hash,
 				string_list_copy,
 				string_list_free,
 				string_list_from_string,
@@ -242,6 +227,7 @@ static BoxedDef st_boxed_def[] = {
 		{ NA_DATA_TYPE_LOCALE_STRING,
 				"locale_string",
 				locale_are_equal,
+				locale_hash,
 				string_copy,
 				string_free,
 				string_from_string,
@@ -259,6 +245,7 @@ static BoxedDef st_boxed_def[] = {
 		{ NA_DATA_TYPE_UINT,
 				"uint",
 				uint_are_equal,
+				uint_hash,
 				uint_copy,
 				uint_free,
 				uint_from_string,
@@ -276,6 +263,7 @@ static BoxedDef st_boxed_def[] = {
 		{ NA_DATA_TYPE_UINT_LIST,
 				"uint_list",
 				uint_list_are_equal,
+				uint_list_hash,
 				uint_list_copy,
 				uint_list_free,
 				uint_list_from_string,
@@ -299,127 +287,20 @@ na_boxed_get_type( void )
 	static GType item_type = 0;
 
 	if( item_type == 0 ){
-		item_type = register_type();
+		item_type = g_boxed_type_register_static( "NABoxed",
+				( GBoxedCopyFunc ) na_boxed_copy, ( GBoxedFreeFunc ) na_boxed_free );
 	}
 
 	return( item_type );
 }
 
-static GType
-register_type( void )
-{
-	static const gchar *thisfn = "na_boxed_register_type";
-	GType type;
-
-	static GTypeInfo info = {
-		sizeof( NABoxedClass ),
-		NULL,
-		NULL,
-		( GClassInitFunc ) class_init,
-		NULL,
-		NULL,
-		sizeof( NABoxed ),
-		0,
-		( GInstanceInitFunc ) instance_init
-	};
-
-	g_debug( "%s", thisfn );
-
-	type = g_type_register_static( G_TYPE_OBJECT, "NABoxed", &info, 0 );
-
-	return( type );
-}
-
-static void
-class_init( NABoxedClass *klass )
-{
-	static const gchar *thisfn = "na_boxed_class_init";
-	GObjectClass *object_class;
-
-	g_debug( "%s: klass=%p", thisfn, ( void * ) klass );
-
-	st_parent_class = g_type_class_peek_parent( klass );
-
-	object_class = G_OBJECT_CLASS( klass );
-	object_class->dispose = instance_dispose;
-	object_class->finalize = instance_finalize;
-
-	klass->private = g_new0( NABoxedClassPrivate, 1 );
-}
-
-static void
-instance_init( GTypeInstance *instance, gpointer klass )
-{
-	static const gchar *thisfn = "na_boxed_instance_init";
-	NABoxed *self;
-
-	g_return_if_fail( NA_IS_BOXED( instance ));
-
-	g_debug( "%s: instance=%p (%s), klass=%p",
-			thisfn, ( void * ) instance, G_OBJECT_TYPE_NAME( instance ), ( void * ) klass );
-
-	self = NA_BOXED( instance );
-
-	self->private = g_new0( NABoxedPrivate, 1 );
-
-	self->private->dispose_has_run = FALSE;
-	self->private->def = NULL;
-	self->private->is_set = FALSE;
-}
-
-static void
-instance_dispose( GObject *object )
-{
-	NABoxed *self;
-
-	g_return_if_fail( NA_IS_BOXED( object ));
-
-	self = NA_BOXED( object );
-
-	if( !self->private->dispose_has_run ){
-
-		self->private->dispose_has_run = TRUE;
-
-		/* chain up to the parent class */
-		if( G_OBJECT_CLASS( st_parent_class )->dispose ){
-			G_OBJECT_CLASS( st_parent_class )->dispose( object );
-		}
-	}
-}
-
-static void
-instance_finalize( GObject *object )
-{
-	static const gchar *thisfn = "na_boxed_instance_finalize";
-	NABoxed *self;
-
-	g_return_if_fail( NA_IS_BOXED( object ));
-
-	g_debug( "%s: object=%p (%s)", thisfn, ( void * ) object, G_OBJECT_TYPE_NAME( object ));
-
-	self = NA_BOXED( object );
-
-	if( self->private->def ){
-		if( self->private->def->free ){
-			( *self->private->def->free )( self );
-		}
-	}
-
-	g_free( self->private );
-
-	/* chain call to parent class */
-	if( G_OBJECT_CLASS( st_parent_class )->finalize ){
-		G_OBJECT_CLASS( st_parent_class )->finalize( object );
-	}
-}
-
 static NABoxed *
 boxed_new( const BoxedDef *def )
 {
 	NABoxed *boxed;
 
-	boxed = g_object_new( NA_TYPE_BOXED, NULL );
-	boxed->private->def = def;
+	boxed = g_slice_new0( NABoxed );
+	boxed->def = def;
 
 	return( boxed );
 }
@@ -481,12 +362,59 @@ string_to_array( const gchar *string )
 	return( array );
 }
 
+/*
+ * na_boxed_clear:
+ * @boxed: this #NABoxed structure.
+ *
+ * Releases the content of @boxed, which is left unset, but keeps its
+ * type. The structure itself is not released, as it may be embedded in
+ * a larger one (see #NADataBoxed).
+ */
+void
+na_boxed_clear( NABoxed *boxed )
+{
+	g_return_if_fail( NA_IS_BOXED( boxed ));
+
+	if( boxed->def && boxed->def->free ){
+		( *boxed->def->free )( boxed );
+	}
+	boxed->hash_valid = FALSE;
+}
+
+/*
+ * na_boxed_hash:
+ * @boxed: this #NABoxed structure.
+ *
+ * Returns: a hash of the value of @boxed, so that two #NABoxed which are
+ * equal in the na_boxed_are_equal() sense have the same hash.
+ *
+ * The hash is computed on first request, and kept until the value
+ * is modified.
+ */
+guint
+na_boxed_hash( const NABoxed *boxed )
+{
+	NABoxed *cache;
+
+	g_return_val_if_fail( NA_IS_BOXED( boxed ), 0 );
+	g_return_val_if_fail( boxed->def, 0 );
+	g_return_val_if_fail( boxed->def->hash, 0 );
+
+	if( !boxed->hash_valid ){
+		cache = ( NABoxed * ) boxed;
+		cache->hash = boxed->is_set ? ( *boxed->def->hash )( boxed ) : 0;
+		cache->hash_valid = TRUE;
+	}
+
+	return( boxed->hash );
+}
+
 /**
  * na_boxed_set_type:
  * @boxed: this #NABoxed object.
  * @type: the required type as defined in na-data-types.h
  *
- * Set the type of the just-allocated @boxed object.
+ * Set the type of the just-allocated @boxed structure.
  *
  * Since: 3.1
  */
@@ -494,10 +422,9 @@ void
 na_boxed_set_type( NABoxed *boxed, guint type )
 {
 	g_return_if_fail( NA_IS_BOXED( boxed ));
-	g_return_if_fail( boxed->private->dispose_has_run == FALSE );
-	g_return_if_fail( boxed->private->def == NULL );
+	g_return_if_fail( boxed->def == NULL );
 
-	boxed->private->def = get_boxed_def( type );
+	boxed->def = get_boxed_def( type );
 }
 
 /**
@@ -515,19 +442,17 @@ na_boxed_are_equal( const NABoxed *a, const NABoxed *b )
 	gboolean are_equal;
 
 	g_return_val_if_fail( NA_IS_BOXED( a ), FALSE );
-	g_return_val_if_fail( a->private->dispose_has_run == FALSE, FALSE );
 	g_return_val_if_fail( NA_IS_BOXED( b ), FALSE );
-	g_return_val_if_fail( b->private->dispose_has_run == FALSE, FALSE );
-	g_return_val_if_fail( a->private->def, FALSE );
-	g_return_val_if_fail( a->private->def == b->private->def, FALSE );
-	g_return_val_if_fail( a->private->def->are_equal, FALSE );
+	g_return_val_if_fail( a->def, FALSE );
+	g_return_val_if_fail( a->def == b->def, FALSE );
+	g_return_val_if_fail( a->def->are_equal, FALSE );
 
 	are_equal = FALSE;
 
-	if( a->private->is_set == b->private->is_set ){
+	if( a->is_set == b->is_set ){
 		are_equal = TRUE;
-		if( a->private->is_set ){
-			are_equal = ( *a->private->def->are_equal )( a, b );
+		if( a->is_set ){
+			are_equal = ( *a->def->are_equal )( a, b );
 		}
 	}
 
@@ -539,7 +464,7 @@ na_boxed_are_equal( const NABoxed *a, const NABoxed *b )
  * @boxed: the source #NABoxed box.
  *
  * Returns: a copy of @boxed, as a newly allocated #NABoxed which should
- * be g_object_unref() by the caller.
+ * be na_boxed_free() by the caller.
  *
  * Since: 3.1
  */
@@ -549,14 +474,13 @@ na_boxed_copy( const NABoxed *boxed )
 	NABoxed *dest;
 
 	g_return_val_if_fail( NA_IS_BOXED( boxed ), NULL );
-	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, NULL );
-	g_return_val_if_fail( boxed->private->def, NULL );
-	g_return_val_if_fail( boxed->private->def->copy, NULL );
-
-	dest = boxed_new( boxed->private->def );
-	if( boxed->private->is_set ){
-		( *boxed->private->def->copy )( dest, boxed );
-		dest->private->is_set = TRUE;
+	g_return_val_if_fail( boxed->def, NULL );
+	g_return_val_if_fail( boxed->def->copy, NULL );
+
+	dest = boxed_new( boxed->def );
+	if( boxed->is_set ){
+		( *boxed->def->copy )( dest, boxed );
+		dest->is_set = TRUE;
 	}
 
 	return( dest );
@@ -577,17 +501,37 @@ na_boxed_dump( const NABoxed *boxed )
 	gchar *str;
 
 	g_return_if_fail( NA_IS_BOXED( boxed ));
-	g_return_if_fail( boxed->private->dispose_has_run == FALSE );
-	g_return_if_fail( boxed->private->def );
-	g_return_if_fail( boxed->private->def->to_string );
+	g_return_if_fail( boxed->def );
+	g_return_if_fail( boxed->def->to_string );
 
-	str = ( boxed->private->is_set ) ? ( *boxed->private->def->to_string )( boxed ) : NULL;
+	str = ( boxed->is_set ) ? ( *boxed->def->to_string )( boxed ) : NULL;
 	g_debug( "%s: boxed=%p, type=%u, is_set=%s, value=%s",
-			thisfn, ( void * ) boxed, boxed->private->def->type,
-			boxed->private->is_set ? "True":"False", str );
+			thisfn, ( void * ) boxed, boxed->def->type,
+			boxed->is_set ? "True":"False", str );
 	g_free( str );
 }
 
+/**
+ * na_boxed_free:
+ * @boxed: the #NABoxed box to be released.
+ *
+ * Releases the @boxed box and its content.
+ *
+ * This function is only suitable for a #NABoxed allocated with
+ * na_boxed_copy() or na_boxed_new_from_string(). A #NADataBoxed must
+ * be released with na_data_boxed_unref().
+ *
+ * Since: 3.3
+ */
+void
+na_boxed_free( NABoxed *boxed )
+{
+	if( boxed ){
+		na_boxed_clear( boxed );
+		g_slice_free( NABoxed, boxed );
+	}
+}
+
 /**
  * na_boxed_new_from_string:
  * @type: the type of the #NABoxed to be allocated.
@@ -598,7 +542,7 @@ na_boxed_dump( const NABoxed *boxed )
  *
  * If the type is a list, then the last separator is automatically stripped.
  *
- * Returns: a newly allocated #NABoxed, which should be g_object_unref()
+ * Returns: a newly allocated #NABoxed, which should be na_boxed_free()
  * by the caller, or %NULL if the type is unknowned, or does not provide
  * the 'from_string' function.
  *
@@ -617,7 +561,7 @@ na_boxed_new_from_string( guint type, const gchar *string )
 
 	boxed = boxed_new( def );
 	( *def->from_string )( boxed, string );
-	boxed->private->is_set = TRUE;
+	boxed->is_set = TRUE;
 
 	return( boxed );
 }
@@ -637,12 +581,11 @@ na_boxed_get_boolean( const NABoxed *boxed )
 	gboolean value;
 
 	g_return_val_if_fail( NA_IS_BOXED( boxed ), FALSE );
-	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, FALSE );
-	g_return_val_if_fail( boxed->private->def, FALSE );
-	g_return_val_if_fail( boxed->private->def->type == NA_DATA_TYPE_BOOLEAN, FALSE );
-	g_return_val_if_fail( boxed->private->def->to_bool, FALSE );
+	g_return_val_if_fail( boxed->def, FALSE );
+	g_return_val_if_fail( boxed->def->type == NA_DATA_TYPE_BOOLEAN, FALSE );
+	g_return_val_if_fail( boxed->def->to_bool, FALSE );
 
-	value = ( *boxed->private->def->to_bool )( boxed );
+	value = ( *boxed->def->to_bool )( boxed );
 
 	return( value );
 }
@@ -662,11 +605,10 @@ na_boxed_get_pointer( const NABoxed *boxed )
 	gconstpointer value;
 
 	g_return_val_if_fail( NA_IS_BOXED( boxed ), NULL );
-	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, NULL );
-	g_return_val_if_fail( boxed->private->def, NULL );
-	g_return_val_if_fail( boxed->private->def->to_pointer, NULL );
+	g_return_val_if_fail( boxed->def, NULL );
+	g_return_val_if_fail( boxed->def->to_pointer, NULL );
 
-	value = ( *boxed->private->def->to_pointer )( boxed );
+	value = ( *boxed->def->to_pointer )( boxed );
 
 	return( value );
 }
@@ -686,11 +628,10 @@ na_boxed_get_string( const NABoxed *boxed )
 	gchar *value;
 
 	g_return_val_if_fail( NA_IS_BOXED( boxed ), NULL );
-	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, NULL );
-	g_return_val_if_fail( boxed->private->def, NULL );
-	g_return_val_if_fail( boxed->private->def->to_string, NULL );
+	g_return_val_if_fail( boxed->def, NULL );
+	g_return_val_if_fail( boxed->def->to_string, NULL );
 
-	value = ( *boxed->private->def->to_string )( boxed );
+	value = ( *boxed->def->to_string )( boxed );
 
 	return( value );
 }
@@ -710,12 +651,11 @@ na_boxed_get_string_list( const NABoxed *boxed )
 	GSList *value;
 
 	g_return_val_if_fail( NA_IS_BOXED( boxed ), NULL );
-	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, NULL );
-	g_return_val_if_fail( boxed->private->def, NULL );
-	g_return_val_if_fail( boxed->private->def->type == NA_DATA_TYPE_STRING_LIST, NULL );
-	g_return_val_if_fail( boxed->private->def->to_string_list, NULL );
+	g_return_val_if_fail( boxed->def, NULL );
+	g_return_val_if_fail( boxed->def->type == NA_DATA_TYPE_STRING_LIST, NULL );
+	g_return_val_if_fail( boxed->def->to_string_list, NULL );
 
-	value = ( *boxed->private->def->to_string_list )( boxed );
+	value = ( *boxed->def->to_string_list )( boxed );
 
 	return( value );
 }
@@ -735,12 +675,11 @@ na_boxed_get_uint( const NABoxed *boxed )
 	guint value;
 
 	g_return_val_if_fail( NA_IS_BOXED( boxed ), 0 );
-	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, 0 );
-	g_return_val_if_fail( boxed->private->def, 0 );
-	g_return_val_if_fail( boxed->private->def->type == NA_DATA_TYPE_UINT, 0 );
-	g_return_val_if_fail( boxed->private->def->to_uint, 0 );
+	g_return_val_if_fail( boxed->def, 0 );
+	g_return_val_if_fail( boxed->def->type == NA_DATA_TYPE_UINT, 0 );
+	g_return_val_if_fail( boxed->def->to_uint, 0 );
 
-	value = ( *boxed->private->def->to_uint )( boxed );
+	value = ( *boxed->def->to_uint )( boxed );
 
 	return( value );
 }
@@ -760,12 +699,11 @@ na_boxed_get_uint_list( const NABoxed *boxed )
 	GList *value;
 
 	g_return_val_if_fail( NA_IS_BOXED( boxed ), NULL );
-	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, NULL );
-	g_return_val_if_fail( boxed->private->def, NULL );
-	g_return_val_if_fail( boxed->private->def->type == NA_DATA_TYPE_UINT_LIST, NULL );
-	g_return_val_if_fail( boxed->private->def->to_uint_list, NULL );
+	g_return_val_if_fail( boxed->def, NULL );
+	g_return_val_if_fail( boxed->def->type == NA_DATA_TYPE_UINT_LIST, NULL );
+	g_return_val_if_fail( boxed->def->to_uint_list, NULL );
 
-	value = ( *boxed->private->def->to_uint_list )( boxed );
+	value = ( *boxed->def->to_uint_list )( boxed );
 
 	return( value );
 }
@@ -783,11 +721,10 @@ void
 na_boxed_get_as_value( const NABoxed *boxed, GValue *value )
 {
 	g_return_if_fail( NA_IS_BOXED( boxed ));
-	g_return_if_fail( boxed->private->dispose_has_run == FALSE );
-	g_return_if_fail( boxed->private->def );
-	g_return_if_fail( boxed->private->def->to_value );
+	g_return_if_fail( boxed->def );
+	g_return_if_fail( boxed->def->to_value );
 
-	( *boxed->private->def->to_value )( boxed, value );
+	( *boxed->def->to_value )( boxed, value );
 }
 
 /**
@@ -807,11 +744,10 @@ void *
 na_boxed_get_as_void( const NABoxed *boxed )
 {
 	g_return_val_if_fail( NA_IS_BOXED( boxed ), NULL );
-	g_return_val_if_fail( boxed->private->dispose_has_run == FALSE, NULL );
-	g_return_val_if_fail( boxed->private->def, NULL );
-	g_return_val_if_fail( boxed->private->def->to_void, NULL );
+	g_return_val_if_fail( boxed->def, NULL );
+	g_return_val_if_fail( boxed->def->to_void, NULL );
 
-	return(( *boxed->private->def->to_void )( boxed ));
+	return(( *boxed->def->to_void )( boxed ));
 }
 
 /**
@@ -827,17 +763,16 @@ void
 na_boxed_set_from_boxed( NABoxed *boxed, const NABoxed *value )
 {
 	g_return_if_fail( NA_IS_BOXED( boxed ));
-	g_return_if_fail( boxed->private->dispose_has_run == FALSE );
 	g_return_if_fail( NA_IS_BOXED( value ));
-	g_return_if_fail( value->private->dispose_has_run == FALSE );
-	g_return_if_fail( boxed->private->def );
-	g_return_if_fail( boxed->private->def == value->private->def );
-	g_return_if_fail( boxed->private->def->copy );
-	g_return_if_fail( boxed->private->def->free );
+	g_return_if_fail( boxed->def );
+	g_return_if_fail( boxed->def == value->def );
+	g_return_if_fail( boxed->def->copy );
+	g_return_if_fail( boxed->def->free );
 
-	( *boxed->private->def->free )( boxed );
-	( *boxed->private->def->copy )( boxed, value );
-	boxed->private->is_set = TRUE;
+	( *boxed->def->free )( boxed );
+	( *boxed->def->copy )( boxed, value );
+	boxed->is_set = TRUE;
+	boxed->hash_valid = FALSE;
 }
 
 /**
@@ -853,14 +788,14 @@ void
 na_boxed_set_from_string( NABoxed *boxed, const gchar *value )
 {
 	g_return_if_fail( NA_IS_BOXED( boxed ));
-	g_return_if_fail( boxed->private->dispose_has_run == FALSE );
-	g_return_if_fail( boxed->private->def );
-	g_return_if_fail( boxed->private->def->free );
-	g_return_if_fail( boxed->private->def->from_string );
+	g_return_if_fail( boxed->def );
+	g_return_if_fail( boxed->def->free );
+	g_return_if_fail( boxed->def->from_string );
 
-	( *boxed->private->def->free )( boxed );
-	( *boxed->private->def->from_string )( boxed, value );
-	boxed->private->is_set = TRUE;
+	( *boxed->def->free )( boxed );
+	( *boxed->def->from_string )( boxed, value );
+	boxed->is_set = TRUE;
+	boxed->hash_valid = FALSE;
 }
 
 /**
@@ -876,14 +811,14 @@ void
 na_boxed_set_from_value( NABoxed *boxed, const GValue *value )
 {
 	g_return_if_fail( NA_IS_BOXED( boxed ));
-	g_return_if_fail( boxed->private->dispose_has_run == FALSE );
-	g_return_if_fail( boxed->private->def );
-	g_return_if_fail( boxed->private->def->free );
-	g_return_if_fail( boxed->private->def->from_value );
+	g_return_if_fail( boxed->def );
+	g_return_if_fail( boxed->def->free );
+	g_return_if_fail( boxed->def->from_value );
 
-	( *boxed->private->def->free )( boxed );
-	( *boxed->private->def->from_value )( boxed, value );
-	boxed->private->is_set = TRUE;
+	( *boxed->def->free )( boxed );
+	( *boxed->def->from_value )( boxed, value );
+	boxed->is_set = TRUE;
+	boxed->hash_valid = FALSE;
 }
 
 /**
@@ -899,87 +834,99 @@ void
 na_boxed_set_from_void( NABoxed *boxed, const void *value )
 {
 	g_return_if_fail( NA_IS_BOXED( boxed ));
-	g_return_if_fail( boxed->private->dispose_has_run == FALSE );
-	g_return_if_fail( boxed->private->def );
-	g_return_if_fail( boxed->private->def->free );
-	g_return_if_fail( boxed->private->def->from_void );
+	g_return_if_fail( boxed->def );
+	g_return_if_fail( boxed->def->free );
+	g_return_if_fail( boxed->def->from_void );
 
-	( *boxed->private->def->free )( boxed );
-	( *boxed->private->def->from_void )( boxed, value );
-	boxed->private->is_set = TRUE;
+	( *boxed->def->free )( boxed );
+	( *boxed->def->from_void )( boxed, value );
+	boxed->is_set = TRUE;
+	boxed->hash_valid = FALSE;
 }
 
 static gboolean
 bool_are_equal( const NABoxed *a, const NABoxed *b )
 {
-	return( a->private->u.boolean == b->private->u.boolean );
+	return( a->u.boolean == b->u.boolean );
+}
+
+static guint
+bool_hash( const NABoxed *boxed )
+{
+	return(( guint ) boxed->u.boolean );
 }
 
 static void
 bool_copy( NABoxed *dest, const NABoxed *src )
 {
-	dest->private->u.boolean = src->private->u.boolean;
+	dest->u.boolean = src->u.boolean;
 }
 
 static void
 bool_free( NABoxed *boxed )
 {
-	boxed->private->u.boolean = FALSE;
-	boxed->private->is_set = FALSE;
+	boxed->u.boolean = FALSE;
+	boxed->is_set = FALSE;
 }
 
 static void
 bool_from_string( NABoxed *boxed, const gchar *string )
 {
-	boxed->private->u.boolean = na_core_utils_boolean_from_string( string );
+	boxed->u.boolean = na_core_utils_boolean_from_string( string );
 }
 
 static void
 bool_from_value( NABoxed *boxed, const GValue *value )
 {
-	boxed->private->u.boolean = g_value_get_boolean( value );
+	boxed->u.boolean = g_value_get_boolean( value );
 }
 
 static void
 bool_from_void( NABoxed *boxed, const void *value )
 {
-	boxed->private->u.boolean = GPOINTER_TO_UINT( value );
+	boxed->u.boolean = GPOINTER_TO_UINT( value );
 }
 
 static gboolean
 bool_to_bool( const NABoxed *boxed )
 {
-	return( boxed->private->u.boolean );
+	return( boxed->u.boolean );
 }
 
 static gconstpointer
 bool_to_pointer( const NABoxed *boxed )
 {
-	return(( gconstpointer ) GUINT_TO_POINTER( boxed->private->u.boolean ));
+	return(( gconstpointer ) GUINT_TO_POINTER( boxed->u.boolean ));
 }
 
 static gchar *
 bool_to_string( const NABoxed *boxed )
 {
-	return( g_strdup_printf( "%s", boxed->private->u.boolean ? "true":"false" ));
+	return( g_strdup_printf( "%s", boxed->u.boolean ? "true":"false" ));
 }
 
 static void
 bool_to_value( const NABoxed *boxed, GValue *value )
 {
-	g_value_set_boolean( value, boxed->private->u.boolean );
+	g_value_set_boolean( value, boxed->u.boolean );
 }
 
 static void *
 bool_to_void( const NABoxed *boxed )
 {
-	return( GUINT_TO_POINTER( boxed->private->u.boolean ));
+	return( GUINT_TO_POINTER( boxed->u.boolean ));
 }
 
 static gboolean
 pointer_are_equal( const NABoxed *a, const NABoxed *b )
 {
-	return( a->private->u.pointer == b->private->u.pointer );
+	return( a->u.pointer == b->u.pointer );
+}
+
+static guint
+pointer_hash( const NABoxed *boxed )
+{
+	return( g_direct_hash( boxed->u.pointer ));
 }
 
 /*
@@ -988,14 +935,14 @@ pointer_are_equal( const NABoxed *a, const NABoxed *b )
 static void
 pointer_copy( NABoxed *dest, const NABoxed *src )
 {
-	dest->private->u.pointer = src->private->u.pointer;
+	dest->u.pointer = src->u.pointer;
 }
 
 static void
 pointer_free( NABoxed *boxed )
 {
-	boxed->private->u.pointer = NULL;
-	boxed->private->is_set = FALSE;
+	boxed->u.pointer = NULL;
+	boxed->is_set = FALSE;
 }
 
 static void
@@ -1007,97 +954,103 @@ pointer_from_string( NABoxed *boxed, const gchar *pointer )
 static void
 pointer_from_value( NABoxed *boxed, const GValue *value )
 {
-	boxed->private->u.pointer = g_value_get_pointer( value );
+	boxed->u.pointer = g_value_get_pointer( value );
 }
 
 static void
 pointer_from_void( NABoxed *boxed, const void *value )
 {
-	boxed->private->u.pointer = ( void * ) value;
+	boxed->u.pointer = ( void * ) value;
 }
 
 static gconstpointer
 pointer_to_pointer( const NABoxed *boxed )
 {
-	return( boxed->private->u.pointer );
+	return( boxed->u.pointer );
 }
 
 static gchar *
 pointer_to_string( const NABoxed *boxed )
 {
-	return( g_strdup_printf( "%p", boxed->private->u.pointer ));
+	return( g_strdup_printf( "%p", boxed->u.pointer ));
 }
 
 static void
 pointer_to_value( const NABoxed *boxed, GValue *value )
 {
-	g_value_set_pointer( value, boxed->private->u.pointer );
+	g_value_set_pointer( value, boxed->u.pointer );
 }
 
 static void *
 pointer_to_void( const NABoxed *boxed )
 {
-	return( boxed->private->u.pointer );
+	return( boxed->u.pointer );
 }
 
 static gboolean
 string_are_equal( const NABoxed *a, const NABoxed *b )
 {
-	if( a->private->u.string && b->private->u.string ){
-		return( strcmp( a->private->u.string, b->private->u.string ) == 0 );
+	if( a->u.string && b->u.string ){
+		return( strcmp( a->u.string, b->u.string ) == 0 );
 	}
-	if( !a->private->u.string && !b->private->u.string ){
+	if( !a->u.string && !b->u.string ){
 		return( TRUE );
 	}
 	return( FALSE );
 }
 
+static guint
+string_hash( const NABoxed *boxed )
+{
+	return( boxed->u.string ? g_str_hash( boxed->u.string ) : 0 );
+}
+
 static void
 string_copy( NABoxed *dest, const NABoxed *src )
 {
-	dest->private->u.string = g_strdup( src->private->u.string );
+	dest->u.string = g_strdup( src->u.string );
 }
 
 static void
 string_free( NABoxed *boxed )
 {
-	g_free( boxed->private->u.string );
-	boxed->private->u.string = NULL;
-	boxed->private->is_set = FALSE;
+	g_free( boxed->u.string );
+	boxed->u.string = NULL;
+	boxed->is_set = FALSE;
 }
 
 static void
 string_from_string( NABoxed *boxed, const gchar *string )
 {
-	boxed->private->u.string = g_strdup( string ? string : "" );
+	boxed->u.string = g_strdup( string ? string : "" );
 }
 
 static void
 string_from_value( NABoxed *boxed, const GValue *value )
 {
 	if( g_value_get_string( value )){
-		boxed->private->u.string = g_value_dup_string( value );
+		boxed->u.string = g_value_dup_string( value );
 	} else {
-		boxed->private->u.string = g_strdup( "" );
+		boxed->u.string = g_strdup( "" );
 	}
 }
 
 static void
 string_from_void( NABoxed *boxed, const void *value )
 {
-	boxed->private->u.string = g_strdup( value ? ( const gchar * ) value : "" );
+	boxed->u.string = g_strdup( value ? ( const gchar * ) value : "" );
 }
 
 static gconstpointer
 string_to_pointer( const NABoxed *boxed )
 {
-	return(( gconstpointer ) boxed->private->u.string );
+	return(( gconstpointer ) boxed->u.string );
 }
 
 static gchar *
 string_to_string( const NABoxed *boxed )
 {
-	return( g_strdup( boxed->private->u.string ));
+	return( g_strdup( boxed->u.string ));
 }
 
 static void
@@ -1125,12 +1078,12 @@ string_list_are_equal( const NABoxed *a, const NABoxed *b )
 	GSList *ia, *ib;
 	gboolean diff = FALSE;
 
-	guint na = g_slist_length( a->private->u.string_list );
-	guint nb = g_slist_length( b->private->u.string_list );
+	guint na = g_slist_length( a->u.string_list );
+	guint nb = g_slist_length( b->u.string_list );
 
 	if( na != nb ) return( FALSE );
 
-	for( ia=a->private->u.string_list, ib=b->private->u.string_list ; ia && ib && !diff ; ia=ia->next, ib=ib->next ){
+	for( ia=a->u.string_list, ib=b->u.string_list ; ia && ib && !diff ; ia=ia->next, ib=ib->next ){
 		if( strcmp( ia->data, ib->data ) != 0 ){
 			diff = TRUE;
 		}
@@ -1139,22 +1092,35 @@ string_list_are_equal( const NABoxed *a, const NABoxed *b )
 	return( !diff );
 }
 
+static guint
+string_list_hash( const NABoxed *boxed )
+{
+	GSList *it;
+	guint hash = 0;
+
+	for( it = boxed->u.string_list ; it ; it = it->next ){
+		hash = hash * 31 + g_str_hash( it->data );
+	}
+
+	return( hash );
+}
+
 static void
 string_list_copy( NABoxed *dest, const NABoxed *src )
 {
-	if( dest->private->is_set ){
+	if( dest->is_set ){
 		string_list_free( dest );
 	}
-	dest->private->u.string_list = na_core_utils_slist_duplicate( src->private->u.string_list );
-	dest->private->is_set = TRUE;
+	dest->u.string_list = na_core_utils_slist_duplicate( src->u.string_list );
+	dest->is_set = TRUE;
 }
 
 static void
 string_list_free( NABoxed *boxed )
 {
-	na_core_utils_slist_free( boxed->private->u.string_list );
-	boxed->private->u.string_list = NULL;
-	boxed->private->is_set = FALSE;
+	na_core_utils_slist_free( boxed->u.string_list );
+	boxed->u.string_list = NULL;
+	boxed->is_set = FALSE;
 }
 
 /*
@@ -1173,12 +1139,12 @@ string_list_from_string( NABoxed *boxed, const gchar *string )
 	if( array ){
 		i = ( gchar ** ) array;
 		while( *i ){
-			if( !na_core_utils_slist_count( boxed->private->u.string_list, ( const gchar * )( *i ))){
-				boxed->private->u.string_list = g_slist_prepend( boxed->private->u.string_list, g_strdup( *i ));
+			if( !na_core_utils_slist_count( boxed->u.string_list, ( const gchar * )( *i ))){
+				boxed->u.string_list = g_slist_prepend( boxed->u.string_list, g_strdup( *i ));
 			}
 			i++;
 		}
-		boxed->private->u.string_list = g_slist_reverse( boxed->private->u.string_list );
+		boxed->u.string_list = g_slist_reverse( boxed->u.string_list );
 	}
 
 	g_strfreev( array );
@@ -1198,17 +1164,17 @@ string_list_from_void( NABoxed *boxed, const void *value )
 
 	value_slist = ( GSList * ) value;
 	for( it = value_slist ; it ; it = it->next ){
-		if( !na_core_utils_slist_count( boxed->private->u.string_list, ( const gchar * ) it->data )){
-			boxed->private->u.string_list = g_slist_prepend( boxed->private->u.string_list, g_strdup(( const gchar * ) it->data ));
+		if( !na_core_utils_slist_count( boxed->u.string_list, ( const gchar * ) it->data )){
+			boxed->u.string_list = g_slist_prepend( boxed->u.string_list, g_strdup(( const gchar * ) it->data ));
 		}
 	}
-	boxed->private->u.string_list = g_slist_reverse( boxed->private->u.string_list );
+	boxed->u.string_list = g_slist_reverse( boxed->u.string_list );
 }
 
 static gconstpointer
 string_list_to_pointer( const NABoxed *boxed )
 {
-	return(( gconstpointer ) boxed->private->u.string_list );
+	return(( gconstpointer ) boxed->u.string_list );
 }
 
 static gchar *
@@ -1219,7 +1185,7 @@ string_list_to_string( const NABoxed *boxed )
 	gboolean first;
 
 	first = TRUE;
-	for( is = boxed->private->u.string_list ; is ; is = is->next ){
+	for( is = boxed->u.string_list ; is ; is = is->next ){
 		if( !first ){
 			str = g_string_append( str, LIST_SEPARATOR );
 		}
@@ -1233,13 +1199,13 @@ string_list_to_string( const NABoxed *boxed )
 static GSList *
 string_list_to_string_list( const NABoxed *boxed )
 {
-	return( na_core_utils_slist_duplicate( boxed->private->u.string_list ));
+	return( na_core_utils_slist_duplicate( boxed->u.string_list ));
 }
 
 static void
 string_list_to_value( const NABoxed *boxed, GValue *value )
 {
-	g_value_set_pointer( value, na_core_utils_slist_duplicate( boxed->private->u.string_list ));
+	g_value_set_pointer( value, na_core_utils_slist_duplicate( boxed->u.string_list ));
 }
 
 static void *
@@ -1247,8 +1213,8 @@ string_list_to_void( const NABoxed *boxed )
 {
 	void *value = NULL;
 
-	if( boxed->private->u.string_list ){
-		value = na_core_utils_slist_duplicate( boxed->private->u.string_list );
+	if( boxed->u.string_list ){
+		value = na_core_utils_slist_duplicate( boxed->u.string_list );
 	}
 
 	return( value );
@@ -1257,81 +1223,106 @@ string_list_to_void( const NABoxed *boxed )
 static gboolean
 locale_are_equal( const NABoxed *a, const NABoxed *b )
 {
-	if( !a->private->u.string && !b->private->u.string ){
+	if( !a->u.string && !b->u.string ){
 		return( TRUE );
 	}
-	if( !a->private->u.string || !b->private->u.string ){
+	if( !a->u.string || !b->u.string ){
 		return( FALSE );
 	}
-	return( na_core_utils_str_collate( a->private->u.string, b->private->u.string ) == 0 );
+	return( na_core_utils_str_collate( a->u.string, b->u.string ) == 0 );
+}
+
+/*
+ * two locale strings are equal if they collate the same,
+ * so hash the collation key rather than the string itself
+ */
+static guint
+locale_hash( const NABoxed *boxed )
+{
+	gchar *key;
+	guint hash = 0;
+
+	if( boxed->u.string ){
+		key = g_utf8_collate_key( boxed->u.string, -1 );
+		hash = g_str_hash( key );
+		g_free( key );
+	}
+
+	return( hash );
 }
 
 static gboolean
 uint_are_equal( const NABoxed *a, const NABoxed *b )
 {
-	return( a->private->u.uint == b->private->u.uint );
+	return( a->u.uint == b->u.uint );
+}
+
+static guint
+uint_hash( const NABoxed *boxed )
+{
+	return( boxed->u.uint );
 }
 
 static void
 uint_copy( NABoxed *dest, const NABoxed *src )
 {
-	dest->private->u.uint = src->private->u.uint;
-	dest->private->is_set = TRUE;
+	dest->u.uint = src->u.uint;
+	dest->is_set = TRUE;
 }
 
 static void
 uint_free( NABoxed *boxed )
 {
-	boxed->private->u.uint = 0;
-	boxed->private->is_set = FALSE;
+	boxed->u.uint = 0;
+	boxed->is_set = FALSE;
 }
 
 static void
 uint_from_string( NABoxed *boxed, const gchar *string )
 {
-	boxed->private->u.uint = string ? atoi( string ) : 0;
+	boxed->u.uint = string ? atoi( string ) : 0;
 }
 
 static void
 uint_from_value( NABoxed *boxed, const GValue *value )
 {
-	boxed->private->u.uint = g_value_get_uint( value );
+	boxed->u.uint = g_value_get_uint( value );
 }
 
 static void
 uint_from_void( NABoxed *boxed, const void *value )
 {
-	boxed->private->u.uint = GPOINTER_TO_UINT( value );
+	boxed->u.uint = GPOINTER_TO_UINT( value );
 }
 
 static gconstpointer
 uint_to_pointer( const NABoxed *boxed )
 {
-	return(( gconstpointer ) GUINT_TO_POINTER( boxed->private->u.uint ));
+	return(( gconstpointer ) GUINT_TO_POINTER( boxed->u.uint ));
 }
 
 static gchar *
 uint_to_string( const NABoxed *boxed )
 {
-	return( g_strdup_printf( "%u", boxed->private->u.uint ));
+	return( g_strdup_printf( "%u", boxed->u.uint ));
 }
 
 static guint
 uint_to_uint( const NABoxed *boxed )
 {
-	return( boxed->private->u.uint );
+	return( boxed->u.uint );
 }
 
 static void
 uint_to_value( const NABoxed *boxed, GValue *value )
 {
-	g_value_set_uint( value, boxed->private->u.uint );
+	g_value_set_uint( value, boxed->u.uint );
 }
 
 static void *
 uint_to_void( const NABoxed *boxed )
 {
-	return( GUINT_TO_POINTER( boxed->private->u.uint ));
+	return( GUINT_TO_POINTER( boxed->u.uint ));
 }
 
 /* compare uint list as string list:
@@ -1345,12 +1336,12 @@ uint_list_are_equal( const NABoxed *a, const NABoxed *b )
 	GList *ia, *ib;
 	gboolean diff = FALSE;
 
-	guint na = g_list_length( a->private->u.uint_list );
-	guint nb = g_list_length( b->private->u.uint_list );
+	guint na = g_list_length( a->u.uint_list );
+	guint nb = g_list_length( b->u.uint_list );
 
 	if( na != nb ) return( FALSE );
 
-	for( ia=a->private->u.uint_list, ib=b->private->u.uint_list ; ia && ib && !diff ; ia=ia->next, ib=ib->next ){
+	for( ia=a->u.uint_list, ib=b->u.uint_list ; ia && ib && !diff ; ia=ia->next, ib=ib->next ){
 		if( GPOINTER_TO_UINT( ia->data ) != GPOINTER_TO_UINT( ib->data )){
 			diff = TRUE;
 		}
@@ -1359,24 +1350,37 @@ uint_list_are_equal( const NABoxed *a, const NABoxed *b )
 	return( !diff );
 }
 
+static guint
+uint_list_hash( const NABoxed *boxed )
+{
+	GList *it;
+	guint hash = 0;
+
+	for( it = boxed->u.uint_list ; it ; it = it->next ){
+		hash = hash * 31 + GPOINTER_TO_UINT( it->data );
+	}
+
+	return( hash );
+}
+
 static void
 uint_list_copy( NABoxed *dest, const NABoxed *src )
 {
 	GList *isrc;
 
-	dest->private->u.uint_list = NULL;
-	for( isrc = src->private->u.uint_list ; isrc ; isrc = isrc->next ){
-		dest->private->u.uint_list = g_list_prepend( dest->private->u.uint_list, isrc->data );
+	dest->u.uint_list = NULL;
+	for( isrc = src->u.uint_list ; isrc ; isrc = isrc->next ){
+		dest->u.uint_list = g_list_prepend( dest->u.uint_list, isrc->data );
 	}
-	dest->private->u.uint_list = g_list_reverse( dest->private->u.uint_list );
+	dest->u.uint_list = g_list_reverse( dest->u.uint_list );
 }
 
 static void
 uint_list_free( NABoxed *boxed )
 {
-	g_list_free( boxed->private->u.uint_list );
-	boxed->private->u.uint_list = NULL;
-	boxed->private->is_set = FALSE;
+	g_list_free( boxed->u.uint_list );
+	boxed->u.uint_list = NULL;
+	boxed->is_set = FALSE;
 }
 
 static void
@@ -1390,12 +1394,12 @@ uint_list_from_string( NABoxed *boxed, const gchar *string )
 	if( array ){
 		i = ( gchar ** ) array;
 		while( *i ){
-			boxed->private->u.uint_list = g_list_prepend( boxed->private->u.uint_list, GINT_TO_POINTER( atoi( *i )));
+			boxed->u.uint_list = g_list_prepend( boxed->u.uint_list, GINT_TO_POINTER( atoi( *i )));
 			i++;
 		}
-		boxed->private->u.uint_list = g_list_reverse( boxed->private->u.uint_list );
+		boxed->u.uint_list = g_list_reverse( boxed->u.uint_list );
 	} else {
-		boxed->private->u.uint_list = NULL;
+		boxed->u.uint_list = NULL;
 	}
 
 	g_strfreev( array );
@@ -1405,7 +1409,7 @@ static void
 uint_list_from_value( NABoxed *boxed, const GValue *value )
 {
 	if( g_value_get_pointer( value )){
-		boxed->private->u.uint_list = g_list_copy( g_value_get_pointer( value ));
+		boxed->u.uint_list = g_list_copy( g_value_get_pointer( value ));
 	}
 }
 
@@ -1413,14 +1417,14 @@ static void
 uint_list_from_void( NABoxed *boxed, const void *value )
 {
 	if( value ){
-		boxed->private->u.uint_list = g_list_copy(( GList * ) value );
+		boxed->u.uint_list = g_list_copy(( GList * ) value );
 	}
 }
 
 static gconstpointer
 uint_list_to_pointer( const NABoxed *boxed )
 {
-	return(( gconstpointer ) boxed->private->u.uint_list );
+	return(( gconstpointer ) boxed->u.uint_list );
 }
 
 static gchar *
@@ -1431,7 +1435,7 @@ uint_list_to_string( const NABoxed *boxed )
 	gboolean first;
 
 	first = TRUE;
-	for( is = boxed->private->u.uint_list ; is ; is = is->next ){
+	for( is = boxed->u.uint_list ; is ; is = is->next ){
 		if( !first ){
 			str = g_string_append( str, LIST_SEPARATOR );
 		}
@@ -1445,13 +1449,13 @@ uint_list_to_string( const NABoxed *boxed )
 static GList *
 uint_list_to_uint_list( const NABoxed *boxed )
 {
-	return( g_list_copy( boxed->private->u.uint_list ));
+	return( g_list_copy( boxed->u.uint_list ));
 }
 
 static void
 uint_list_to_value( const NABoxed *boxed, GValue *value )
 {
-	g_value_set_pointer( value, g_list_copy( boxed->private->u.uint_list ));
+	g_value_set_pointer( value, g_list_copy( boxed->u.uint_list ));
 }
 
 static void *
@@ -1459,8 +1463,8 @@ uint_list_to_void( const NABoxed *boxed )
 {
 	void *value = NULL;
 
-	if( boxed->private->u.uint_list ){
-		value = g_list_copy( boxed->private->u.uint_list );
+	if( boxed->u.uint_list ){
+		value = g_list_copy( boxed->u.uint_list );
 	}
 
 	return( value );
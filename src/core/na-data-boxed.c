@@ -41,11 +41,7 @@
 #include <api/na-data-types.h>
 #include <api/na-data-boxed.h>
 
-/* private class data
- */
-struct _NADataBoxedClassPrivate {
-	void *empty;						/* so that gcc -pedantic is happy */
-};
+#include "na-boxed-priv.h"
 
 /* additional features of our data types
  * (see NABoxed class for primary features)
@@ -58,22 +54,17 @@ typedef struct {
 }
 	DataBoxedDef;
 
-/* private instance data
+/* the structure itself
+ * the NABoxed must be the first member, so that a NADataBoxed may be
+ * used everywhere a NABoxed is expected
  */
-struct _NADataBoxedPrivate {
-	gboolean            dispose_has_run;
+struct _NADataBoxed {
+	NABoxed             parent;
+	volatile gint       ref_count;
 	const NADataDef    *data_def ;
 	const DataBoxedDef *boxed_def;
 };
 
-static GObjectClass *st_parent_class   = NULL;
-
-static GType               register_type( void );
-static void                class_init( NADataBoxedClass *klass );
-static void                instance_init( GTypeInstance *instance, gpointer klass );
-static void                instance_dispose( GObject *object );
-static void                instance_finalize( GObject *object );
-
 static const DataBoxedDef *get_data_boxed_def( guint type );
 
 static GParamSpec         *bool_spec( const NADataDef *idtype );
@@ -148,107 +139,13 @@ na_data_boxed_get_type( void )
 	static GType item_type = 0;
 
 	if( item_type == 0 ){
-		item_type = register_type();
+		item_type = g_boxed_type_register_static( "NADataBoxed",
+				( GBoxedCopyFunc ) na_data_boxed_ref, ( GBoxedFreeFunc ) na_data_boxed_unref );
 	}
 
 	return( item_type );
 }
 
-static GType
-register_type( void )
-{
-	static const gchar *thisfn = "na_data_boxed_register_type";
-	GType type;
-
-	static GTypeInfo info = {
-		sizeof( NADataBoxedClass ),
-		NULL,
-		NULL,
-		( GClassInitFunc ) class_init,
-		NULL,
-		NULL,
-		sizeof( NADataBoxed ),
-		0,
-		( GInstanceInitFunc ) instance_init
-	};
-
-	g_debug( "%s", thisfn );
-
-	type = g_type_register_static( NA_TYPE_BOXED, "NADataBoxed", &info, 0 );
-
-	return( type );
-}
-
-static void
-class_init( NADataBoxedClass *klass )
-{
-	static const gchar *thisfn = "na_data_boxed_class_init";
-	GObjectClass *object_class;
-
-	g_debug( "%s: klass=%p", thisfn, ( void * ) klass );
-
-	st_parent_class = g_type_class_peek_parent( klass );
-
-	object_class = G_OBJECT_CLASS( klass );
-	object_class->dispose = instance_dispose;
-	object_class->finalize = instance_finalize;
-
-	klass->private = g_new0( NADataBoxedClassPrivate, 1 );
-}
-
-static void
-instance_init( GTypeInstance *instance, gpointer klass )
-{
-	NADataBoxed *self;
-
-	g_return_if_fail( NA_IS_DATA_BOXED( instance ));
-
-	self = NA_DATA_BOXED( instance );
-
-	self->private = g_new0( NADataBoxedPrivate, 1 );
-
-	self->private->dispose_has_run = FALSE;
-	self->private->data_def = NULL;
-	self->private->boxed_def = NULL;
-}
-
-static void
-instance_dispose( GObject *object )
-{
-	NADataBoxed *self;
-
-	g_return_if_fail( NA_IS_DATA_BOXED( object ));
-
-	self = NA_DATA_BOXED( object );
-
-	if( !self->private->dispose_has_run ){
-
-		self->private->dispose_has_run = TRUE;
-
-		/* chain up to the parent class */
-		if( G_OBJECT_CLASS( st_parent_class )->dispose ){
-			G_OBJECT_CLASS( st_parent_class )->dispose( object );
-		}
-	}
-}
-
-static void
-instance_finalize( GObject *object )
-{
-	NADataBoxed *self;
-
-	g_return_if_fail( NA_IS_DATA_BOXED( object ));
-
-	self = NA_DATA_BOXED( object );
-
-	g_free( self->private );
-
-	/* chain call to parent class */
-	if( G_OBJECT_CLASS( st_parent_class )->finalize ){
-		G_OBJECT_CLASS( st_parent_class )->finalize( object );
-	}
-}
-
 static const DataBoxedDef *
 get_data_boxed_def( guint type )
 {
@@ -269,7 +166,8 @@ get_data_boxed_def( guint type )
  * na_data_boxed_new:
  * @def: the #NADataDef definition structure for this boxed.
  *
- * Returns: a newly allocated #NADataBoxed.
+ * Returns: a newly allocated #NADataBoxed, which should be
+ * na_data_boxed_unref() by the caller.
  *
  * Since: 2.30
  */
@@ -280,14 +178,73 @@ na_data_boxed_new( const NADataDef *def )
 
 	g_return_val_if_fail( def != NULL, NULL );
 
-	boxed = g_object_new( NA_TYPE_DATA_BOXED, NULL );
+	boxed = g_slice_new0( NADataBoxed );
+	boxed->ref_count = 1;
 	na_boxed_set_type( NA_BOXED( boxed ), def->type );
-	boxed->private->data_def = def;
-	boxed->private->boxed_def = get_data_boxed_def( def->type );
+	boxed->data_def = def;
+	boxed->boxed_def = get_data_boxed_def( def->type );
+
+	return( boxed );
+}
+
+/**
+ * na_data_boxed_ref:
+ * @boxed: this #NADataBoxed structure.
+ *
+ * Adds a reference to @boxed.
+ *
+ * A #NADataBoxed which is referenced more than once is shared between
+ * several #NAIFactoryObject instances, and so must be considered as
+ * read-only: a new #NADataBoxed is allocated when one of the objects
+ * sets the data.
+ *
+ * Returns: @boxed.
+ *
+ * Since: 3.3
+ */
+NADataBoxed *
+na_data_boxed_ref( NADataBoxed *boxed )
+{
+	g_return_val_if_fail( NA_IS_DATA_BOXED( boxed ), NULL );
+
+	g_atomic_int_inc( &boxed->ref_count );
 
 	return( boxed );
 }
 
+/**
+ * na_data_boxed_unref:
+ * @boxed: this #NADataBoxed structure.
+ *
+ * Removes a reference from @boxed, releasing it and its content when
+ * the last reference is removed.
+ *
+ * Since: 3.3
+ */
+void
+na_data_boxed_unref( NADataBoxed *boxed )
+{
+	if( boxed && g_atomic_int_dec_and_test( &boxed->ref_count )){
+		na_boxed_clear( NA_BOXED( boxed ));
+		g_slice_free( NADataBoxed, boxed );
+	}
+}
+
+/*
+ * na_data_boxed_is_shared:
+ * @boxed: this #NADataBoxed structure.
+ *
+ * Returns: %TRUE if @boxed is referenced more than once, and so must not
+ * be modified, %FALSE else.
+ */
+gboolean
+na_data_boxed_is_shared( const NADataBoxed *boxed )
+{
+	g_return_val_if_fail( NA_IS_DATA_BOXED( boxed ), FALSE );
+
+	return( boxed->ref_count > 1 );
+}
+
 /**
  * na_data_boxed_get_data_def:
  * @boxed: this #NADataBoxed object.
@@ -300,18 +257,9 @@ na_data_boxed_new( const NADataDef *def )
 const NADataDef *
 na_data_boxed_get_data_def( const NADataBoxed *boxed )
 {
-	const NADataDef *def;
-
 	g_return_val_if_fail( NA_IS_DATA_BOXED( boxed ), NULL );
 
-	def = NULL;
-
-	if( !boxed->private->dispose_has_run ){
-
-		def = boxed->private->data_def;
-	}
-
-	return( def );
+	return( boxed->data_def );
 }
 
 /**
@@ -329,14 +277,11 @@ void
 na_data_boxed_set_data_def( NADataBoxed *boxed, const NADataDef *new_def )
 {
 	g_return_if_fail( NA_IS_DATA_BOXED( boxed ));
-	g_return_if_fail( boxed->private->data_def );
+	g_return_if_fail( boxed->data_def );
 	g_return_if_fail( new_def );
-	g_return_if_fail( new_def->type == boxed->private->data_def->type );
+	g_return_if_fail( new_def->type == boxed->data_def->type );
 
-	if( !boxed->private->dispose_has_run ){
-
-		boxed->private->data_def = ( NADataDef * ) new_def;
-	}
+	boxed->data_def = ( NADataDef * ) new_def;
 }
 
 /**
@@ -400,20 +345,11 @@ na_data_boxed_are_equal( const NADataBoxed *a, const NADataBoxed *b )
 gboolean
 na_data_boxed_is_default( const NADataBoxed *boxed )
 {
-	gboolean is_default;
-
 	g_return_val_if_fail( NA_IS_DATA_BOXED( boxed ), FALSE );
-	g_return_val_if_fail( boxed->private->boxed_def, FALSE );
-	g_return_val_if_fail( boxed->private->boxed_def->is_default, FALSE );
+	g_return_val_if_fail( boxed->boxed_def, FALSE );
+	g_return_val_if_fail( boxed->boxed_def->is_default, FALSE );
 
-	is_default = FALSE;
-
-	if( !boxed->private->dispose_has_run ){
-
-		is_default = ( *boxed->private->boxed_def->is_default )( boxed );
-	}
-
-	return( is_default );
+	return(( *boxed->boxed_def->is_default )( boxed ));
 }
 
 /**
@@ -427,20 +363,11 @@ na_data_boxed_is_default( const NADataBoxed *boxed )
 gboolean
 na_data_boxed_is_valid( const NADataBoxed *boxed )
 {
-	gboolean is_valid;
-
 	g_return_val_if_fail( NA_IS_DATA_BOXED( boxed ), FALSE );
-	g_return_val_if_fail( boxed->private->boxed_def, FALSE );
-	g_return_val_if_fail( boxed->private->boxed_def->is_valid, FALSE );
+	g_return_val_if_fail( boxed->boxed_def, FALSE );
+	g_return_val_if_fail( boxed->boxed_def->is_valid, FALSE );
 
-	is_valid = FALSE;
-
-	if( !boxed->private->dispose_has_run ){
-
-		is_valid = ( *boxed->private->boxed_def->is_valid )( boxed );
-	}
-
-	return( is_valid );
+	return(( *boxed->boxed_def->is_valid )( boxed ));
 }
 
 #ifdef NA_ENABLE_DEPRECATED
@@ -592,8 +519,8 @@ bool_is_default( const NADataBoxed *boxed )
 	gboolean is_default = FALSE;
 	gboolean default_value;
 
-	if( boxed->private->data_def->default_value && strlen( boxed->private->data_def->default_value )){
-		default_value = na_core_utils_boolean_from_string( boxed->private->data_def->default_value );
+	if( boxed->data_def->default_value && strlen( boxed->data_def->default_value )){
+		default_value = na_core_utils_boolean_from_string( boxed->data_def->default_value );
 		is_default = ( default_value == na_boxed_get_boolean( NA_BOXED( boxed )));
 	}
 
@@ -633,10 +560,10 @@ pointer_is_valid( const NADataBoxed *boxed )
 	gboolean is_valid = TRUE;
 	gconstpointer pointer;
 
-	if( boxed->private->data_def->mandatory ){
+	if( boxed->data_def->mandatory ){
 		pointer = na_boxed_get_pointer( NA_BOXED( boxed ));
 		if( !pointer ){
-			g_debug( "na_data_boxed_pointer_is_valid: invalid %s: mandatory but null", boxed->private->data_def->name );
+			g_debug( "na_data_boxed_pointer_is_valid: invalid %s: mandatory but null", boxed->data_def->name );
 			is_valid = FALSE;
 		}
 	}
@@ -661,10 +588,10 @@ string_is_default( const NADataBoxed *boxed )
 	gboolean is_default = FALSE;
 	gchar *value = na_boxed_get_string( NA_BOXED( boxed ));
 
-	if( boxed->private->data_def->default_value && strlen( boxed->private->data_def->default_value )){
+	if( boxed->data_def->default_value && strlen( boxed->data_def->default_value )){
 		if( value && strlen( value )){
 			/* default value is not null and string has something */
-			is_default = ( strcmp( value, boxed->private->data_def->default_value ) == 0 );
+			is_default = ( strcmp( value, boxed->data_def->default_value ) == 0 );
 
 		} else {
 			/* default value is not null, but string is null */
@@ -689,10 +616,10 @@ string_is_valid( const NADataBoxed *boxed )
 {
 	gboolean is_valid = TRUE;
 
-	if( boxed->private->data_def->mandatory ){
+	if( boxed->data_def->mandatory ){
 		gchar *value = na_boxed_get_string( NA_BOXED( boxed ));
 		if( !value || !strlen( value )){
-			g_debug( "na_data_boxed_string_is_valid: invalid %s: mandatory but empty or null", boxed->private->data_def->name );
+			g_debug( "na_data_boxed_string_is_valid: invalid %s: mandatory but empty or null", boxed->data_def->name );
 			is_valid = FALSE;
 		}
 		g_free( value );
@@ -717,9 +644,9 @@ string_list_is_default( const NADataBoxed *boxed )
 	gboolean is_default = FALSE;
 	gchar *value = na_boxed_get_string( NA_BOXED( boxed ));
 
-	if( boxed->private->data_def->default_value && strlen( boxed->private->data_def->default_value )){
+	if( boxed->data_def->default_value && strlen( boxed->data_def->default_value )){
 		if( value && strlen( value )){
-			is_default = ( strcmp( value, boxed->private->data_def->default_value ) == 0 );
+			is_default = ( strcmp( value, boxed->data_def->default_value ) == 0 );
 		} else {
 			is_default = FALSE;
 		}
@@ -738,10 +665,10 @@ string_list_is_valid( const NADataBoxed *boxed )
 {
 	gboolean is_valid = TRUE;
 
-	if( boxed->private->data_def->mandatory ){
+	if( boxed->data_def->mandatory ){
 		gchar *value = na_boxed_get_string( NA_BOXED( boxed ));
 		if( !value || !strlen( value )){
-			g_debug( "na_data_boxed_string_list_is_valid: invalid %s: mandatory but empty or null", boxed->private->data_def->name );
+			g_debug( "na_data_boxed_string_list_is_valid: invalid %s: mandatory but empty or null", boxed->data_def->name );
 			is_valid = FALSE;
 		}
 	}
@@ -755,10 +682,10 @@ locale_is_default( const NADataBoxed *boxed )
 	gboolean is_default = FALSE;
 	gchar *value = na_boxed_get_string( NA_BOXED( boxed ));
 
-	if( boxed->private->data_def->default_value && g_utf8_strlen( boxed->private->data_def->default_value, -1 )){
+	if( boxed->data_def->default_value && g_utf8_strlen( boxed->data_def->default_value, -1 )){
 		if( value && strlen( value )){
 			/* default value is not null and string has something */
-			is_default = ( na_core_utils_str_collate( value, boxed->private->data_def->default_value ) == 0 );
+			is_default = ( na_core_utils_str_collate( value, boxed->data_def->default_value ) == 0 );
 
 		} else {
 			/* default value is not null, but string is null */
@@ -782,10 +709,10 @@ locale_is_valid( const NADataBoxed *boxed )
 {
 	gboolean is_valid = TRUE;
 
-	if( boxed->private->data_def->mandatory ){
+	if( boxed->data_def->mandatory ){
 		gchar *value = na_boxed_get_string( NA_BOXED( boxed ));
 		if( !value || !g_utf8_strlen( value, -1 )){
-			g_debug( "na_data_boxed_locale_is_valid: invalid %s: mandatory but empty or null", boxed->private->data_def->name );
+			g_debug( "na_data_boxed_locale_is_valid: invalid %s: mandatory but empty or null", boxed->data_def->name );
 			is_valid = FALSE;
 		}
 		g_free( value );
@@ -813,8 +740,8 @@ uint_is_default( const NADataBoxed *boxed )
 	gboolean is_default = FALSE;
 	guint default_value;
 
-	if( boxed->private->data_def->default_value ){
-		default_value = atoi( boxed->private->data_def->default_value );
+	if( boxed->data_def->default_value ){
+		default_value = atoi( boxed->data_def->default_value );
 		is_default = ( na_boxed_get_uint( NA_BOXED( boxed )) == default_value );
 	}
 
@@ -851,10 +778,10 @@ uint_list_is_valid( const NADataBoxed *boxed )
 {
 	gboolean is_valid = TRUE;
 
-	if( boxed->private->data_def->mandatory ){
+	if( boxed->data_def->mandatory ){
 		gchar *value = na_boxed_get_string( NA_BOXED( boxed ));
 		if( !value || !strlen( value )){
-			g_debug( "na_data_boxed_uint_list_is_valid: invalid %s: mandatory but empty or null", boxed->private->data_def->name );
+			g_debug( "na_data_boxed_uint_list_is_valid: invalid %s: mandatory but empty or null", boxed->data_def->name );
 			is_valid = FALSE;
 		}
 		g_free( value );
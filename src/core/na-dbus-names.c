@@ -0,0 +1,314 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2014 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "na-dbus-names.h"
+
+#ifdef HAVE_GDBUS
+
+#include <gio/gio.h>
+#include <string.h>
+
+#define DBUS_SERVICE					"org.freedesktop.DBus"
+#define DBUS_PATH						"/org/freedesktop/DBus"
+#define DBUS_INTERFACE					"org.freedesktop.DBus"
+
+/* st_names: the set of the names currently owned on the session bus
+ * st_seeded: whether the set has been seeded by ListNames
+ *
+ * the set is updated from the main thread, where the signals are
+ * dispatched, and may be read from any thread: st_mutex protects st_names
+ * and st_seeded
+ */
+#if GLIB_CHECK_VERSION( 2, 32, 0 )
+static GMutex           st_mutex_struct;
+#endif
+
+static GMutex          *st_mutex        = NULL;
+static GHashTable      *st_names        = NULL;
+static gboolean         st_seeded       = FALSE;
+static gboolean         st_started      = FALSE;
+static GDBusConnection *st_connection   = NULL;
+
+static void     names_init( void );
+static void     names_start( void );
+static void     on_bus_got( GObject *source, GAsyncResult *res, void *empty );
+static void     on_list_names( GObject *source, GAsyncResult *res, void *empty );
+static void     on_name_owner_changed( GDBusConnection *connection, const gchar *sender, const gchar *path, const gchar *iface, const gchar *signal, GVariant *parameters, void *empty );
+static void     on_connection_closed( GDBusConnection *connection, gboolean remote_peer_vanished, GError *error, void *empty );
+
+/*
+ * na_dbus_names_is_registered:
+ * @name: a D-Bus name.
+ *
+ * Returns: %TRUE if @name is owned on the session bus, %FALSE else.
+ *
+ * Until the registry has been seeded, the bus is directly asked for.
+ * May block, and may be called from any thread.
+ */
+gboolean
+na_dbus_names_is_registered( const gchar *name )
+{
+	static const gchar *thisfn = "na_dbus_names_is_registered";
+	gboolean registered;
+	GDBusConnection *connection;
+	GVariant *reply;
+	GError *error;
+
+	g_return_val_if_fail( name && strlen( name ), FALSE );
+
+	names_init();
+
+	if( na_dbus_names_peek( name, &registered )){
+		return( registered );
+	}
+
+	registered = FALSE;
+	error = NULL;
+	connection = g_bus_get_sync( G_BUS_TYPE_SESSION, NULL, &error );
+
+	if( !connection ){
+		g_warning( "%s: %s", thisfn, error->message );
+		g_error_free( error );
+
+	} else {
+		reply = g_dbus_connection_call_sync( connection,
+				DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE, "NameHasOwner",
+				g_variant_new( "(s)", name ), G_VARIANT_TYPE( "(b)" ),
+				G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error );
+
+		if( !reply ){
+			g_debug( "%s: %s", thisfn, error->message );
+			g_error_free( error );
+
+		} else {
+			g_variant_get( reply, "(b)", &registered );
+			g_variant_unref( reply );
+		}
+
+		g_object_unref( connection );
+	}
+
+	return( registered );
+}
+
+/*
+ * na_dbus_names_peek:
+ * @name: a D-Bus name.
+ * @registered: [out]: whether @name is owned on the session bus.
+ *
+ * Returns: %TRUE if the registry has been seeded, and @registered has
+ * been set, %FALSE else.
+ *
+ * The first call starts the registry, which is then seeded
+ * asynchronously. Never blocks. The first call must be made from the
+ * main thread.
+ */
+gboolean
+na_dbus_names_peek( const gchar *name, gboolean *registered )
+{
+	gboolean found;
+
+	g_return_val_if_fail( name && strlen( name ), FALSE );
+	g_return_val_if_fail( registered, FALSE );
+
+	names_init();
+	names_start();
+
+	found = FALSE;
+
+	g_mutex_lock( st_mutex );
+
+	if( st_seeded ){
+		*registered = ( g_hash_table_lookup( st_names, name ) != NULL );
+		found = TRUE;
+	}
+
+	g_mutex_unlock( st_mutex );
+
+	return( found );
+}
+
+/*
+ * may be first called concurrently from several threads
+ */
+static void
+names_init( void )
+{
+	static gsize initialized = 0;
+
+	if( g_once_init_enter( &initialized )){
+#if GLIB_CHECK_VERSION( 2, 32, 0 )
+		g_mutex_init( &st_mutex_struct );
+		st_mutex = &st_mutex_struct;
+#else
+		st_mutex = g_mutex_new();
+#endif
+		st_names = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+		g_once_init_leave( &initialized, 1 );
+	}
+}
+
+/*
+ * the connection is asynchronously got, so that the main thread is not
+ * blocked by the connection setup
+ */
+static void
+names_start( void )
+{
+	gboolean start;
+
+	g_mutex_lock( st_mutex );
+	start = !st_started;
+	st_started = TRUE;
+	g_mutex_unlock( st_mutex );
+
+	if( start ){
+		g_bus_get( G_BUS_TYPE_SESSION, NULL, ( GAsyncReadyCallback ) on_bus_got, NULL );
+	}
+}
+
+/*
+ * first subscribe to NameOwnerChanged, then seed the registry: as the
+ * bus delivers the messages in order, the ListNames reply is newer than
+ * all the signals received before it
+ */
+static void
+on_bus_got( GObject *source, GAsyncResult *res, void *empty )
+{
+	static const gchar *thisfn = "na_dbus_names_on_bus_got";
+	GError *error;
+
+	error = NULL;
+	st_connection = g_bus_get_finish( res, &error );
+
+	if( !st_connection ){
+		g_warning( "%s: %s", thisfn, error->message );
+		g_error_free( error );
+
+		g_mutex_lock( st_mutex );
+		st_started = FALSE;
+		g_mutex_unlock( st_mutex );
+
+	} else {
+		g_signal_connect( st_connection, "closed", G_CALLBACK( on_connection_closed ), NULL );
+
+		g_dbus_connection_signal_subscribe( st_connection,
+				DBUS_SERVICE, DBUS_INTERFACE, "NameOwnerChanged", DBUS_PATH, NULL,
+				G_DBUS_SIGNAL_FLAGS_NONE, ( GDBusSignalCallback ) on_name_owner_changed, NULL, NULL );
+
+		g_dbus_connection_call( st_connection,
+				DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE, "ListNames",
+				NULL, G_VARIANT_TYPE( "(as)" ),
+				G_DBUS_CALL_FLAGS_NONE, -1, NULL, ( GAsyncReadyCallback ) on_list_names, NULL );
+	}
+}
+
+static void
+on_list_names( GObject *source, GAsyncResult *res, void *empty )
+{
+	static const gchar *thisfn = "na_dbus_names_on_list_names";
+	GVariant *reply;
+	GVariantIter *iter;
+	GError *error;
+	gchar *name;
+
+	error = NULL;
+	reply = g_dbus_connection_call_finish( G_DBUS_CONNECTION( source ), res, &error );
+
+	if( !reply ){
+		g_warning( "%s: %s", thisfn, error->message );
+		g_error_free( error );
+
+	} else {
+		g_mutex_lock( st_mutex );
+
+		g_hash_table_remove_all( st_names );
+		g_variant_get( reply, "(as)", &iter );
+		while( g_variant_iter_loop( iter, "s", &name )){
+			g_hash_table_insert( st_names, g_strdup( name ), GUINT_TO_POINTER( 1 ));
+		}
+		g_variant_iter_free( iter );
+		st_seeded = TRUE;
+
+		g_debug( "%s: %u names", thisfn, g_hash_table_size( st_names ));
+
+		g_mutex_unlock( st_mutex );
+
+		g_variant_unref( reply );
+	}
+}
+
+static void
+on_name_owner_changed( GDBusConnection *connection, const gchar *sender, const gchar *path, const gchar *iface, const gchar *signal, GVariant *parameters, void *empty )
+{
+	const gchar *name, *old_owner, *new_owner;
+
+	g_variant_get( parameters, "(&s&s&s)", &name, &old_owner, &new_owner );
+
+	g_mutex_lock( st_mutex );
+
+	if( strlen( new_owner )){
+		g_hash_table_replace( st_names, g_strdup( name ), GUINT_TO_POINTER( 1 ));
+
+	} else {
+		g_hash_table_remove( st_names, name );
+	}
+
+	g_mutex_unlock( st_mutex );
+}
+
+/*
+ * the registry is no more reliable: it will be restarted on next peek
+ */
+static void
+on_connection_closed( GDBusConnection *connection, gboolean remote_peer_vanished, GError *error, void *empty )
+{
+	static const gchar *thisfn = "na_dbus_names_on_connection_closed";
+
+	g_debug( "%s: connection=%p", thisfn, ( void * ) connection );
+
+	g_mutex_lock( st_mutex );
+
+	g_hash_table_remove_all( st_names );
+	st_seeded = FALSE;
+	st_started = FALSE;
+
+	g_mutex_unlock( st_mutex );
+
+	if( st_connection == connection ){
+		g_object_unref( st_connection );
+		st_connection = NULL;
+	}
+}
+
+#endif /* HAVE_GDBUS */
@@ -0,0 +1,54 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2014 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_NA_DBUS_NAMES_H__
+#define __CORE_NA_DBUS_NAMES_H__
+
+/* @title: D-Bus names registry
+ * @short_description: The set of the names owned on the session bus.
+ * @include: core/na-dbus-names.h
+ *
+ * ShowIfRegistered conditions are checked against a long-lived registry
+ * of the names owned on the session bus. The registry is seeded once with
+ * the ListNames method, and then kept up to date by listening to the
+ * NameOwnerChanged signal, so that each check is a hash lookup.
+ *
+ * Only available with GDBus.
+ */
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+gboolean na_dbus_names_is_registered( const gchar *name );
+gboolean na_dbus_names_peek         ( const gchar *name, gboolean *registered );
+
+G_END_DECLS
+
+#endif /* __CORE_NA_DBUS_NAMES_H__ */
@@ -0,0 +1,1002 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2014 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifndef HAVE_GDBUS
+# ifdef HAVE_DBUS_GLIB
+#include <dbus/dbus-glib.h>
+# endif
+#endif
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "na-dbus-names.h"
+#include "na-dynamic-condition.h"
+#include "na-exec-cache.h"
+#include "na-process-snapshot.h"
+#include "na-settings.h"
+
+/* the result of the evaluation of a dynamic condition
+ *
+ * results are shared by all the contexts which have the same condition:
+ * a result is computed at most once per menu build.
+ *
+ * all the fields but type and value, which are set at creation time and
+ * never modified, are protected by st_mutex
+ */
+typedef struct {
+	NADynamicCondition type;
+	gchar             *value;
+	gboolean           known;		/* whether a result has already been computed */
+	gboolean           result;		/* the last computed result */
+	gboolean           pending;		/* an evaluation is in progress */
+	gboolean           late;		/* the deadline has expired while waiting for the result */
+	gboolean           late_shown;	/* what has been displayed instead */
+	gboolean           fresh;		/* a late result not yet consumed by a menu */
+	guint              generation;	/* the last menu which has got this result */
+	gint64             computed;	/* monotonic time of the last computation */
+}
+	DynamicResult;
+
+/* evaluate() is run by a worker thread
+ * peek(), if set, is run from the main thread with st_mutex locked, and
+ * returns %TRUE if it has been able to cheaply get a result
+ */
+typedef gboolean ( *DynamicEvaluateFn )( const gchar *value );
+typedef gboolean ( *DynamicPeekFn )    ( const gchar *value, gboolean *result );
+
+typedef struct {
+	const gchar      *name;
+	const gchar      *policy_key;
+	DynamicEvaluateFn evaluate;
+	DynamicPeekFn     peek;
+}
+	DynamicConditionDef;
+
+static gboolean evaluate_try_exec( const gchar *tryexec );
+static gboolean peek_try_exec( const gchar *tryexec, gboolean *result );
+static gboolean evaluate_show_if_registered( const gchar *name );
+static gboolean peek_show_if_registered( const gchar *name, gboolean *result );
+static gboolean evaluate_show_if_true( const gchar *command );
+static gboolean evaluate_show_if_running( const gchar *running );
+static gboolean peek_show_if_running( const gchar *running, gboolean *result );
+
+/* indexed by NADynamicCondition
+ */
+static const DynamicConditionDef st_defs[] = {
+	{ "TryExec",          NA_IPREFS_DYNAMIC_TRY_EXEC_POLICY,           evaluate_try_exec,           peek_try_exec },
+	{ "ShowIfRegistered", NA_IPREFS_DYNAMIC_SHOW_IF_REGISTERED_POLICY, evaluate_show_if_registered, peek_show_if_registered },
+	{ "ShowIfTrue",       NA_IPREFS_DYNAMIC_SHOW_IF_TRUE_POLICY,       evaluate_show_if_true,       NULL },
+	{ "ShowIfRunning",    NA_IPREFS_DYNAMIC_SHOW_IF_RUNNING_POLICY,    evaluate_show_if_running,    peek_show_if_running }
+};
+
+/* count of worker threads */
+static gint                   st_max_workers     = 4;
+
+/* the longest time the main thread may wait for the dynamic conditions,
+ * in milliseconds: a zero or greater deadline is clamped to this value,
+ * which also applies outside of a menu build
+ */
+#define DYNAMIC_MAX_DEADLINE			1000
+
+/* count of menu builds during which an unused result is kept */
+static guint                  st_keep_generations = 64;
+
+/* ShowIfTrue: only the first bytes of the output are kept, as the
+ * output is only compared to "true"
+ */
+#define SHOW_IF_TRUE_OUTPUT				"true"
+#define SHOW_IF_TRUE_HEAD				8
+
+/* the ShowIfTrue children
+ * the counters are only informational
+ */
+typedef struct {
+	guint running;
+	guint spawns;
+	guint hits;
+	guint timeouts;
+}
+	ShowIfTrueStats;
+
+#if GLIB_CHECK_VERSION( 2, 32, 0 )
+static GMutex                 st_mutex_struct;
+static GCond                  st_cond_struct;
+static GCond                  st_children_cond_struct;
+#endif
+
+static gboolean               st_initialized     = FALSE;
+static GMutex                *st_mutex           = NULL;
+static GCond                 *st_cond            = NULL;
+static GCond                 *st_children_cond   = NULL;
+static GThreadPool           *st_pool            = NULL;
+static GHashTable            *st_results         = NULL;
+static guint                  st_generation      = 0;
+static gboolean               st_in_menu         = FALSE;
+static gint64                 st_deadline        = 0;
+static guint                  st_late_source     = 0;
+static NADynamicConditionFunc st_late_handler    = NULL;
+static void                  *st_late_data       = NULL;
+static gint64                 st_ttl[DYNAMIC_CONDITION_N] = { 0 };
+static gint64                 st_child_timeout   = 0;
+static guint                  st_max_children    = 1;
+static ShowIfTrueStats        st_show_if_true    = { 0 };
+static gint64                 st_menu_start      = 0;
+static gint64                 st_snapshot_ttl    = 0;
+static gint64                 st_try_exec_ttl    = 0;
+
+static void           dynamic_init( void );
+static void           read_settings( void );
+static gint64         get_monotonic_time( void );
+static void           wait_for_result( gint64 end_time );
+static DynamicResult *get_result( NADynamicCondition type, const gchar *value );
+static gboolean       get_known_result( DynamicResult *result, gboolean *ok );
+static void           push_result( DynamicResult *result );
+static void           result_free( DynamicResult *result );
+static gboolean       is_result_expired( const gchar *key, DynamicResult *result, void *empty );
+static gboolean       get_timeout_result( DynamicResult *result );
+static void           worker_run( DynamicResult *result, void *empty );
+static gboolean       on_late_results( void *empty );
+static gboolean       spawn_show_if_true( gchar **argv );
+static void           spawn_child_setup( void *empty );
+static gssize         read_child_output( gint fd, gchar *head, gsize size, gint64 end_time );
+static gboolean       wait_child( GPid pid, gint64 end_time );
+static gint64         get_snapshot_max_age( void );
+
+/*
+ * na_dynamic_condition_begin_menu:
+ *
+ * Starts a new menu build: the evaluation of the dynamic conditions will
+ * be bounded by the deadline configured in the preferences, from now.
+ *
+ * A zero deadline, or a deadline greater than one second, is clamped to
+ * one second, as the main thread is blocked while waiting.
+ *
+ * Must be called from the main thread.
+ */
+void
+na_dynamic_condition_begin_menu( void )
+{
+	guint timeout;
+
+	dynamic_init();
+	read_settings();
+
+	timeout = na_settings_get_uint( NA_IPREFS_DYNAMIC_DEADLINE, NULL, NULL );
+	if( !timeout || timeout > DYNAMIC_MAX_DEADLINE ){
+		timeout = DYNAMIC_MAX_DEADLINE;
+	}
+
+	g_mutex_lock( st_mutex );
+
+	st_generation += 1;
+	st_in_menu = TRUE;
+	st_menu_start = get_monotonic_time();
+	st_deadline = st_menu_start + ( gint64 ) timeout * 1000;
+
+	g_hash_table_foreach_remove( st_results, ( GHRFunc ) is_result_expired, NULL );
+
+	g_mutex_unlock( st_mutex );
+}
+
+/*
+ * na_dynamic_condition_end_menu:
+ *
+ * Ends the current menu build.
+ *
+ * Must be called from the main thread.
+ */
+void
+na_dynamic_condition_end_menu( void )
+{
+	static const gchar *thisfn = "na_dynamic_condition_end_menu";
+
+	dynamic_init();
+
+	g_mutex_lock( st_mutex );
+
+	st_in_menu = FALSE;
+	st_deadline = 0;
+
+	g_debug( "%s: ShowIfTrue: spawns=%u, hits=%u, timeouts=%u",
+			thisfn, st_show_if_true.spawns, st_show_if_true.hits, st_show_if_true.timeouts );
+	g_debug( "%s: ShowIfRunning: snapshot age=%" G_GINT64_FORMAT " us, build cost=%" G_GINT64_FORMAT " us",
+			thisfn, na_process_snapshot_get_age(), na_process_snapshot_get_build_cost());
+
+	g_mutex_unlock( st_mutex );
+}
+
+/*
+ * na_dynamic_condition_dispatch:
+ * @type: the type of the condition.
+ * @value: the value of the condition, as for na_dynamic_condition_evaluate().
+ *
+ * Starts the evaluation of the condition by a worker thread, unless its
+ * result is already known, without waiting for it.
+ *
+ * The plugin dispatches the dynamic conditions of all the items which
+ * may be candidate before evaluating any of them, so that they are
+ * evaluated in parallel within the deadline of the menu.
+ *
+ * Must be called from the main thread, between na_dynamic_condition_begin_menu()
+ * and na_dynamic_condition_end_menu().
+ */
+void
+na_dynamic_condition_dispatch( NADynamicCondition type, const gchar *value )
+{
+	DynamicResult *result;
+	gboolean ok;
+
+	g_return_if_fail( type < DYNAMIC_CONDITION_N );
+
+	dynamic_init();
+
+	if( !st_pool || !value || !strlen( value )){
+		return;
+	}
+
+	g_mutex_lock( st_mutex );
+
+	result = get_result( type, value );
+
+	if( !result->pending && !get_known_result( result, &ok )){
+		push_result( result );
+	}
+
+	g_mutex_unlock( st_mutex );
+}
+
+/*
+ * na_dynamic_condition_evaluate:
+ * @type: the type of the condition.
+ * @value: the value of the condition, i.e. the path of the TryExec
+ *  executable, the ShowIfRegistered D-Bus name, the ShowIfTrue command
+ *  or the ShowIfRunning executable.
+ *
+ * Returns: %TRUE if the condition is satisfied, %FALSE else.
+ *
+ * If the result is not known when the deadline of the current menu
+ * expires, the result is decided by the timeout policy of the condition,
+ * and the late result will be used on the next menu build. Outside of a
+ * menu build, the evaluation waits at most for one second.
+ *
+ * Must be called from the main thread.
+ */
+gboolean
+na_dynamic_condition_evaluate( NADynamicCondition type, const gchar *value )
+{
+	static const gchar *thisfn = "na_dynamic_condition_evaluate";
+	DynamicResult *result;
+	gboolean ok, timed_out;
+	gint64 end_time;
+
+	g_return_val_if_fail( type < DYNAMIC_CONDITION_N, FALSE );
+	g_return_val_if_fail( value && strlen( value ), FALSE );
+
+	dynamic_init();
+
+	/* no worker thread: evaluate synchronously */
+	if( !st_pool ){
+		return( st_defs[type].evaluate( value ));
+	}
+
+	ok = FALSE;
+	timed_out = FALSE;
+
+	g_mutex_lock( st_mutex );
+
+	result = get_result( type, value );
+
+	if( result->pending || !get_known_result( result, &ok )){
+		push_result( result );
+
+		/* the main thread never waits without limit */
+		end_time = st_deadline ? st_deadline : get_monotonic_time() + ( gint64 ) DYNAMIC_MAX_DEADLINE * 1000;
+
+		while( result->pending && get_monotonic_time() < end_time ){
+			wait_for_result( end_time );
+		}
+
+		if( result->pending ){
+			timed_out = TRUE;
+			ok = get_timeout_result( result );
+
+		} else {
+			result->generation = st_generation;
+			ok = result->result;
+		}
+	}
+
+	g_mutex_unlock( st_mutex );
+
+	if( timed_out ){
+		g_debug( "%s: %s=%s: deadline expired, result=%s",
+				thisfn, st_defs[type].name, value, ok ? "True":"False" );
+	}
+
+	return( ok );
+}
+
+/*
+ * na_dynamic_condition_get_show_if_true_stats:
+ * @spawns: [out]: the count of spawned ShowIfTrue commands.
+ * @hits: [out]: the count of ShowIfTrue results found in the cache.
+ * @timeouts: [out]: the count of ShowIfTrue commands which have been
+ *  killed because they did not terminate in time.
+ *
+ * Returns the counters since the program started.
+ */
+void
+na_dynamic_condition_get_show_if_true_stats( guint *spawns, guint *hits, guint *timeouts )
+{
+	dynamic_init();
+
+	g_mutex_lock( st_mutex );
+
+	if( spawns ){
+		*spawns = st_show_if_true.spawns;
+	}
+	if( hits ){
+		*hits = st_show_if_true.hits;
+	}
+	if( timeouts ){
+		*timeouts = st_show_if_true.timeouts;
+	}
+
+	g_mutex_unlock( st_mutex );
+}
+
+/*
+ * na_dynamic_condition_set_late_handler:
+ * @handler: the function to be called from the main loop when a result
+ *  which has missed the deadline of its menu becomes available, or %NULL.
+ * @user_data: data to be passed to @handler.
+ *
+ * Only one handler may be registered at any time.
+ */
+void
+na_dynamic_condition_set_late_handler( NADynamicConditionFunc handler, void *user_data )
+{
+	dynamic_init();
+
+	g_mutex_lock( st_mutex );
+
+	st_late_handler = handler;
+	st_late_data = user_data;
+
+	g_mutex_unlock( st_mutex );
+}
+
+static void
+dynamic_init( void )
+{
+	static const gchar *thisfn = "na_dynamic_condition_init";
+	GError *error;
+
+	if( !st_initialized ){
+		g_debug( "%s: max_workers=%d", thisfn, st_max_workers );
+
+#if GLIB_CHECK_VERSION( 2, 32, 0 )
+		g_mutex_init( &st_mutex_struct );
+		g_cond_init( &st_cond_struct );
+		g_cond_init( &st_children_cond_struct );
+		st_mutex = &st_mutex_struct;
+		st_cond = &st_cond_struct;
+		st_children_cond = &st_children_cond_struct;
+#else
+		if( !g_thread_supported()){
+			g_thread_init( NULL );
+		}
+		st_mutex = g_mutex_new();
+		st_cond = g_cond_new();
+		st_children_cond = g_cond_new();
+#endif
+
+#ifndef HAVE_GDBUS
+# ifdef HAVE_DBUS_GLIB
+		dbus_g_thread_init();
+# endif
+#endif
+
+		st_results = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, ( GDestroyNotify ) result_free );
+
+		error = NULL;
+		st_pool = g_thread_pool_new(( GFunc ) worker_run, NULL, st_max_workers, FALSE, &error );
+		if( error ){
+			g_warning( "%s: %s", thisfn, error->message );
+			g_error_free( error );
+		}
+
+		st_initialized = TRUE;
+
+		read_settings();
+	}
+}
+
+/*
+ * the settings which are used by the worker threads are read here, from
+ * the main thread, at initialization time and each time a menu is built
+ */
+static void
+read_settings( void )
+{
+	guint ttl, timeout, max_children, snapshot_ttl, try_exec_ttl;
+
+	ttl = na_settings_get_uint( NA_IPREFS_DYNAMIC_SHOW_IF_TRUE_TTL, NULL, NULL );
+	timeout = na_settings_get_uint( NA_IPREFS_DYNAMIC_SHOW_IF_TRUE_TIMEOUT, NULL, NULL );
+	max_children = na_settings_get_uint( NA_IPREFS_DYNAMIC_MAX_CHILDREN, NULL, NULL );
+	snapshot_ttl = na_settings_get_uint( NA_IPREFS_DYNAMIC_PROCESS_SNAPSHOT_TTL, NULL, NULL );
+	try_exec_ttl = na_settings_get_uint( NA_IPREFS_DYNAMIC_TRY_EXEC_REMOTE_TTL, NULL, NULL );
+
+	g_mutex_lock( st_mutex );
+
+	st_ttl[DYNAMIC_CONDITION_SHOW_IF_TRUE] = ( gint64 ) ttl * 1000;
+	st_child_timeout = ( gint64 ) timeout * 1000;
+	st_max_children = MAX( 1, max_children );
+	st_snapshot_ttl = ( gint64 ) snapshot_ttl * 1000;
+	st_try_exec_ttl = ( gint64 ) try_exec_ttl * 1000;
+
+	/* more children may now be allowed */
+	g_cond_broadcast( st_children_cond );
+
+	g_mutex_unlock( st_mutex );
+}
+
+static gint64
+get_monotonic_time( void )
+{
+#if GLIB_CHECK_VERSION( 2, 28, 0 )
+	return( g_get_monotonic_time());
+#else
+	GTimeVal now;
+
+	g_get_current_time( &now );
+
+	return(( gint64 ) now.tv_sec * G_USEC_PER_SEC + now.tv_usec );
+#endif
+}
+
+/*
+ * waits for a result to be signaled, at most until @end_time
+ * - st_mutex must be locked
+ */
+static void
+wait_for_result( gint64 end_time )
+{
+#if GLIB_CHECK_VERSION( 2, 32, 0 )
+	g_cond_wait_until( st_cond, st_mutex, end_time );
+#else
+	GTimeVal abs_time;
+
+	g_get_current_time( &abs_time );
+	g_time_val_add( &abs_time, ( glong )( end_time - get_monotonic_time()));
+	g_cond_timed_wait( st_cond, st_mutex, &abs_time );
+#endif
+}
+
+/*
+ * returns the result structure for this condition, allocating it if
+ * needed - st_mutex must be locked
+ */
+static DynamicResult *
+get_result( NADynamicCondition type, const gchar *value )
+{
+	DynamicResult *result;
+	gchar *key;
+
+	key = g_strdup_printf( "%u:%s", type, value );
+	result = ( DynamicResult * ) g_hash_table_lookup( st_results, key );
+
+	if( result ){
+		g_free( key );
+
+	} else {
+		result = g_new0( DynamicResult, 1 );
+		result->type = type;
+		result->value = g_strdup( value );
+		g_hash_table_insert( st_results, key, result );
+	}
+
+	return( result );
+}
+
+/*
+ * Returns: %TRUE if the result of the condition is already known for
+ * this menu, or may be cheaply known without a worker, setting @ok
+ * - st_mutex must be locked, and the result must not be pending
+ */
+static gboolean
+get_known_result( DynamicResult *result, gboolean *ok )
+{
+	NADynamicCondition type;
+	gboolean peeked;
+
+	type = result->type;
+
+	/* a late result is consumed by the first menu which asks for it */
+	if( result->fresh ){
+		result->fresh = FALSE;
+
+	/* the result has already been computed for this same menu, or is
+	 * still valid */
+	} else if( result->known &&
+				(( st_in_menu && result->generation == st_generation ) ||
+				 ( st_ttl[type] && get_monotonic_time() - result->computed < st_ttl[type] ))){
+		if( type == DYNAMIC_CONDITION_SHOW_IF_TRUE && result->generation != st_generation ){
+			st_show_if_true.hits += 1;
+		}
+
+	/* the result may be cheaply known without a worker */
+	} else if( st_defs[type].peek && st_defs[type].peek( result->value, &peeked )){
+		result->result = peeked;
+		result->known = TRUE;
+		result->computed = get_monotonic_time();
+
+	} else {
+		return( FALSE );
+	}
+
+	result->generation = st_generation;
+	*ok = result->result;
+
+	return( TRUE );
+}
+
+/*
+ * pushes the result to the worker threads, unless it is already pending
+ * the result is attached to the current menu, so that it is not computed
+ * again when it completes before being asked for
+ * - st_mutex must be locked
+ */
+static void
+push_result( DynamicResult *result )
+{
+	if( !result->pending ){
+		result->pending = TRUE;
+		result->late = FALSE;
+		result->generation = st_generation;
+		g_thread_pool_push( st_pool, result, NULL );
+	}
+}
+
+static void
+result_free( DynamicResult *result )
+{
+	g_free( result->value );
+	g_free( result );
+}
+
+/*
+ * a result which has not been used since a while is released, unless it
+ * is still referenced by a worker thread, or not yet consumed
+ */
+static gboolean
+is_result_expired( const gchar *key, DynamicResult *result, void *empty )
+{
+	return( !result->pending && !result->fresh && st_generation - result->generation > st_keep_generations );
+}
+
+/*
+ * applies the timeout policy of the condition, and records what has been
+ * displayed so that the late result is only signaled if it differs
+ * - st_mutex must be locked
+ */
+static gboolean
+get_timeout_result( DynamicResult *result )
+{
+	gchar *policy;
+	gboolean ok;
+
+	policy = na_settings_get_string( st_defs[result->type].policy_key, NULL, NULL );
+
+	if( policy && !strcmp( policy, DYNAMIC_POLICY_SHOW )){
+		ok = TRUE;
+
+	} else if( policy && !strcmp( policy, DYNAMIC_POLICY_LAST )){
+		ok = result->known ? result->result : FALSE;
+
+	} else {
+		ok = FALSE;
+	}
+
+	g_free( policy );
+
+	result->late = TRUE;
+	result->late_shown = ok;
+
+	return( ok );
+}
+
+static void
+worker_run( DynamicResult *result, void *empty )
+{
+	gboolean ok;
+
+	ok = st_defs[result->type].evaluate( result->value );
+
+	g_mutex_lock( st_mutex );
+
+	result->result = ok;
+	result->known = TRUE;
+	result->pending = FALSE;
+	result->computed = get_monotonic_time();
+
+	if( result->late ){
+		result->late = FALSE;
+
+		if( ok != result->late_shown ){
+			result->fresh = TRUE;
+			if( !st_late_source ){
+				st_late_source = g_idle_add(( GSourceFunc ) on_late_results, NULL );
+			}
+		}
+	}
+
+	g_cond_broadcast( st_cond );
+
+	g_mutex_unlock( st_mutex );
+}
+
+/*
+ * in the main loop: signal that some late results are available
+ */
+static gboolean
+on_late_results( void *empty )
+{
+	static const gchar *thisfn = "na_dynamic_condition_on_late_results";
+	NADynamicConditionFunc handler;
+	void *user_data;
+
+	g_mutex_lock( st_mutex );
+
+	st_late_source = 0;
+	handler = st_late_handler;
+	user_data = st_late_data;
+
+	g_mutex_unlock( st_mutex );
+
+	g_debug( "%s: handler=%p", thisfn, ( void * ) handler );
+
+	if( handler ){
+		handler( user_data );
+	}
+
+	return( FALSE );
+}
+
+/*
+ * if the data is set, it should be the path of an executable file
+ */
+static gboolean
+evaluate_try_exec( const gchar *tryexec )
+{
+	return( na_exec_cache_is_executable( tryexec ));
+}
+
+/*
+ * the executable status is kept in a process-wide cache, invalidated by
+ * monitoring the parent directory, or after a time-to-live for remote
+ * files
+ */
+static gboolean
+peek_try_exec( const gchar *tryexec, gboolean *result )
+{
+	return( na_exec_cache_peek( tryexec, st_try_exec_ttl, result ));
+}
+
+static gboolean
+evaluate_show_if_registered( const gchar *name )
+{
+	gboolean ok;
+
+	ok = FALSE;
+
+#ifdef HAVE_GDBUS
+	ok = na_dbus_names_is_registered( name );
+#else
+# ifdef HAVE_DBUS_GLIB
+	static const gchar *thisfn = "na_dynamic_condition_evaluate_show_if_registered";
+	GError *error = NULL;
+	DBusGConnection *connection = dbus_g_bus_get( DBUS_BUS_SESSION, &error );
+
+	if( !connection ){
+		if( error ){
+			g_warning( "%s: %s", thisfn, error->message );
+			g_error_free( error );
+		}
+
+	} else {
+		DBusGProxy *proxy = dbus_g_proxy_new_for_name( connection, name, NULL, NULL );
+		ok = ( proxy != NULL );
+		dbus_g_connection_unref( connection );
+	}
+# endif
+#endif
+
+	return( ok );
+}
+
+/*
+ * with GDBus, the names are looked up in a registry of the names owned
+ * on the session bus
+ */
+static gboolean
+peek_show_if_registered( const gchar *name, gboolean *result )
+{
+#ifdef HAVE_GDBUS
+	return( na_dbus_names_peek( name, result ));
+#else
+	return( FALSE );
+#endif
+}
+
+/*
+ * the command is run with a hard timeout, after which the child is
+ * killed, and the count of simultaneously running children is bounded
+ */
+static gboolean
+evaluate_show_if_true( const gchar *command )
+{
+	static const gchar *thisfn = "na_dynamic_condition_evaluate_show_if_true";
+	gboolean ok;
+	gchar **argv;
+	GError *error;
+
+	ok = FALSE;
+	argv = NULL;
+	error = NULL;
+
+	if( !g_shell_parse_argv( command, NULL, &argv, &error )){
+		g_debug( "%s: %s", thisfn, error->message );
+		g_error_free( error );
+
+	} else {
+		g_mutex_lock( st_mutex );
+		while( st_show_if_true.running >= st_max_children ){
+			g_cond_wait( st_children_cond, st_mutex );
+		}
+		st_show_if_true.running += 1;
+		g_mutex_unlock( st_mutex );
+
+		ok = spawn_show_if_true( argv );
+
+		g_mutex_lock( st_mutex );
+		st_show_if_true.running -= 1;
+		g_cond_signal( st_children_cond );
+		g_mutex_unlock( st_mutex );
+
+		g_strfreev( argv );
+	}
+
+	return( ok );
+}
+
+static gboolean
+spawn_show_if_true( gchar **argv )
+{
+	static const gchar *thisfn = "na_dynamic_condition_spawn_show_if_true";
+	gboolean ok;
+	GError *error;
+	GPid pid;
+	gint out_fd;
+	gint64 end_time;
+	gchar head[SHOW_IF_TRUE_HEAD];
+	gssize length;
+	gboolean terminated;
+
+	ok = FALSE;
+	error = NULL;
+
+	if( !g_spawn_async_with_pipes( NULL, argv, NULL,
+			G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD,
+			( GSpawnChildSetupFunc ) spawn_child_setup, NULL, &pid, NULL, &out_fd, NULL, &error )){
+
+		g_debug( "%s: %s", thisfn, error->message );
+		g_error_free( error );
+
+	} else {
+		g_mutex_lock( st_mutex );
+		st_show_if_true.spawns += 1;
+		end_time = st_child_timeout ? get_monotonic_time() + st_child_timeout : 0;
+		g_mutex_unlock( st_mutex );
+
+		length = read_child_output( out_fd, head, sizeof( head ), end_time );
+		close( out_fd );
+
+		/* the output has not been closed in time: a descendant of the
+		 * child may still hold it, even if the child itself has exited
+		 */
+		if( length < 0 ){
+			kill( -pid, SIGKILL );
+		}
+
+		terminated = wait_child( pid, end_time );
+		g_spawn_close_pid( pid );
+
+		if( terminated ){
+			ok = ( length == ( gssize ) strlen( SHOW_IF_TRUE_OUTPUT ) &&
+					!memcmp( head, SHOW_IF_TRUE_OUTPUT, length ));
+
+		} else {
+			g_debug( "%s: %s: killed after timeout", thisfn, argv[0] );
+			g_mutex_lock( st_mutex );
+			st_show_if_true.timeouts += 1;
+			g_mutex_unlock( st_mutex );
+		}
+	}
+
+	return( ok );
+}
+
+/*
+ * the child is the leader of its own process group, so that it may be
+ * killed with all its descendants
+ * - this is run in the child, between fork and exec
+ */
+static void
+spawn_child_setup( void *empty )
+{
+	setpgid( 0, 0 );
+}
+
+/*
+ * reads the output of the child until end of file, keeping only its
+ * first bytes in @head
+ *
+ * Returns: the total length of the output, or -1 if the end of file has
+ * not been reached before @end_time.
+ */
+static gssize
+read_child_output( gint fd, gchar *head, gsize size, gint64 end_time )
+{
+	gchar buffer[512];
+	gsize total;
+	gssize count;
+	gint64 remaining;
+	struct pollfd pfd;
+	gint rc;
+
+	total = 0;
+
+	while( TRUE ){
+		remaining = -1;
+		if( end_time ){
+			remaining = ( end_time - get_monotonic_time()) / 1000;
+			if( remaining <= 0 ){
+				return( -1 );
+			}
+		}
+
+		pfd.fd = fd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		rc = poll( &pfd, 1, ( gint ) remaining );
+
+		if( rc < 0 && errno != EINTR ){
+			return( -1 );
+		}
+		if( rc <= 0 ){
+			continue;
+		}
+
+		count = read( fd, buffer, sizeof( buffer ));
+
+		if( count < 0 ){
+			if( errno == EINTR || errno == EAGAIN ){
+				continue;
+			}
+			return( -1 );
+		}
+		if( count == 0 ){
+			return(( gssize ) total );
+		}
+		if( total < size ){
+			memcpy( head+total, buffer, MIN(( gsize ) count, size-total ));
+		}
+		total += count;
+	}
+}
+
+/*
+ * waits for the child to terminate, killing it and its descendants if it
+ * has not terminated at @end_time
+ *
+ * Returns: %TRUE if the child has terminated by itself.
+ */
+static gboolean
+wait_child( GPid pid, gint64 end_time )
+{
+	gint status;
+	pid_t rc;
+
+	while( TRUE ){
+		rc = waitpid( pid, &status, end_time ? WNOHANG : 0 );
+
+		if( rc == pid || ( rc < 0 && errno != EINTR )){
+			return( TRUE );
+		}
+		if( rc == 0 ){
+			if( get_monotonic_time() >= end_time ){
+				break;
+			}
+			g_usleep( 1000 );
+		}
+	}
+
+	kill( -pid, SIGKILL );
+	waitpid( pid, &status, 0 );
+
+	return( FALSE );
+}
+
+/*
+ * the process table is only walked once per menu build, or once per
+ * time-to-live, whichever is the longest
+ * - st_mutex must be locked
+ */
+static gint64
+get_snapshot_max_age( void )
+{
+	gint64 max_age;
+
+	max_age = st_snapshot_ttl;
+
+	if( st_in_menu ){
+		max_age = MAX( max_age, get_monotonic_time() - st_menu_start );
+	}
+
+	return( max_age );
+}
+
+static gboolean
+evaluate_show_if_running( const gchar *running )
+{
+	gint64 max_age;
+
+	g_mutex_lock( st_mutex );
+	max_age = get_snapshot_max_age();
+	g_mutex_unlock( st_mutex );
+
+	return( na_process_snapshot_is_running( running, max_age ));
+}
+
+static gboolean
+peek_show_if_running( const gchar *running, gboolean *result )
+{
+	return( na_process_snapshot_peek( running, get_snapshot_max_age(), result ));
+}
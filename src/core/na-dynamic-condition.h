@@ -0,0 +1,103 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2014 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_NA_DYNAMIC_CONDITION_H__
+#define __CORE_NA_DYNAMIC_CONDITION_H__
+
+/* @title: Dynamic conditions
+ * @short_description: Asynchronous evaluation of the dynamic conditions.
+ * @include: core/na-dynamic-condition.h
+ *
+ * The dynamic conditions (TryExec, ShowIfRegistered, ShowIfTrue and
+ * ShowIfRunning) depend on the state of the system at the time the menu
+ * is built. They may be long to evaluate, and so are evaluated by a pool
+ * of worker threads.
+ *
+ * The plugin brackets each menu build between na_dynamic_condition_begin_menu()
+ * and na_dynamic_condition_end_menu(). It first dispatches the conditions
+ * of all the items which may be candidate with na_dynamic_condition_dispatch(),
+ * so that they are evaluated in parallel, and then reads the results with
+ * na_dynamic_condition_evaluate(). The evaluation of all the dynamic
+ * conditions of a menu is bounded by a configurable deadline. When this
+ * deadline expires before a result is known, the result is decided by
+ * the timeout policy of the condition (hide, show or last known value),
+ * and the late result will be signaled through the handler registered
+ * with na_dynamic_condition_set_late_handler().
+ *
+ * The main thread never waits more than one second for the dynamic
+ * conditions, whether inside or outside of a menu build.
+ *
+ * ShowIfTrue results are kept for a configurable time-to-live, keyed on
+ * the fully expanded command line. The commands are killed when they do
+ * not terminate in time, and the count of simultaneous children is bounded.
+ *
+ * ShowIfRunning conditions are checked against a snapshot of the process
+ * table, taken at most once per menu build (see na-process-snapshot.h).
+ *
+ * TryExec conditions are checked against a process-wide cache of the
+ * executable status of the files (see na-exec-cache.h).
+ *
+ * With GDBus, ShowIfRegistered conditions are checked against a registry
+ * of the names owned on the session bus (see na-dbus-names.h).
+ */
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+typedef enum {
+	DYNAMIC_CONDITION_TRY_EXEC = 0,
+	DYNAMIC_CONDITION_SHOW_IF_REGISTERED,
+	DYNAMIC_CONDITION_SHOW_IF_TRUE,
+	DYNAMIC_CONDITION_SHOW_IF_RUNNING,
+	DYNAMIC_CONDITION_N
+}
+	NADynamicCondition;
+
+/* the policies to be applied when the deadline expires
+ */
+#define DYNAMIC_POLICY_HIDE			"Hide"
+#define DYNAMIC_POLICY_SHOW			"Show"
+#define DYNAMIC_POLICY_LAST			"Last"
+
+typedef void ( *NADynamicConditionFunc )( void *user_data );
+
+void     na_dynamic_condition_begin_menu            ( void );
+void     na_dynamic_condition_end_menu              ( void );
+
+void     na_dynamic_condition_dispatch              ( NADynamicCondition type, const gchar *value );
+gboolean na_dynamic_condition_evaluate              ( NADynamicCondition type, const gchar *value );
+
+void     na_dynamic_condition_get_show_if_true_stats( guint *spawns, guint *hits, guint *timeouts );
+
+void     na_dynamic_condition_set_late_handler      ( NADynamicConditionFunc handler, void *user_data );
+
+G_END_DECLS
+
+#endif /* __CORE_NA_DYNAMIC_CONDITION_H__ */
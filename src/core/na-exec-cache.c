@@ -0,0 +1,372 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2014 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gio/gio.h>
+#include <string.h>
+
+#include "na-exec-cache.h"
+
+/* an entry of the cache, indexed by path
+ */
+typedef struct {
+	gboolean executable;
+	gboolean remote;			/* whether the file is on a remote filesystem */
+	gint64   checked;			/* monotonic time of the check */
+}
+	ExecEntry;
+
+/* st_entries: path -> ExecEntry
+ * st_generations: directory -> count of the changes signaled for it, so
+ *  that a check which has been overtaken by a change is not recorded
+ * st_monitors: directory -> GFileMonitor, only used from the main thread
+ *
+ * st_mutex protects st_entries and st_generations
+ */
+#if GLIB_CHECK_VERSION( 2, 32, 0 )
+static GMutex      st_mutex_struct;
+#endif
+
+static GMutex     *st_mutex    = NULL;
+static GHashTable *st_entries     = NULL;
+static GHashTable *st_generations = NULL;
+static GHashTable *st_monitors    = NULL;
+
+static void     exec_cache_init( void );
+static gint64   get_monotonic_time( void );
+static guint    get_generation( const gchar *dir );
+static void     bump_generation( const gchar *dir );
+static gboolean is_remote( GFile *file );
+static gboolean is_monitored( const gchar *path );
+static void     on_directory_changed( GFileMonitor *monitor, GFile *file, GFile *other, GFileMonitorEvent event, const gchar *dir );
+static gboolean remove_dir_entry( const gchar *path, ExecEntry *entry, const gchar *dir );
+
+/*
+ * na_exec_cache_is_executable:
+ * @path: the path of a file.
+ *
+ * Returns: %TRUE if @path is executable, %FALSE else.
+ *
+ * Always checks the filesystem, and records the result in the cache,
+ * unless the directory of @path has changed during the check.
+ * May be called from any thread.
+ */
+gboolean
+na_exec_cache_is_executable( const gchar *path )
+{
+	static const gchar *thisfn = "na_exec_cache_is_executable";
+	ExecEntry *entry;
+	gboolean executable;
+	gboolean remote;
+	GError *error;
+	GFile *file;
+	GFileInfo *info;
+	gchar *dir;
+	guint generation;
+
+	g_return_val_if_fail( path && strlen( path ), FALSE );
+
+	exec_cache_init();
+
+	dir = g_path_get_dirname( path );
+
+	g_mutex_lock( st_mutex );
+	generation = get_generation( dir );
+	g_mutex_unlock( st_mutex );
+
+	executable = FALSE;
+	error = NULL;
+	file = g_file_new_for_path( path );
+	info = g_file_query_info( file, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE, G_FILE_QUERY_INFO_NONE, NULL, &error );
+
+	if( error ){
+		g_debug( "%s: %s", thisfn, error->message );
+		g_error_free( error );
+
+	} else {
+		executable = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE );
+	}
+
+	if( info ){
+		g_object_unref( info );
+	}
+
+	remote = is_remote( file );
+	g_object_unref( file );
+
+	g_mutex_lock( st_mutex );
+
+	if( get_generation( dir ) == generation ){
+		entry = g_new0( ExecEntry, 1 );
+		entry->executable = executable;
+		entry->remote = remote;
+		entry->checked = get_monotonic_time();
+		g_hash_table_replace( st_entries, g_strdup( path ), entry );
+
+	} else {
+		g_debug( "%s: %s: directory changed while checking, not recorded", thisfn, path );
+	}
+
+	g_mutex_unlock( st_mutex );
+
+	g_free( dir );
+
+	return( executable );
+}
+
+/*
+ * na_exec_cache_peek:
+ * @path: the path of a file.
+ * @ttl: the time-to-live of an entry which is not monitored (us).
+ * @executable: [out]: whether @path is executable.
+ *
+ * Returns: %TRUE if the cache has a valid entry for @path, and
+ * @executable has been set, %FALSE else.
+ *
+ * The parent directory of a local file begins to be monitored the first
+ * time the entry is peeked; until then, the entry is only valid for @ttl.
+ *
+ * Must be called from the main thread.
+ */
+gboolean
+na_exec_cache_peek( const gchar *path, gint64 ttl, gboolean *executable )
+{
+	ExecEntry *entry;
+	gboolean found, remote, monitored;
+
+	g_return_val_if_fail( path && strlen( path ), FALSE );
+	g_return_val_if_fail( executable, FALSE );
+
+	exec_cache_init();
+
+	found = FALSE;
+	remote = FALSE;
+
+	g_mutex_lock( st_mutex );
+
+	entry = ( ExecEntry * ) g_hash_table_lookup( st_entries, path );
+
+	if( entry ){
+		remote = entry->remote;
+		*executable = entry->executable;
+		found = ( get_monotonic_time() - entry->checked < ttl );
+	}
+
+	g_mutex_unlock( st_mutex );
+
+	if( entry && !remote ){
+		monitored = is_monitored( path );
+		found |= monitored;
+	}
+
+	return( found );
+}
+
+/*
+ * may be first called concurrently from several threads
+ */
+static void
+exec_cache_init( void )
+{
+	static gsize initialized = 0;
+
+	if( g_once_init_enter( &initialized )){
+#if GLIB_CHECK_VERSION( 2, 32, 0 )
+		g_mutex_init( &st_mutex_struct );
+		st_mutex = &st_mutex_struct;
+#else
+		st_mutex = g_mutex_new();
+#endif
+		st_entries = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, g_free );
+		st_generations = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+		st_monitors = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, g_object_unref );
+		g_once_init_leave( &initialized, 1 );
+	}
+}
+
+static gint64
+get_monotonic_time( void )
+{
+#if GLIB_CHECK_VERSION( 2, 28, 0 )
+	return( g_get_monotonic_time());
+#else
+	GTimeVal now;
+
+	g_get_current_time( &now );
+
+	return(( gint64 ) now.tv_sec * G_USEC_PER_SEC + now.tv_usec );
+#endif
+}
+
+/*
+ * st_mutex must be locked
+ */
+static guint
+get_generation( const gchar *dir )
+{
+	return( GPOINTER_TO_UINT( g_hash_table_lookup( st_generations, dir )));
+}
+
+/*
+ * st_mutex must be locked
+ */
+static void
+bump_generation( const gchar *dir )
+{
+	g_hash_table_replace( st_generations, g_strdup( dir ), GUINT_TO_POINTER( get_generation( dir )+1 ));
+}
+
+/*
+ * a non-existing file is considered from its parent directory; when in
+ * doubt, the file is considered as remote, i.e. not monitored
+ */
+static gboolean
+is_remote( GFile *file )
+{
+	gboolean remote;
+	GFileInfo *info;
+	GFile *parent;
+
+	remote = TRUE;
+	info = g_file_query_filesystem_info( file, G_FILE_ATTRIBUTE_FILESYSTEM_REMOTE, NULL, NULL );
+
+	if( !info ){
+		parent = g_file_get_parent( file );
+		if( parent ){
+			info = g_file_query_filesystem_info( parent, G_FILE_ATTRIBUTE_FILESYSTEM_REMOTE, NULL, NULL );
+			g_object_unref( parent );
+		}
+	}
+
+	if( info ){
+		remote = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_FILESYSTEM_REMOTE );
+		g_object_unref( info );
+	}
+
+	return( remote );
+}
+
+/*
+ * makes sure the parent directory of @path is monitored
+ *
+ * Returns: %TRUE if the directory was already monitored before this call,
+ * i.e. if the entry is known to be up to date.
+ */
+static gboolean
+is_monitored( const gchar *path )
+{
+	static const gchar *thisfn = "na_exec_cache_is_monitored";
+	gchar *dir;
+	GFile *file;
+	GFileMonitor *monitor;
+	GError *error;
+	gboolean monitored;
+
+	dir = g_path_get_dirname( path );
+	monitored = ( g_hash_table_lookup( st_monitors, dir ) != NULL );
+
+	if( monitored ){
+		g_free( dir );
+
+	} else {
+		error = NULL;
+		file = g_file_new_for_path( dir );
+		monitor = g_file_monitor_directory( file, G_FILE_MONITOR_NONE, NULL, &error );
+		g_object_unref( file );
+
+		if( error ){
+			g_debug( "%s: %s: %s", thisfn, dir, error->message );
+			g_error_free( error );
+			g_free( dir );
+
+		} else {
+			g_debug( "%s: monitoring %s", thisfn, dir );
+			g_hash_table_insert( st_monitors, dir, monitor );
+			g_signal_connect( monitor, "changed", G_CALLBACK( on_directory_changed ), dir );
+		}
+	}
+
+	return( monitored );
+}
+
+/*
+ * invalidates the entry of the changed file, or all the entries of the
+ * directory if the directory itself is concerned
+ */
+static void
+on_directory_changed( GFileMonitor *monitor, GFile *file, GFile *other, GFileMonitorEvent event, const gchar *dir )
+{
+	gchar *path, *other_dir;
+
+	g_mutex_lock( st_mutex );
+
+	bump_generation( dir );
+
+	path = g_file_get_path( file );
+
+	if( !path || !strcmp( path, dir )){
+		g_hash_table_foreach_remove( st_entries, ( GHRFunc ) remove_dir_entry, ( gpointer ) dir );
+
+	} else {
+		g_hash_table_remove( st_entries, path );
+	}
+
+	g_free( path );
+
+	if( other ){
+		path = g_file_get_path( other );
+		if( path ){
+			g_hash_table_remove( st_entries, path );
+			other_dir = g_path_get_dirname( path );
+			if( strcmp( other_dir, dir )){
+				bump_generation( other_dir );
+			}
+			g_free( other_dir );
+			g_free( path );
+		}
+	}
+
+	g_mutex_unlock( st_mutex );
+}
+
+static gboolean
+remove_dir_entry( const gchar *path, ExecEntry *entry, const gchar *dir )
+{
+	gchar *entry_dir;
+	gboolean remove;
+
+	entry_dir = g_path_get_dirname( path );
+	remove = ( strcmp( entry_dir, dir ) == 0 );
+	g_free( entry_dir );
+
+	return( remove );
+}
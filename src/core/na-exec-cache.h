@@ -0,0 +1,57 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2014 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_NA_EXEC_CACHE_H__
+#define __CORE_NA_EXEC_CACHE_H__
+
+/* @title: TryExec cache
+ * @short_description: A process-wide cache of the executable status of files.
+ * @include: core/na-exec-cache.h
+ *
+ * The executable status of the TryExec paths is cached on first use.
+ *
+ * On a local filesystem, the status is kept until a monitor on the parent
+ * directory signals that the file has changed. On a remote filesystem,
+ * where monitoring is not reliable, the status is kept for a time-to-live.
+ *
+ * na_exec_cache_is_executable() may block, and is expected to be called
+ * from a worker thread. na_exec_cache_peek() never blocks, and must be
+ * called from the main thread, which dispatches the monitor events.
+ */
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+gboolean na_exec_cache_is_executable( const gchar *path );
+gboolean na_exec_cache_peek         ( const gchar *path, gint64 ttl, gboolean *executable );
+
+G_END_DECLS
+
+#endif /* __CORE_NA_EXEC_CACHE_H__ */
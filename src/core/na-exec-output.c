@@ -0,0 +1,608 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2014 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib/gi18n.h>
+#include <gtk/gtk.h>
+#include <string.h>
+#include <sys/wait.h>
+
+#include "na-exec-output.h"
+#include "na-settings.h"
+
+/* a ring buffer which keeps the most recent bytes of a stream
+ * the ring holds the bytes from offset total-len to total of the stream,
+ * the first total-len bytes having been overwritten
+ */
+typedef struct {
+	gchar   *data;
+	gsize    size;
+	gsize    start;
+	gsize    len;
+	guint64  total;				/* count of the appended bytes */
+}
+	RingBuffer;
+
+/* a chunk of text inserted in the view at once
+ * it is deleted from the view when its last byte has been overwritten
+ * in the ring
+ */
+typedef struct {
+	guint64  end;				/* stream offset of the end of the chunk */
+	gint     chars;				/* count of characters in the view */
+}
+	ShownChunk;
+
+/* one of the standard output and error streams of the child
+ */
+typedef struct {
+	NAExecOutput *output;
+	const gchar  *title;
+	GIOChannel   *channel;		/* NULL when the stream has been closed */
+	RingBuffer    ring;
+	GtkWidget    *view;			/* NULL when the dialog has been closed */
+	guint64       shown;		/* stream offset of the end of the view */
+	GQueue       *chunks;		/* ShownChunk's in the view, oldest first */
+	guint64       dropped;		/* count of dropped bytes in the marker */
+	gint          marker_chars;	/* count of characters of the marker */
+}
+	OutputStream;
+
+struct _NAExecOutput {
+	gchar        *command;
+	OutputStream  streams[2];
+	GtkWidget    *dialog;
+	GtkWidget    *status;
+	guint         refresh_id;
+	gboolean      exited;
+	gint          exit_status;
+};
+
+/* the minimal size of a ring buffer
+ * the delay between two refreshes of the dialog, in ms.
+ * the size of a read, and the count of reads in a main loop iteration
+ */
+#define OUTPUT_MIN_SIZE					1024
+#define OUTPUT_REFRESH_DELAY			100
+#define OUTPUT_READ_SIZE				4096
+#define OUTPUT_READ_MAX					16
+
+static void      stream_open( OutputStream *stream, NAExecOutput *output, const gchar *title, gint fd, gsize size );
+static gboolean  on_stream_event( GIOChannel *channel, GIOCondition condition, OutputStream *stream );
+static void      stream_close( OutputStream *stream );
+static void      dialog_create( NAExecOutput *output );
+static GtkWidget *dialog_add_stream( GtkWidget *box, OutputStream *stream );
+static void      on_dialog_destroy( GtkWidget *dialog, NAExecOutput *output );
+static void      refresh_schedule( NAExecOutput *output );
+static gboolean  on_refresh( NAExecOutput *output );
+static void      refresh_stream( OutputStream *stream );
+static void      refresh_marker( OutputStream *stream, GtkTextBuffer *buffer );
+static void      stream_free_chunks( OutputStream *stream );
+static void      refresh_status( NAExecOutput *output );
+static void      output_free_if_done( NAExecOutput *output );
+static void      ring_init( RingBuffer *ring, gsize size );
+static void      ring_append( RingBuffer *ring, const gchar *buf, gsize count );
+static gchar    *ring_to_utf8( const RingBuffer *ring, guint64 from, gboolean skip_orphans, gboolean flush, guint64 *to );
+static void      ring_free( RingBuffer *ring );
+
+/*
+ * na_exec_output_new:
+ * @command: the run command.
+ * @fd_stdout: the file descriptor of the standard output of the child.
+ * @fd_stderr: the file descriptor of the standard error of the child.
+ *
+ * Starts to read the output of the child, and displays it.
+ *
+ * Returns: a new #NAExecOutput structure, which takes ownership of the
+ * file descriptors.
+ */
+NAExecOutput *
+na_exec_output_new( const gchar *command, gint fd_stdout, gint fd_stderr )
+{
+	NAExecOutput *output;
+	gsize size;
+
+	size = MAX( OUTPUT_MIN_SIZE, na_settings_get_uint( NA_IPREFS_EXECUTION_OUTPUT_MAX_SIZE, NULL, NULL ));
+
+	output = g_new0( NAExecOutput, 1 );
+	output->command = g_strdup( command );
+
+	stream_open( &output->streams[0], output, _( "Standard output:" ), fd_stdout, size );
+	stream_open( &output->streams[1], output, _( "Standard error:" ), fd_stderr, size );
+
+	dialog_create( output );
+
+	return( output );
+}
+
+/*
+ * na_exec_output_child_exited:
+ * @output: this #NAExecOutput structure.
+ * @status: the exit status of the child, as returned by waitpid().
+ *
+ * Records the end of the child.
+ *
+ * The streams are still read until they are closed, as some output may
+ * remain in the pipes.
+ */
+void
+na_exec_output_child_exited( NAExecOutput *output, gint status )
+{
+	g_return_if_fail( output );
+
+	output->exited = TRUE;
+	output->exit_status = status;
+
+	if( output->dialog ){
+		refresh_status( output );
+	}
+
+	output_free_if_done( output );
+}
+
+static void
+stream_open( OutputStream *stream, NAExecOutput *output, const gchar *title, gint fd, gsize size )
+{
+	static const gchar *thisfn = "na_exec_output_stream_open";
+	GError *error;
+
+	stream->output = output;
+	stream->title = title;
+	stream->chunks = g_queue_new();
+	ring_init( &stream->ring, size );
+
+	if( fd < 0 ){
+		return;
+	}
+
+	stream->channel = g_io_channel_unix_new( fd );
+	g_io_channel_set_close_on_unref( stream->channel, TRUE );
+
+	error = NULL;
+	g_io_channel_set_encoding( stream->channel, NULL, NULL );
+	g_io_channel_set_buffered( stream->channel, FALSE );
+
+	if( g_io_channel_set_flags( stream->channel, G_IO_FLAG_NONBLOCK, &error ) != G_IO_STATUS_NORMAL ){
+		g_warning( "%s: g_io_channel_set_flags: %s", thisfn, error->message );
+		g_error_free( error );
+	}
+
+	g_io_add_watch( stream->channel, G_IO_IN | G_IO_HUP | G_IO_ERR, ( GIOFunc ) on_stream_event, stream );
+}
+
+/*
+ * reads what is available, without blocking, and in a bounded count of
+ * reads so that a chatty child does not starve the main loop
+ *
+ * on hang up, the stream is read until there is nothing left, and then
+ * closed, so that the watch does not fire again and again
+ */
+static gboolean
+on_stream_event( GIOChannel *channel, GIOCondition condition, OutputStream *stream )
+{
+	static const gchar *thisfn = "na_exec_output_on_stream_event";
+	gchar buf[OUTPUT_READ_SIZE];
+	gsize count;
+	GIOStatus status;
+	GError *error;
+	guint i;
+
+	status = G_IO_STATUS_NORMAL;
+	error = NULL;
+
+	for( i = 0 ; i < OUTPUT_READ_MAX && status == G_IO_STATUS_NORMAL ; ++i ){
+		count = 0;
+		status = g_io_channel_read_chars( channel, buf, sizeof( buf ), &count, &error );
+
+		if( count ){
+			ring_append( &stream->ring, buf, count );
+		}
+	}
+
+	if( stream->shown < stream->ring.total ){
+		refresh_schedule( stream->output );
+	}
+
+	if( status == G_IO_STATUS_NORMAL && !( condition & G_IO_ERR )){
+		return( TRUE );
+	}
+
+	if( status == G_IO_STATUS_AGAIN && !( condition & ( G_IO_HUP | G_IO_ERR ))){
+		return( TRUE );
+	}
+
+	if( error ){
+		g_warning( "%s: g_io_channel_read_chars: %s", thisfn, error->message );
+		g_error_free( error );
+	}
+
+	stream_close( stream );
+	output_free_if_done( stream->output );
+
+	return( FALSE );
+}
+
+/*
+ * the watch is removed by the caller returning FALSE
+ * a last refresh displays the bytes which were kept because they did
+ * not make a full character
+ */
+static void
+stream_close( OutputStream *stream )
+{
+	g_io_channel_unref( stream->channel );
+	stream->channel = NULL;
+
+	if( stream->shown < stream->ring.total ){
+		refresh_schedule( stream->output );
+	}
+}
+
+static void
+stream_free_chunks( OutputStream *stream )
+{
+	ShownChunk *chunk;
+
+	while(( chunk = g_queue_pop_head( stream->chunks )) != NULL ){
+		g_slice_free( ShownChunk, chunk );
+	}
+}
+
+static void
+dialog_create( NAExecOutput *output )
+{
+	GtkWidget *box;
+	gchar *markup;
+
+	output->dialog = gtk_message_dialog_new_with_markup(
+			NULL, 0, GTK_MESSAGE_INFO, GTK_BUTTONS_OK, "<b>%s</b>", _( "Output of the run command" ));
+	g_object_set( G_OBJECT( output->dialog ) , "title", PACKAGE_NAME, NULL );
+	gtk_window_set_resizable( GTK_WINDOW( output->dialog ), TRUE );
+
+	markup = g_markup_printf_escaped( "<b>%s</b>\n%s", _( "Run command:" ), output->command );
+	gtk_message_dialog_format_secondary_markup( GTK_MESSAGE_DIALOG( output->dialog ), "%s", markup );
+	g_free( markup );
+
+	box = gtk_dialog_get_content_area( GTK_DIALOG( output->dialog ));
+	output->streams[0].view = dialog_add_stream( box, &output->streams[0] );
+	output->streams[1].view = dialog_add_stream( box, &output->streams[1] );
+
+	output->status = gtk_label_new( NULL );
+	g_object_set( G_OBJECT( output->status ), "xalign", 0.0, NULL );
+	gtk_box_pack_start( GTK_BOX( box ), output->status, FALSE, FALSE, 4 );
+	refresh_status( output );
+
+	g_signal_connect( output->dialog, "response", G_CALLBACK( gtk_widget_destroy ), NULL );
+	g_signal_connect( output->dialog, "destroy", G_CALLBACK( on_dialog_destroy ), output );
+
+	gtk_widget_show_all( output->dialog );
+}
+
+static GtkWidget *
+dialog_add_stream( GtkWidget *box, OutputStream *stream )
+{
+	GtkWidget *label, *scrolled, *view;
+	gchar *markup;
+
+	label = gtk_label_new( NULL );
+	markup = g_markup_printf_escaped( "<b>%s</b>", stream->title );
+	gtk_label_set_markup( GTK_LABEL( label ), markup );
+	g_free( markup );
+	g_object_set( G_OBJECT( label ), "xalign", 0.0, NULL );
+	gtk_box_pack_start( GTK_BOX( box ), label, FALSE, FALSE, 4 );
+
+	scrolled = gtk_scrolled_window_new( NULL, NULL );
+	gtk_scrolled_window_set_policy( GTK_SCROLLED_WINDOW( scrolled ), GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC );
+	gtk_scrolled_window_set_shadow_type( GTK_SCROLLED_WINDOW( scrolled ), GTK_SHADOW_IN );
+	gtk_widget_set_size_request( scrolled, 480, 120 );
+	gtk_box_pack_start( GTK_BOX( box ), scrolled, TRUE, TRUE, 0 );
+
+	view = gtk_text_view_new();
+	gtk_text_view_set_editable( GTK_TEXT_VIEW( view ), FALSE );
+	gtk_text_view_set_cursor_visible( GTK_TEXT_VIEW( view ), FALSE );
+	gtk_container_add( GTK_CONTAINER( scrolled ), view );
+
+	return( view );
+}
+
+/*
+ * the streams are still read after the dialog has been closed, so that
+ * the child does not block on a full pipe
+ */
+static void
+on_dialog_destroy( GtkWidget *dialog, NAExecOutput *output )
+{
+	output->dialog = NULL;
+	output->status = NULL;
+	output->streams[0].view = NULL;
+	output->streams[1].view = NULL;
+	stream_free_chunks( &output->streams[0] );
+	stream_free_chunks( &output->streams[1] );
+
+	if( output->refresh_id ){
+		g_source_remove( output->refresh_id );
+		output->refresh_id = 0;
+	}
+
+	output_free_if_done( output );
+}
+
+/*
+ * the dialog is refreshed at most once per delay, whatever be the
+ * count of reads
+ */
+static void
+refresh_schedule( NAExecOutput *output )
+{
+	if( output->dialog && !output->refresh_id ){
+		output->refresh_id = g_timeout_add( OUTPUT_REFRESH_DELAY, ( GSourceFunc ) on_refresh, output );
+	}
+}
+
+static gboolean
+on_refresh( NAExecOutput *output )
+{
+	output->refresh_id = 0;
+
+	refresh_stream( &output->streams[0] );
+	refresh_stream( &output->streams[1] );
+
+	return( FALSE );
+}
+
+/*
+ * only the bytes read since the last refresh are converted and appended
+ * to the view, while the chunks whose bytes have been overwritten in the
+ * ring are deleted from its start: the work is proportional to what has
+ * been read, not to the size of the ring
+ */
+static void
+refresh_stream( OutputStream *stream )
+{
+	GtkTextBuffer *buffer;
+	GtkTextIter start, end;
+	ShownChunk *chunk;
+	guint64 first, from, to;
+	gchar *text;
+	gint chars;
+
+	if( !stream->view || stream->shown == stream->ring.total ){
+		return;
+	}
+
+	buffer = gtk_text_view_get_buffer( GTK_TEXT_VIEW( stream->view ));
+	first = stream->ring.total - stream->ring.len;
+
+	while(( chunk = g_queue_peek_head( stream->chunks )) != NULL && chunk->end <= first ){
+		gtk_text_buffer_get_iter_at_offset( buffer, &start, stream->marker_chars );
+		gtk_text_buffer_get_iter_at_offset( buffer, &end, stream->marker_chars + chunk->chars );
+		gtk_text_buffer_delete( buffer, &start, &end );
+		g_slice_free( ShownChunk, g_queue_pop_head( stream->chunks ));
+	}
+
+	if( first != stream->dropped ){
+		stream->dropped = first;
+		refresh_marker( stream, buffer );
+	}
+
+	from = MAX( stream->shown, first );
+	text = ring_to_utf8( &stream->ring, from, from > stream->shown, stream->channel == NULL, &to );
+	stream->shown = to;
+	chars = g_utf8_strlen( text, -1 );
+
+	if( chars ){
+		gtk_text_buffer_get_end_iter( buffer, &end );
+		gtk_text_buffer_insert( buffer, &end, text, -1 );
+
+		chunk = g_slice_new( ShownChunk );
+		chunk->end = to;
+		chunk->chars = chars;
+		g_queue_push_tail( stream->chunks, chunk );
+	}
+	g_free( text );
+
+	gtk_text_buffer_get_end_iter( buffer, &end );
+	gtk_text_buffer_place_cursor( buffer, &end );
+	gtk_text_view_scroll_mark_onscreen( GTK_TEXT_VIEW( stream->view ), gtk_text_buffer_get_insert( buffer ));
+}
+
+/*
+ * the count of dropped bytes is displayed on the first line of the view
+ */
+static void
+refresh_marker( OutputStream *stream, GtkTextBuffer *buffer )
+{
+	GtkTextIter start, end;
+	gchar *marker;
+
+	gtk_text_buffer_get_start_iter( buffer, &start );
+	gtk_text_buffer_get_iter_at_offset( buffer, &end, stream->marker_chars );
+	gtk_text_buffer_delete( buffer, &start, &end );
+
+	marker = g_strdup_printf( _( "[... %" G_GUINT64_FORMAT " bytes dropped ...]\n" ), stream->dropped );
+	gtk_text_buffer_get_start_iter( buffer, &start );
+	gtk_text_buffer_insert( buffer, &start, marker, -1 );
+	stream->marker_chars = g_utf8_strlen( marker, -1 );
+	g_free( marker );
+}
+
+static void
+refresh_status( NAExecOutput *output )
+{
+	gchar *text;
+
+	if( !output->exited ){
+		text = g_strdup( _( "Running..." ));
+
+	} else if( WIFEXITED( output->exit_status )){
+		text = g_strdup_printf( _( "Exited with status %d." ), WEXITSTATUS( output->exit_status ));
+
+	} else if( WIFSIGNALED( output->exit_status )){
+		text = g_strdup_printf( _( "Terminated by signal %d." ), WTERMSIG( output->exit_status ));
+
+	} else {
+		text = g_strdup( _( "Terminated." ));
+	}
+
+	gtk_label_set_text( GTK_LABEL( output->status ), text );
+	g_free( text );
+}
+
+static void
+output_free_if_done( NAExecOutput *output )
+{
+	if( output->exited && !output->dialog && !output->streams[0].channel && !output->streams[1].channel ){
+		ring_free( &output->streams[0].ring );
+		ring_free( &output->streams[1].ring );
+		stream_free_chunks( &output->streams[0] );
+		stream_free_chunks( &output->streams[1] );
+		g_queue_free( output->streams[0].chunks );
+		g_queue_free( output->streams[1].chunks );
+		g_free( output->command );
+		g_free( output );
+	}
+}
+
+static void
+ring_init( RingBuffer *ring, gsize size )
+{
+	ring->data = g_malloc( size );
+	ring->size = size;
+	ring->start = 0;
+	ring->len = 0;
+	ring->total = 0;
+}
+
+/*
+ * appends @count bytes, overwriting the oldest ones when the ring is full
+ */
+static void
+ring_append( RingBuffer *ring, const gchar *buf, gsize count )
+{
+	gsize end, first, over;
+
+	ring->total += count;
+
+	if( count >= ring->size ){
+		memcpy( ring->data, buf + count - ring->size, ring->size );
+		ring->start = 0;
+		ring->len = ring->size;
+		return;
+	}
+
+	end = ( ring->start + ring->len ) % ring->size;
+	first = MIN( count, ring->size - end );
+	memcpy( ring->data + end, buf, first );
+	memcpy( ring->data, buf + first, count - first );
+
+	if( ring->len + count > ring->size ){
+		over = ring->len + count - ring->size;
+		ring->start = ( ring->start + over ) % ring->size;
+		ring->len = ring->size;
+
+	} else {
+		ring->len += count;
+	}
+}
+
+/*
+ * Returns: the bytes of the ring from the stream offset @from to the end,
+ * converted from the locale to UTF-8, as a newly allocated string; @to
+ * is set to the stream offset of the end of the converted bytes
+ *
+ * in a UTF-8 locale:
+ * - when @skip_orphans, the first character may have been partially
+ *   overwritten, and its orphan continuation bytes are skipped
+ * - unless @flush, an incomplete character at the end is kept for the
+ *   next call
+ * in any case, the invalid sequences are replaced with a question mark
+ */
+static gchar *
+ring_to_utf8( const RingBuffer *ring, guint64 from, gboolean skip_orphans, gboolean flush, guint64 *to )
+{
+	GString *raw, *text;
+	gsize pos, count, first;
+	const gchar *charset, *begin, *end, *limit, *p;
+	gchar *converted;
+
+	count = ring->total - from;
+	pos = ( ring->start + ring->len - count ) % ring->size;
+
+	raw = g_string_sized_new( count + 1 );
+	first = MIN( count, ring->size - pos );
+	g_string_append_len( raw, ring->data + pos, first );
+	g_string_append_len( raw, ring->data, count - first );
+
+	text = g_string_sized_new( raw->len );
+	begin = raw->str;
+	limit = raw->str + raw->len;
+
+	if( g_get_charset( &charset )){
+		while( skip_orphans && begin < limit && (( guchar ) *begin & 0xc0 ) == 0x80 ){
+			++begin;
+		}
+		if( !flush ){
+			for( p = limit ; p > begin && limit-p < 3 && (( guchar ) p[-1] & 0xc0 ) == 0x80 ; --p )
+				;
+			if( p > begin && ( guchar ) p[-1] >= 0xc0 && limit-p+1 < g_utf8_skip[( guchar ) p[-1]] ){
+				limit = p-1;
+			}
+		}
+		while( begin < limit ){
+			g_utf8_validate( begin, limit - begin, &end );
+			g_string_append_len( text, begin, end - begin );
+			if( end < limit ){
+				g_string_append_c( text, '?' );
+				++end;
+			}
+			begin = end;
+		}
+
+	} else {
+		converted = g_convert_with_fallback( begin, limit - begin, "UTF-8", charset, "?", NULL, NULL, NULL );
+		if( converted ){
+			g_string_append( text, converted );
+			g_free( converted );
+		}
+	}
+
+	*to = from + ( limit - raw->str );
+	g_string_free( raw, TRUE );
+
+	return( g_string_free( text, FALSE ));
+}
+
+static void
+ring_free( RingBuffer *ring )
+{
+	g_free( ring->data );
+}
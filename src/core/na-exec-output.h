@@ -0,0 +1,64 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2014 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_NA_EXEC_OUTPUT_H__
+#define __CORE_NA_EXEC_OUTPUT_H__
+
+/* @title: Output of the run commands
+ * @short_description: The display of the output of a run command.
+ * @include: core/na-exec-output.h
+ *
+ * The standard output and error streams of a command run in the
+ * 'DisplayOutput' execution mode are read from the main loop through
+ * non-blocking channels, so that the child never blocks on a full pipe.
+ *
+ * Each stream is kept in a ring buffer whose size is bounded by the
+ * 'execution-output-max-size' preference: when the child writes more
+ * than that, only the most recent output is kept.
+ *
+ * The output is displayed in a non-modal dialog, which is updated as
+ * the output arrives.
+ *
+ * The #NAExecOutput structure releases itself when the child has exited,
+ * both streams have been closed, and the dialog has been closed by the
+ * user.
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _NAExecOutput NAExecOutput;
+
+NAExecOutput *na_exec_output_new         ( const gchar *command, gint fd_stdout, gint fd_stderr );
+void          na_exec_output_child_exited( NAExecOutput *output, gint status );
+
+G_END_DECLS
+
+#endif /* __CORE_NA_EXEC_OUTPUT_H__ */
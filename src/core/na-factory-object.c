@@ -42,18 +42,37 @@
 #include <api/na-ifactory-provider.h>
 #include <api/na-object-api.h>
 
+#include "na-boxed-priv.h"
 #include "na-factory-object.h"
 #include "na-factory-provider.h"
 
 typedef gboolean ( *NADataDefIterFunc )( NADataDef *def, void *user_data );
 
 enum {
-	DATA_DEF_ITER_SET_PROPERTIES = 1,
+	DATA_DEF_ITER_SET_SLOTS = 1,
+	DATA_DEF_ITER_SET_PROPERTIES,
 	DATA_DEF_ITER_SET_DEFAULTS,
 	DATA_DEF_ITER_IS_VALID,
 	DATA_DEF_ITER_READ_ITEM,
 };
 
+/* the elementary datas of an object
+ * the NADataBoxed are indexed by the slot of their NADataDef, minus one
+ *
+ * the content hash is the sum of the hashes of the comparable data, each
+ * one being mixed with its slot; the hash of a slot is only computed when
+ * the content hash is requested, and is removed from the sum as soon as
+ * the data changes
+ */
+typedef struct {
+	guint         count;
+	NADataBoxed **slots;
+	guint        *hashes;
+	guint8       *hashed;
+	guint         hash;
+}
+	NafoData;
+
 /* while iterating on read item
  */
 typedef struct {
@@ -92,6 +111,19 @@ typedef struct {
 extern gboolean                   ifactory_object_initialized;
 extern gboolean                   ifactory_object_finalized;
 
+/* st_slots: name -> slot of the NADataDef
+ * the NADataDef which share a same name share the same slot, so that a
+ * NADataBoxed keeps its slot when it is moved to another class of object
+ * st_def_slots: NADataDef address -> slot, so that the slot of a known
+ * definition does not require to hash its name
+ * both are only written when the classes are initialized
+ */
+static GHashTable                *st_slots       = NULL;
+static GHashTable                *st_def_slots   = NULL;
+static guint                      st_slots_count = 0;
+static GQuark                     st_data_quark  = 0;
+
+static gboolean     define_slots_iter( NADataDef *def, void *empty );
 static gboolean     define_class_properties_iter( const NADataDef *def, GObjectClass *class );
 static gboolean     set_defaults_iter( NADataDef *def, NafoDefaultIter *data );
 static gboolean     is_valid_mandatory_iter( const NADataDef *def, NafoValidIter *data );
@@ -107,7 +139,17 @@ static void         v_read_done( NAIFactoryObject *serializable, const NAIFactor
 static guint        v_write_start( NAIFactoryObject *serializable, const NAIFactoryProvider *reader, void *reader_data, GSList **messages );
 static guint        v_write_done( NAIFactoryObject *serializable, const NAIFactoryProvider *reader, void *reader_data, GSList **messages );
 
+static NafoData    *get_data( const NAIFactoryObject *object );
+static NADataBoxed *get_data_boxed( const NAIFactoryObject *object, guint slot );
+static guint        get_slot( const gchar *name );
+static guint        get_def_slot( const NADataDef *def );
 static void         attach_boxed_to_object( NAIFactoryObject *object, NADataBoxed *boxed );
+static void         detach_boxed_from_object( const NAIFactoryObject *object, NADataBoxed *boxed );
+static NADataBoxed *get_writable_boxed( NAIFactoryObject *object, NADataBoxed *boxed );
+static guint        get_content_hash( NafoData *data );
+static void         invalidate_hash( NafoData *data, guint slot );
+static void         slot_changed( const NAIFactoryObject *object, const NADataBoxed *boxed );
+static void         data_changed( NAIFactoryObject *object, const gchar *name );
 static void         free_data_boxed_list( NAIFactoryObject *object );
 static void         iter_on_data_defs( const NADataGroup *idgroups, guint mode, NADataDefIterFunc pfn, void *user_data );
 
@@ -128,11 +170,42 @@ na_factory_object_define_properties( GObjectClass *class, const NADataGroup *gro
 	g_debug( "%s: class=%p (%s)",
 			thisfn, ( void * ) class, G_OBJECT_CLASS_NAME( class ));
 
+	/* allocate a slot to each data
+	 */
+	if( !st_slots ){
+		st_slots = g_hash_table_new( g_str_hash, g_str_equal );
+		st_def_slots = g_hash_table_new( g_direct_hash, g_direct_equal );
+		st_data_quark = g_quark_from_static_string( NA_IFACTORY_OBJECT_PROP_DATA );
+	}
+
+	iter_on_data_defs( groups, DATA_DEF_ITER_SET_SLOTS, ( NADataDefIterFunc ) define_slots_iter, NULL );
+
 	/* define class properties
 	 */
 	iter_on_data_defs( groups, DATA_DEF_ITER_SET_PROPERTIES, ( NADataDefIterFunc ) define_class_properties_iter, class );
 }
 
+static gboolean
+define_slots_iter( NADataDef *def, void *empty )
+{
+	guint slot;
+
+	if( !g_hash_table_lookup( st_def_slots, def )){
+		slot = get_slot( def->name );
+
+		if( !slot ){
+			st_slots_count += 1;
+			slot = st_slots_count;
+			g_hash_table_insert( st_slots, def->name, GUINT_TO_POINTER( slot ));
+		}
+
+		g_hash_table_insert( st_def_slots, def, GUINT_TO_POINTER( slot ));
+	}
+
+	/* do not stop */
+	return( FALSE );
+}
+
 static gboolean
 define_class_properties_iter( const NADataDef *def, GObjectClass *class )
 {
@@ -191,6 +264,21 @@ na_factory_object_get_data_def( const NAIFactoryObject *object, const gchar *nam
 	return( def );
 }
 
+/*
+ * na_factory_object_get_data_boxed:
+ * @object: this #NAIFactoryObject object.
+ * @name: the searched name.
+ *
+ * Returns: the #NADataBoxed which holds the @name data, or %NULL.
+ */
+NADataBoxed *
+na_factory_object_get_data_boxed( const NAIFactoryObject *object, const gchar *name )
+{
+	g_return_val_if_fail( NA_IS_IFACTORY_OBJECT( object ), NULL );
+
+	return( get_data_boxed( object, get_slot( name )));
+}
+
 /*
  * na_factory_object_get_data_groups:
  * @object: the #NAIFactoryObject instance.
@@ -222,17 +310,19 @@ na_factory_object_get_data_groups( const NAIFactoryObject *object )
 void
 na_factory_object_iter_on_boxed( const NAIFactoryObject *object, NAFactoryObjectIterBoxedFn pfn, void *user_data )
 {
-	GList *list, *ibox;
+	NafoData *data;
 	gboolean stop;
+	guint i;
 
 	g_return_if_fail( NA_IS_IFACTORY_OBJECT( object ));
 
-	list = g_object_get_data( G_OBJECT( object ), NA_IFACTORY_OBJECT_PROP_DATA );
-	/*g_debug( "list=%p (count=%u)", ( void * ) list, g_list_length( list ));*/
+	data = get_data( object );
 	stop = FALSE;
 
-	for( ibox = list ; ibox && !stop ; ibox = ibox->next ){
-		stop = ( *pfn )( object, NA_DATA_BOXED( ibox->data ), user_data );
+	for( i = 0 ; data && i < data->count && !stop ; ++i ){
+		if( data->slots[i] ){
+			stop = ( *pfn )( object, data->slots[i], user_data );
+		}
 	}
 }
 
@@ -305,7 +395,7 @@ na_factory_object_set_defaults( NAIFactoryObject *object )
 static gboolean
 set_defaults_iter( NADataDef *def, NafoDefaultIter *data )
 {
-	NADataBoxed *boxed = na_ifactory_object_get_data_boxed( data->object, def->name );
+	NADataBoxed *boxed = get_data_boxed( data->object, get_def_slot( def ));
 
 	if( !boxed ){
 		boxed = na_data_boxed_new( def );
@@ -332,17 +422,25 @@ na_factory_object_move_boxed( NAIFactoryObject *target, const NAIFactoryObject *
 	g_return_if_fail( NA_IS_IFACTORY_OBJECT( target ));
 	g_return_if_fail( NA_IS_IFACTORY_OBJECT( source ));
 
-	GList *src_list = g_object_get_data( G_OBJECT( source ), NA_IFACTORY_OBJECT_PROP_DATA );
-
-	if( g_list_find( src_list, boxed )){
-		src_list = g_list_remove( src_list, boxed );
-		g_object_set_data( G_OBJECT( source ), NA_IFACTORY_OBJECT_PROP_DATA, src_list );
+	const NADataDef *src_def = na_data_boxed_get_data_def( boxed );
 
-		attach_boxed_to_object( target, boxed );
+	if( get_data_boxed( source, get_def_slot( src_def )) == boxed ){
+		detach_boxed_from_object( source, boxed );
 
-		const NADataDef *src_def = na_data_boxed_get_data_def( boxed );
 		NADataDef *tgt_def = na_factory_object_get_data_def( target, src_def->name );
-		na_data_boxed_set_data_def( boxed, tgt_def );
+		if( tgt_def && tgt_def != src_def ){
+			if( na_data_boxed_is_shared( boxed )){
+				NADataBoxed *moved = na_data_boxed_new( tgt_def );
+				na_boxed_set_from_boxed( NA_BOXED( moved ), NA_BOXED( boxed ));
+				na_data_boxed_unref( boxed );
+				boxed = moved;
+
+			} else {
+				na_data_boxed_set_data_def( boxed, tgt_def );
+			}
+		}
+
+		attach_boxed_to_object( target, boxed );
 	}
 }
 
@@ -353,16 +451,20 @@ na_factory_object_move_boxed( NAIFactoryObject *target, const NAIFactoryObject *
  *
  * Copies one instance to another.
  * Takes care of not overriding provider data.
+ *
+ * The #NADataBoxed of @source are not copied, but shared with @target:
+ * the first of the two objects which sets a data will allocate its own
+ * #NADataBoxed for it (see get_writable_boxed()).
  */
 void
 na_factory_object_copy( NAIFactoryObject *target, const NAIFactoryObject *source )
 {
 	static const gchar *thisfn = "na_factory_object_copy";
-	GList *dest_list, *idest, *inext;
-	GList *src_list, *isrc;
+	NafoData *dest_data, *src_data;
 	NADataBoxed *boxed;
 	const NADataDef *def;
 	void *provider, *provider_data;
+	guint i;
 
 	g_return_if_fail( NA_IS_IFACTORY_OBJECT( target ));
 	g_return_if_fail( NA_IS_IFACTORY_OBJECT( source ));
@@ -377,32 +479,28 @@ na_factory_object_copy( NAIFactoryObject *target, const NAIFactoryObject *source
 	provider = na_object_get_provider( target );
 	provider_data = na_object_get_provider_data( target );
 
-	idest = dest_list = g_object_get_data( G_OBJECT( target ), NA_IFACTORY_OBJECT_PROP_DATA );
-	while( idest ){
-		boxed = NA_DATA_BOXED( idest->data );
-		inext = idest->next;
-		def = na_data_boxed_get_data_def( boxed );
-		if( def->copyable ){
-			dest_list = g_list_remove_link( dest_list, idest );
-			g_object_unref( idest->data );
+	dest_data = get_data( target );
+	for( i = 0 ; dest_data && i < dest_data->count ; ++i ){
+		boxed = dest_data->slots[i];
+		if( boxed ){
+			def = na_data_boxed_get_data_def( boxed );
+			if( def->copyable ){
+				detach_boxed_from_object( target, boxed );
+				na_data_boxed_unref( boxed );
+			}
 		}
-		idest = inext;
 	}
-	g_object_set_data( G_OBJECT( target ), NA_IFACTORY_OBJECT_PROP_DATA, dest_list );
 
 	/* only then copy copyable data from source
 	 */
-	src_list = g_object_get_data( G_OBJECT( source ), NA_IFACTORY_OBJECT_PROP_DATA );
-	for( isrc = src_list ; isrc ; isrc = isrc->next ){
-		boxed = NA_DATA_BOXED( isrc->data );
-		def = na_data_boxed_get_data_def( boxed );
-		if( def->copyable ){
-			NADataBoxed *tgt_boxed = na_ifactory_object_get_data_boxed( target, def->name );
-			if( !tgt_boxed ){
-				tgt_boxed = na_data_boxed_new( def );
-				attach_boxed_to_object( target, tgt_boxed );
+	src_data = get_data( source );
+	for( i = 0 ; src_data && i < src_data->count ; ++i ){
+		boxed = src_data->slots[i];
+		if( boxed ){
+			def = na_data_boxed_get_data_def( boxed );
+			if( def->copyable ){
+				attach_boxed_to_object( target, na_data_boxed_ref( boxed ));
 			}
-			na_boxed_set_from_boxed( NA_BOXED( tgt_boxed ), NA_BOXED( boxed ));
 		}
 	}
 
@@ -428,23 +526,35 @@ na_factory_object_are_equal( const NAIFactoryObject *a, const NAIFactoryObject *
 {
 	static const gchar *thisfn = "na_factory_object_are_equal";
 	gboolean are_equal;
-	GList *a_list, *b_list, *ia, *ib;
+	NafoData *a_data, *b_data;
+	guint i;
 
 	are_equal = FALSE;
 
-	a_list = g_object_get_data( G_OBJECT( a ), NA_IFACTORY_OBJECT_PROP_DATA );
-	b_list = g_object_get_data( G_OBJECT( b ), NA_IFACTORY_OBJECT_PROP_DATA );
+	a_data = get_data( a );
+	b_data = get_data( b );
 
 	g_debug( "%s: a=%p, b=%p", thisfn, ( void * ) a, ( void * ) b );
 
+	/* equal objects have the same content hash: only have to compare
+	 * the data one by one when the hashes are the same
+	 */
+	if( a_data && b_data && get_content_hash( a_data ) != get_content_hash( b_data )){
+		g_debug( "%s: %s not equal as content hashes are different", thisfn, G_OBJECT_TYPE_NAME( a ));
+		return( FALSE );
+	}
+
 	are_equal = TRUE;
-	for( ia = a_list ; ia && are_equal ; ia = ia->next ){
+	for( i = 0 ; a_data && i < a_data->count && are_equal ; ++i ){
 
-		NADataBoxed *a_boxed = NA_DATA_BOXED( ia->data );
+		NADataBoxed *a_boxed = a_data->slots[i];
+		if( !a_boxed ){
+			continue;
+		}
 		const NADataDef *a_def = na_data_boxed_get_data_def( a_boxed );
 		if( a_def->comparable ){
 
-			NADataBoxed *b_boxed = na_ifactory_object_get_data_boxed( b, a_def->name );
+			NADataBoxed *b_boxed = get_data_boxed( b, get_def_slot( a_def ));
 			if( b_boxed ){
 				are_equal = na_boxed_are_equal( NA_BOXED( a_boxed ), NA_BOXED( b_boxed ));
 				if( !are_equal ){
@@ -458,13 +568,16 @@ na_factory_object_are_equal( const NAIFactoryObject *a, const NAIFactoryObject *
 		}
 	}
 
-	for( ib = b_list ; ib && are_equal ; ib = ib->next ){
+	for( i = 0 ; b_data && i < b_data->count && are_equal ; ++i ){
 
-		NADataBoxed *b_boxed = NA_DATA_BOXED( ib->data );
+		NADataBoxed *b_boxed = b_data->slots[i];
+		if( !b_boxed ){
+			continue;
+		}
 		const NADataDef *b_def = na_data_boxed_get_data_def( b_boxed );
 		if( b_def->comparable ){
 
-			NADataBoxed *a_boxed = na_ifactory_object_get_data_boxed( a, b_def->name );
+			NADataBoxed *a_boxed = get_data_boxed( a, get_def_slot( b_def ));
 			if( !a_boxed ){
 				are_equal = FALSE;
 				g_debug( "%s: %s not equal as %s was not set", thisfn, G_OBJECT_TYPE_NAME( a ), b_def->name );
@@ -489,13 +602,14 @@ na_factory_object_is_valid( const NAIFactoryObject *object )
 	static const gchar *thisfn = "na_factory_object_is_valid";
 	gboolean is_valid;
 	NADataGroup *groups;
-	GList *list, *iv;
+	NafoData *data;
+	guint i;
 
 	g_return_val_if_fail( NA_IS_IFACTORY_OBJECT( object ), FALSE );
 
 	g_debug( "%s: object=%p (%s)", thisfn, ( void * ) object, G_OBJECT_TYPE_NAME( object ));
 
-	list = g_object_get_data( G_OBJECT( object ), NA_IFACTORY_OBJECT_PROP_DATA );
+	data = get_data( object );
 	is_valid = TRUE;
 
 	/* mandatory data must be set
@@ -510,8 +624,10 @@ na_factory_object_is_valid( const NAIFactoryObject *object )
 	}
 	is_valid = iter_data.is_valid;
 
-	for( iv = list ; iv && is_valid ; iv = iv->next ){
-		is_valid = na_data_boxed_is_valid( NA_DATA_BOXED( iv->data ));
+	for( i = 0 ; data && i < data->count && is_valid ; ++i ){
+		if( data->slots[i] ){
+			is_valid = na_data_boxed_is_valid( data->slots[i] );
+		}
 	}
 
 	is_valid &= v_is_valid( object );
@@ -525,7 +641,7 @@ is_valid_mandatory_iter( const NADataDef *def, NafoValidIter *data )
 	NADataBoxed *boxed;
 
 	if( def->mandatory ){
-		boxed = na_ifactory_object_get_data_boxed( data->object, def->name );
+		boxed = get_data_boxed( data->object, get_def_slot( def ));
 		if( !boxed ){
 			g_debug( "na_factory_object_is_valid_mandatory_iter: invalid %s: mandatory but not set", def->name );
 			data->is_valid = FALSE;
@@ -547,25 +663,34 @@ na_factory_object_dump( const NAIFactoryObject *object )
 {
 	static const gchar *thisfn = "na_factory_object_dump";
 	static const gchar *prefix = "na-factory-data-";
-	GList *list, *it;
+	NafoData *data;
 	guint length;
 	guint l_prefix;
+	guint i;
 
 	length = 0;
 	l_prefix = strlen( prefix );
-	list = g_object_get_data( G_OBJECT( object ), NA_IFACTORY_OBJECT_PROP_DATA );
+	data = get_data( object );
 
-	for( it = list ; it ; it = it->next ){
-		NADataBoxed *boxed = NA_DATA_BOXED( it->data );
-		const NADataDef *def = na_data_boxed_get_data_def( boxed );
-		length = MAX( length, strlen( def->name ));
+	if( !data ){
+		return;
+	}
+
+	for( i = 0 ; i < data->count ; ++i ){
+		if( data->slots[i] ){
+			const NADataDef *def = na_data_boxed_get_data_def( data->slots[i] );
+			length = MAX( length, strlen( def->name ));
+		}
 	}
 
 	length -= l_prefix;
 	length += 1;
 
-	for( it = list ; it ; it = it->next ){
-		NADataBoxed *boxed = NA_DATA_BOXED( it->data );
+	for( i = 0 ; i < data->count ; ++i ){
+		NADataBoxed *boxed = data->slots[i];
+		if( !boxed ){
+			continue;
+		}
 		const NADataDef *def = na_data_boxed_get_data_def( boxed );
 		gchar *value = na_boxed_get_string( NA_BOXED( boxed ));
 		g_debug( "| %s: %*s=%s", thisfn, length, def->name+l_prefix, value );
@@ -636,11 +761,13 @@ read_data_iter( NADataDef *def, NafoReadIter *iter )
 	NADataBoxed *boxed = na_factory_provider_read_data( iter->reader, iter->reader_data, iter->object, def, iter->messages );
 
 	if( boxed ){
-		NADataBoxed *exist = na_ifactory_object_get_data_boxed( iter->object, def->name );
+		NADataBoxed *exist = get_data_boxed( iter->object, get_def_slot( def ));
 
 		if( exist ){
+			exist = get_writable_boxed( iter->object, exist );
 			na_boxed_set_from_boxed( NA_BOXED( exist ), NA_BOXED( boxed ));
-			g_object_unref( boxed );
+			slot_changed( iter->object, exist );
+			na_data_boxed_unref( boxed );
 
 		} else {
 			attach_boxed_to_object( iter->object, boxed );
@@ -741,7 +868,7 @@ na_factory_object_get_as_value( const NAIFactoryObject *object, const gchar *nam
 
 	g_value_unset( value );
 
-	boxed = na_ifactory_object_get_data_boxed( object, name );
+	boxed = na_factory_object_get_data_boxed( object, name );
 	if( boxed ){
 		na_boxed_get_as_value( NA_BOXED( boxed ), value );
 	}
@@ -769,7 +896,7 @@ na_factory_object_get_as_void( const NAIFactoryObject *object, const gchar *name
 
 	value = NULL;
 
-	boxed = na_ifactory_object_get_data_boxed( object, name );
+	boxed = na_factory_object_get_data_boxed( object, name );
 	if( boxed ){
 		value = na_boxed_get_as_void( NA_BOXED( boxed ));
 	}
@@ -777,6 +904,32 @@ na_factory_object_get_as_void( const NAIFactoryObject *object, const gchar *name
 	return( value );
 }
 
+/*
+ * na_factory_object_peek_as_void:
+ * @object: this #NAIFactoryObject instance.
+ * @name: the elementary data whose value is to be got.
+ *
+ * Returns: the searched value, which is owned by the @object, and should
+ * not be released by the caller.
+ */
+const void *
+na_factory_object_peek_as_void( const NAIFactoryObject *object, const gchar *name )
+{
+	const void *value;
+	NADataBoxed *boxed;
+
+	g_return_val_if_fail( NA_IS_IFACTORY_OBJECT( object ), NULL );
+
+	value = NULL;
+
+	boxed = na_factory_object_get_data_boxed( object, name );
+	if( boxed ){
+		value = na_boxed_get_pointer( NA_BOXED( boxed ));
+	}
+
+	return( value );
+}
+
 /*
  * na_factory_object_is_set:
  * @object: this #NAIFactoryObject instance.
@@ -791,7 +944,7 @@ na_factory_object_is_set( const NAIFactoryObject *object, const gchar *name )
 
 	g_return_val_if_fail( NA_IS_IFACTORY_OBJECT( object ), FALSE );
 
-	boxed = na_ifactory_object_get_data_boxed( object, name );
+	boxed = na_factory_object_get_data_boxed( object, name );
 
 	return( boxed != NULL );
 }
@@ -812,9 +965,11 @@ na_factory_object_set_from_value( NAIFactoryObject *object, const gchar *name, c
 
 	g_return_if_fail( NA_IS_IFACTORY_OBJECT( object ));
 
-	NADataBoxed *boxed = na_ifactory_object_get_data_boxed( object, name );
+	NADataBoxed *boxed = na_factory_object_get_data_boxed( object, name );
 	if( boxed ){
+		boxed = get_writable_boxed( object, boxed );
 		na_boxed_set_from_value( NA_BOXED( boxed ), value );
+		slot_changed( object, boxed );
 
 	} else {
 		NADataDef *def = na_factory_object_get_data_def( object, name );
@@ -827,6 +982,7 @@ na_factory_object_set_from_value( NAIFactoryObject *object, const gchar *name, c
 			attach_boxed_to_object( object, boxed );
 		}
 	}
+	data_changed( object, name );
 }
 
 /*
@@ -844,9 +1000,11 @@ na_factory_object_set_from_void( NAIFactoryObject *object, const gchar *name, co
 
 	g_return_if_fail( NA_IS_IFACTORY_OBJECT( object ));
 
-	NADataBoxed *boxed = na_ifactory_object_get_data_boxed( object, name );
+	NADataBoxed *boxed = na_factory_object_get_data_boxed( object, name );
 	if( boxed ){
+		boxed = get_writable_boxed( object, boxed );
 		na_boxed_set_from_void( NA_BOXED( boxed ), data );
+		slot_changed( object, boxed );
 
 	} else {
 		NADataDef *def = na_factory_object_get_data_def( object, name );
@@ -859,6 +1017,7 @@ na_factory_object_set_from_void( NAIFactoryObject *object, const gchar *name, co
 			attach_boxed_to_object( object, boxed );
 		}
 	}
+	data_changed( object, name );
 }
 
 static NADataGroup *
@@ -939,25 +1098,229 @@ v_write_done( NAIFactoryObject *serializable, const NAIFactoryProvider *writer,
 	return( code );
 }
 
+static NafoData *
+get_data( const NAIFactoryObject *object )
+{
+	return( g_object_get_qdata( G_OBJECT( object ), st_data_quark ));
+}
+
+static NADataBoxed *
+get_data_boxed( const NAIFactoryObject *object, guint slot )
+{
+	NafoData *data;
+
+	data = get_data( object );
+
+	if( data && slot && slot <= data->count ){
+		return( data->slots[slot-1] );
+	}
+
+	return( NULL );
+}
+
+/*
+ * Returns: the slot allocated to the @name data, or zero
+ */
+static guint
+get_slot( const gchar *name )
+{
+	if( !st_slots ){
+		return( 0 );
+	}
+
+	return( GPOINTER_TO_UINT( g_hash_table_lookup( st_slots, name )));
+}
+
+/*
+ * Returns: the slot allocated to the @def data, or zero
+ *
+ * a definition which has not been seen when initializing the classes
+ * shares the slot of the data of the same name, if any
+ */
+static guint
+get_def_slot( const NADataDef *def )
+{
+	guint slot;
+
+	if( !st_def_slots ){
+		return( 0 );
+	}
+
+	slot = GPOINTER_TO_UINT( g_hash_table_lookup( st_def_slots, def ));
+
+	return( slot ? slot : get_slot( def->name ));
+}
+
+/*
+ * the array is allocated with the count of slots known at this time,
+ * and grows if a class has been initialized since
+ */
 static void
 attach_boxed_to_object( NAIFactoryObject *object, NADataBoxed *boxed )
 {
-	GList *list = g_object_get_data( G_OBJECT( object ), NA_IFACTORY_OBJECT_PROP_DATA );
-	list = g_list_prepend( list, boxed );
-	g_object_set_data( G_OBJECT( object ), NA_IFACTORY_OBJECT_PROP_DATA, list );
+	static const gchar *thisfn = "na_factory_object_attach_boxed_to_object";
+	const NADataDef *def;
+	NafoData *data;
+	guint slot;
+
+	def = na_data_boxed_get_data_def( boxed );
+	slot = get_def_slot( def );
+
+	if( !slot ){
+		g_warning( "%s: %s: no slot allocated", thisfn, def->name );
+		na_data_boxed_unref( boxed );
+		return;
+	}
+
+	data = get_data( object );
+
+	if( !data ){
+		data = g_new0( NafoData, 1 );
+		g_object_set_qdata( G_OBJECT( object ), st_data_quark, data );
+	}
+
+	if( slot > data->count ){
+		data->slots = g_renew( NADataBoxed *, data->slots, st_slots_count );
+		memset( data->slots+data->count, '\0', ( st_slots_count-data->count )*sizeof( NADataBoxed * ));
+		data->hashes = g_renew( guint, data->hashes, st_slots_count );
+		memset( data->hashes+data->count, '\0', ( st_slots_count-data->count )*sizeof( guint ));
+		data->hashed = g_renew( guint8, data->hashed, st_slots_count );
+		memset( data->hashed+data->count, '\0', ( st_slots_count-data->count )*sizeof( guint8 ));
+		data->count = st_slots_count;
+	}
+
+	if( data->slots[slot-1] && data->slots[slot-1] != boxed ){
+		na_data_boxed_unref( data->slots[slot-1] );
+	}
+
+	data->slots[slot-1] = boxed;
+	invalidate_hash( data, slot );
+}
+
+static void
+detach_boxed_from_object( const NAIFactoryObject *object, NADataBoxed *boxed )
+{
+	NafoData *data;
+	guint slot;
+
+	data = get_data( object );
+	slot = get_def_slot( na_data_boxed_get_data_def( boxed ));
+
+	if( data && slot && slot <= data->count && data->slots[slot-1] == boxed ){
+		data->slots[slot-1] = NULL;
+		invalidate_hash( data, slot );
+	}
+}
+
+/*
+ * a NADataBoxed may be shared with a copy of the object (see
+ * na_factory_object_copy()), and must not be modified in this case:
+ * it is then replaced in the slot with a new NADataBoxed of the same
+ * definition, and the caller is expected to set the value right after
+ */
+static NADataBoxed *
+get_writable_boxed( NAIFactoryObject *object, NADataBoxed *boxed )
+{
+	NADataBoxed *writable;
+
+	if( !na_data_boxed_is_shared( boxed )){
+		return( boxed );
+	}
+
+	writable = na_data_boxed_new( na_data_boxed_get_data_def( boxed ));
+	attach_boxed_to_object( object, writable );
+
+	return( writable );
+}
+
+/*
+ * the hash of each slot is computed here if it is not yet known
+ */
+static guint
+get_content_hash( NafoData *data )
+{
+	NADataBoxed *boxed;
+	guint i, hash;
+
+	for( i = 0 ; i < data->count ; ++i ){
+		if( !data->hashed[i] ){
+			hash = 0;
+			boxed = data->slots[i];
+			if( boxed && na_data_boxed_get_data_def( boxed )->comparable ){
+				hash = ( na_boxed_hash( NA_BOXED( boxed )) ^ ( i+1 )) * 2654435761U;
+			}
+			data->hashes[i] = hash;
+			data->hashed[i] = TRUE;
+			data->hash += hash;
+		}
+	}
+
+	return( data->hash );
+}
+
+/*
+ * remove the hash of the slot from the content hash, as the data of the
+ * slot is about to change, or has just changed
+ */
+static void
+invalidate_hash( NafoData *data, guint slot )
+{
+	if( data->hashed[slot-1] ){
+		data->hash -= data->hashes[slot-1];
+		data->hashed[slot-1] = FALSE;
+	}
+}
+
+/*
+ * the value of the @boxed has been set in place
+ */
+static void
+slot_changed( const NAIFactoryObject *object, const NADataBoxed *boxed )
+{
+	NafoData *data;
+	guint slot;
+
+	data = get_data( object );
+	slot = get_def_slot( na_data_boxed_get_data_def( boxed ));
+
+	if( data && slot && slot <= data->count && data->slots[slot-1] == boxed ){
+		invalidate_hash( data, slot );
+	}
+}
+
+/*
+ * some interfaces maintain their own view of the object data,
+ * and so must be warned when these data are modified
+ */
+static void
+data_changed( NAIFactoryObject *object, const gchar *name )
+{
+	if( NA_IS_ICONTEXT( object )){
+		na_icontext_data_changed( NA_ICONTEXT( object ), name );
+	}
 }
 
 static void
 free_data_boxed_list( NAIFactoryObject *object )
 {
-	GList *list;
+	NafoData *data;
+	guint i;
 
-	list = g_object_get_data( G_OBJECT( object ), NA_IFACTORY_OBJECT_PROP_DATA );
+	data = get_data( object );
 
-	g_list_foreach( list, ( GFunc ) g_object_unref, NULL );
-	g_list_free( list );
+	if( data ){
+		for( i = 0 ; i < data->count ; ++i ){
+			if( data->slots[i] ){
+				na_data_boxed_unref( data->slots[i] );
+			}
+		}
+		g_free( data->slots );
+		g_free( data->hashes );
+		g_free( data->hashed );
+		g_free( data );
 
-	g_object_set_data( G_OBJECT( object ), NA_IFACTORY_OBJECT_PROP_DATA, NULL );
+		g_object_set_qdata( G_OBJECT( object ), st_data_quark, NULL );
+	}
 }
 
 /*
@@ -983,6 +1346,10 @@ iter_on_data_defs( const NADataGroup *groups, guint mode, NADataDefIterFunc pfn,
 						serializable_only ? "True":"False", def->serializable ? "True":"False" );*/
 
 				switch( mode ){
+					case DATA_DEF_ITER_SET_SLOTS:
+						stop = ( *pfn )( def, user_data );
+						break;
+
 					case DATA_DEF_ITER_SET_PROPERTIES:
 						if( def->has_property ){
 							stop = ( *pfn )( def, user_data );
@@ -48,6 +48,7 @@ typedef gboolean ( *NAFactoryObjectIterBoxedFn )( const NAIFactoryObject *object
 
 void         na_factory_object_define_properties( GObjectClass *class, const NADataGroup *groups );
 NADataDef   *na_factory_object_get_data_def     ( const NAIFactoryObject *object, const gchar *name );
+NADataBoxed *na_factory_object_get_data_boxed   ( const NAIFactoryObject *object, const gchar *name );
 NADataGroup *na_factory_object_get_data_groups  ( const NAIFactoryObject *object );
 void         na_factory_object_iter_on_boxed    ( const NAIFactoryObject *object, NAFactoryObjectIterBoxedFn pfn, void *user_data );
 
@@ -66,6 +67,7 @@ void         na_factory_object_read_item        ( NAIFactoryObject *object, cons
 guint        na_factory_object_write_item       ( NAIFactoryObject *object, const NAIFactoryProvider *writer, void *writer_data, GSList **messages );
 
 void        *na_factory_object_get_as_void      ( const NAIFactoryObject *object, const gchar *name );
+const void  *na_factory_object_peek_as_void     ( const NAIFactoryObject *object, const gchar *name );
 void         na_factory_object_get_as_value     ( const NAIFactoryObject *object, const gchar *name, GValue *value );
 gboolean     na_factory_object_is_set           ( const NAIFactoryObject *object, const gchar *name );
 
@@ -31,19 +31,11 @@
 #include <config.h>
 #endif
 
-#ifdef HAVE_GDBUS
 #include <gio/gio.h>
-#else
-# ifdef HAVE_DBUS_GLIB
-#include <dbus/dbus-glib.h>
-# endif
-#endif
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
-#include <glibtop/proclist.h>
-#include <glibtop/procstate.h>
 
 #include <libnautilus-extension/nautilus-file-info.h>
 
@@ -51,6 +43,7 @@
 #include <api/na-object-api.h>
 
 #include "na-desktop-environment.h"
+#include "na-dynamic-condition.h"
 #include "na-gnome-vfs-uri.h"
 #include "na-selected-info.h"
 #include "na-settings.h"
@@ -67,31 +60,220 @@ static GType        register_type( void );
 static void         interface_base_init( NAIContextInterface *klass );
 static void         interface_base_finalize( NAIContextInterface *klass );
 
-static gboolean     v_is_candidate( NAIContext *object, guint target, GList *selection );
-
-static gboolean     is_candidate_for_target( const NAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_show_in( const NAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_try_exec( const NAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_show_if_registered( const NAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_show_if_true( const NAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_show_if_running( const NAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_mimetypes( const NAIContext *object, guint target, GList *files );
-static gboolean     is_all_mimetype( const gchar *mimetype );
-static gboolean     is_file_mimetype( const gchar *mimetype );
-static gboolean     is_mimetype_of( const gchar *file_type, const gchar *ftype, gboolean is_regular );
-static gboolean     is_candidate_for_basenames( const NAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_selection_count( const NAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_schemes( const NAIContext *object, guint target, GList *files );
-static gboolean     is_compatible_scheme( const gchar *pattern, const gchar *scheme );
-static gboolean     is_candidate_for_folders( const NAIContext *object, guint target, GList *files );
-static gboolean     is_candidate_for_capabilities( const NAIContext *object, guint target, GList *files );
-
-static gboolean     is_valid_basenames( const NAIContext *object );
-static gboolean     is_valid_mimetypes( const NAIContext *object );
-static gboolean     is_valid_schemes( const NAIContext *object );
-static gboolean     is_valid_folders( const NAIContext *object );
-
-static gboolean     is_positive_assertion( const gchar *assertion );
+/* a condition pattern, as compiled when the context is read
+ */
+typedef struct {
+	gchar        *pattern;				/* without its '!' negation prefix */
+	gchar        *content_type;			/* mimetypes */
+	guint         kind;					/* mimetypes */
+	GPatternSpec *spec;					/* basenames and folders */
+}
+	ContextPattern;
+
+/* mimetype patterns are classified when compiled
+ */
+enum {
+	MIMETYPE_KIND_TYPE = 0,				/* a real mimetype, maybe with a '*' subgroup */
+	MIMETYPE_KIND_ALL,					/* any mimetype */
+	MIMETYPE_KIND_FILES					/* any regular file */
+};
+
+/* Capabilities are compiled as a bit field
+ */
+enum {
+	CAP_OWNER      = 1 << 0,
+	CAP_READABLE   = 1 << 1,
+	CAP_WRITABLE   = 1 << 2,
+	CAP_EXECUTABLE = 1 << 3,
+	CAP_LOCAL      = 1 << 4,
+	CAP_UNKNOWN    = 1 << 5
+};
+
+/* SelectionCount operator
+ */
+enum {
+	COUNT_NONE = 0,
+	COUNT_LESS,
+	COUNT_EQUAL,
+	COUNT_GREATER,
+	COUNT_INVALID
+};
+
+/* the data structure set on each NAIContext object
+ *
+ * this is a compiled, read-only, form of the conditions, built once
+ * when the object has been read, and only rebuilt after one of the
+ * relevant data has been modified; it is shared between an object and
+ * its duplicates
+ */
+typedef struct {
+	gint      ref_count;
+	gboolean  is_action;
+	gboolean  target_location;
+	gboolean  target_selection;
+	gboolean  target_toolbar;
+	GSList   *only_show_in;
+	GSList   *not_show_in;
+	gchar    *try_exec;
+	gchar    *show_if_registered;
+	gchar    *show_if_true;
+	gchar    *show_if_running;
+	gboolean  all_mimetypes;
+	gboolean  mimetypes_regular;		/* whether the file type is relevant */
+	GSList   *mimetypes_pos;			/* list of ContextPattern */
+	GSList   *mimetypes_neg;
+	gboolean  all_basenames;
+	gboolean  matchcase;
+	GSList   *basenames_pos;			/* list of ContextPattern */
+	GSList   *basenames_neg;
+	guint     count_op;
+	gint      count_limit;
+	gboolean  all_schemes;
+	GSList   *schemes_pos;				/* list of strings */
+	GSList   *schemes_neg;
+	gboolean  all_folders;
+	GSList   *folders_pos;				/* list of ContextPattern */
+	GSList   *folders_neg;
+	guint     caps_pos;
+	guint     caps_neg;
+}
+	ContextMatcher;
+
+#define NA_ICONTEXT_DATA_MATCHER			"na-icontext-data-matcher"
+
+/* the selection, as grouped in equivalence classes for the per-file
+ * conditions: each per-file condition is so evaluated once per distinct
+ * class, instead of once per selected item
+ *
+ * each grouping is only computed the first time a condition needs it;
+ * when the caller brackets its candidacy checks between
+ * na_icontext_begin_selection() and na_icontext_end_selection(), the
+ * classes are shared by all the examined contexts
+ *
+ * the mimetypes, schemes and dirnames of the selected items are interned
+ * strings, so that the distinct values are found by comparing pointers
+ */
+typedef struct {
+	GList      *selection;
+	guint       count;
+	GHashTable *mimetypes;				/* interned mimetype -> MimetypeClass */
+	gchar      *null_mimetype_uri;		/* the first item without mimetype */
+	GHashTable *basenames;				/* set of UTF-8 basenames */
+	GHashTable *basenames_down;			/* set of lowercased UTF-8 basenames */
+	GHashTable *schemes;				/* set of interned schemes */
+	GHashTable *dirnames;				/* interned dirname -> UTF-8 dirname */
+	GHashTable *capabilities;			/* set of 1+capabilities bit fields */
+	gboolean    unresolved;				/* whether some attributes are unresolved */
+}
+	SelectionClasses;
+
+typedef struct {
+	GList    *files;					/* the NASelectedInfo's of the class */
+	gboolean  regular_done;
+	gboolean  has_regular;
+	gboolean  has_other;
+}
+	MimetypeClass;
+
+static SelectionClasses *st_classes = NULL;
+
+/* the process-wide memo of the mimetype subsumption results
+ *
+ * file mimetype -> ( pattern -> result )
+ * the results are stored as GUINT_TO_POINTER( 1+is_type_of ) so that a
+ * not found result can be distinguished from a FALSE one
+ *
+ * the memo is cleared when the shared-mime-info database changes, and
+ * when it grows beyond a maximal count of results
+ */
+static GHashTable *st_mimetype_memo       = NULL;
+static guint       st_mimetype_memo_count = 0;
+static guint       st_mimetype_memo_max   = 8192;
+static GList      *st_mimetype_monitors   = NULL;
+
+/* the elementary data the ContextMatcher is built from
+ */
+static const gchar *st_matcher_data[] = {
+	NAFO_DATA_TARGET_SELECTION,
+	NAFO_DATA_TARGET_LOCATION,
+	NAFO_DATA_TARGET_TOOLBAR,
+	NAFO_DATA_BASENAMES,
+	NAFO_DATA_MATCHCASE,
+	NAFO_DATA_MIMETYPES,
+	NAFO_DATA_MIMETYPES_IS_ALL,
+	NAFO_DATA_SCHEMES,
+	NAFO_DATA_FOLDERS,
+	NAFO_DATA_SELECTION_COUNT,
+	NAFO_DATA_ONLY_SHOW,
+	NAFO_DATA_NOT_SHOW,
+	NAFO_DATA_TRY_EXEC,
+	NAFO_DATA_SHOW_IF_REGISTERED,
+	NAFO_DATA_SHOW_IF_TRUE,
+	NAFO_DATA_SHOW_IF_RUNNING,
+	NAFO_DATA_CAPABILITITES,
+	NULL
+};
+
+static gboolean        v_is_candidate( NAIContext *object, guint target, GList *selection );
+
+static gboolean        is_candidate_but_dynamic( const NAIContext *context, const ContextMatcher *matcher, guint target, GList *files, SelectionClasses *classes );
+
+static gboolean        is_candidate_for_target( const ContextMatcher *matcher, guint target, GList *files );
+static gboolean        is_candidate_for_show_in( const ContextMatcher *matcher, guint target, GList *files );
+static gboolean        is_candidate_for_try_exec( const ContextMatcher *matcher, guint target, GList *files );
+static gboolean        is_candidate_for_show_if_registered( const ContextMatcher *matcher, guint target, GList *files );
+static gboolean        is_candidate_for_show_if_true( const ContextMatcher *matcher, guint target, GList *files );
+static gboolean        is_candidate_for_show_if_running( const ContextMatcher *matcher, guint target, GList *files );
+static gboolean        is_candidate_for_mimetypes( const ContextMatcher *matcher, guint target, SelectionClasses *classes );
+static gboolean        is_mimetype_candidate( const ContextMatcher *matcher, const gchar *ftype, gboolean regular );
+static gboolean        is_all_mimetype( const gchar *mimetype );
+static gboolean        is_file_mimetype( const gchar *mimetype );
+static guint           get_mimetype_kind( const gchar *mimetype );
+static gboolean        is_mimetype_of( const ContextPattern *pattern, const gchar *ftype, gboolean is_regular );
+static gboolean        mimetype_memo_is_a( const gchar *ftype, const ContextPattern *pattern );
+static void            mimetype_memo_init( void );
+static void            mimetype_memo_monitor( const gchar *data_dir );
+static void            on_mime_database_changed( GFileMonitor *monitor, GFile *file, GFile *other, GFileMonitorEvent event, void *empty );
+static gboolean        is_candidate_for_basenames( const ContextMatcher *matcher, guint target, SelectionClasses *classes );
+static gboolean        is_candidate_for_selection_count( const ContextMatcher *matcher, guint target, SelectionClasses *classes );
+static gboolean        is_candidate_for_schemes( const ContextMatcher *matcher, guint target, SelectionClasses *classes );
+static gboolean        is_compatible_scheme( const gchar *pattern, const gchar *scheme );
+static gboolean        is_candidate_for_folders( const ContextMatcher *matcher, guint target, SelectionClasses *classes );
+static gboolean        is_candidate_for_capabilities( const ContextMatcher *matcher, guint target, SelectionClasses *classes );
+static gboolean        is_capable( const NASelectedInfo *nsi, guint capability );
+
+static SelectionClasses *classes_get( GList *selection, gboolean *allocated );
+static SelectionClasses *classes_new( GList *selection );
+static void              classes_free( SelectionClasses *classes );
+static GHashTable       *classes_get_mimetypes( SelectionClasses *classes );
+static GHashTable       *classes_get_basenames( SelectionClasses *classes, gboolean matchcase );
+static GHashTable       *classes_get_schemes( SelectionClasses *classes );
+static GHashTable       *classes_get_dirnames( SelectionClasses *classes );
+static GHashTable       *classes_get_capabilities( SelectionClasses *classes );
+static void              mimetype_class_set_regular( MimetypeClass *class );
+static void              mimetype_class_free( MimetypeClass *class );
+static GHashTable       *set_new( void );
+
+static gboolean        is_valid_basenames( const NAIContext *object );
+static gboolean        is_valid_mimetypes( const NAIContext *object );
+static gboolean        is_valid_schemes( const NAIContext *object );
+static gboolean        is_valid_folders( const NAIContext *object );
+
+static gboolean        is_positive_assertion( const gchar *assertion );
+
+static ContextMatcher *get_context_matcher( const NAIContext *context );
+static ContextMatcher *matcher_new( const NAIContext *context );
+static ContextMatcher *matcher_ref( ContextMatcher *matcher );
+static void            matcher_unref( ContextMatcher *matcher );
+static gboolean        matcher_is_all( const GSList *list, const gchar *all );
+static void            matcher_split_mimetypes( ContextMatcher *matcher, const GSList *mimetypes );
+static void            matcher_split_basenames( ContextMatcher *matcher, const GSList *basenames );
+static void            matcher_split_schemes( ContextMatcher *matcher, const GSList *schemes );
+static void            matcher_split_folders( ContextMatcher *matcher, const GSList *folders );
+static void            matcher_set_selection_count( ContextMatcher *matcher, const gchar *selection_count );
+static void            matcher_set_capabilities( ContextMatcher *matcher, const GSList *capabilities );
+static void            pattern_list_free( GSList *patterns );
+static void            pattern_free( ContextPattern *pattern );
 
 /**
  * na_icontext_get_type:
@@ -222,33 +404,171 @@ na_icontext_is_candidate( const NAIContext *context, guint target, GList *select
 {
 	static const gchar *thisfn = "na_icontext_is_candidate";
 	gboolean is_candidate;
+	const ContextMatcher *matcher;
+	SelectionClasses *classes;
+	gboolean allocated;
 
 	g_return_val_if_fail( NA_IS_ICONTEXT( context ), FALSE );
 
+	classes = classes_get( selection, &allocated );
+
 	g_debug( "%s: object=%p (%s), target=%d, selection=%p (count=%d)",
-			thisfn, ( void * ) context, G_OBJECT_TYPE_NAME( context ), target, (void * ) selection, g_list_length( selection ));
-
-	is_candidate = v_is_candidate( NA_ICONTEXT( context ), target, selection );
-
-	if( is_candidate ){
-		is_candidate =
-				is_candidate_for_target( context, target, selection ) &&
-				is_candidate_for_show_in( context, target, selection ) &&
-				is_candidate_for_try_exec( context, target, selection ) &&
-				is_candidate_for_show_if_registered( context, target, selection ) &&
-				is_candidate_for_show_if_true( context, target, selection ) &&
-				is_candidate_for_show_if_running( context, target, selection ) &&
-				is_candidate_for_mimetypes( context, target, selection ) &&
-				is_candidate_for_basenames( context, target, selection ) &&
-				is_candidate_for_selection_count( context, target, selection ) &&
-				is_candidate_for_schemes( context, target, selection ) &&
-				is_candidate_for_folders( context, target, selection ) &&
-				is_candidate_for_capabilities( context, target, selection );
+			thisfn, ( void * ) context, G_OBJECT_TYPE_NAME( context ), target, (void * ) selection, classes->count );
+
+	/* the dynamic conditions, which may be long to evaluate, come last
+	 */
+	matcher = get_context_matcher( context );
+	is_candidate =
+			is_candidate_but_dynamic( context, matcher, target, selection, classes ) &&
+			is_candidate_for_try_exec( matcher, target, selection ) &&
+			is_candidate_for_show_if_registered( matcher, target, selection ) &&
+			is_candidate_for_show_if_true( matcher, target, selection ) &&
+			is_candidate_for_show_if_running( matcher, target, selection );
+
+	if( allocated ){
+		classes_free( classes );
 	}
 
 	return( is_candidate );
 }
 
+/**
+ * na_icontext_may_be_candidate:
+ * @context: a #NAIContext to be checked.
+ * @target: the current target.
+ * @selection: the currently selected items, as a #GList of NASelectedInfo items.
+ *
+ * Checks all the conditions of na_icontext_is_candidate(), but the
+ * dynamic TryExec, ShowIfRegistered, ShowIfTrue and ShowIfRunning ones.
+ *
+ * This lets the plugin only start the evaluation of the dynamic
+ * conditions of the items which may actually be candidate.
+ *
+ * Returns: %TRUE if @context may be candidate, depending of its dynamic
+ * conditions, %FALSE if it cannot be candidate.
+ *
+ * Since: 3.3
+ */
+gboolean
+na_icontext_may_be_candidate( const NAIContext *context, guint target, GList *selection )
+{
+	gboolean may_be_candidate;
+	SelectionClasses *classes;
+	gboolean allocated;
+
+	g_return_val_if_fail( NA_IS_ICONTEXT( context ), FALSE );
+
+	classes = classes_get( selection, &allocated );
+
+	may_be_candidate = is_candidate_but_dynamic( context, get_context_matcher( context ), target, selection, classes );
+
+	if( allocated ){
+		classes_free( classes );
+	}
+
+	return( may_be_candidate );
+}
+
+/**
+ * na_icontext_begin_selection:
+ * @selection: the list of currently selected items, as a #GList of
+ *  #NASelectedInfo items.
+ *
+ * Groups the @selection into equivalence classes for the per-file
+ * conditions, so that these conditions are evaluated once per class
+ * by all the na_icontext_is_candidate() calls for this same @selection,
+ * until na_icontext_end_selection() is called.
+ *
+ * The @selection must not be modified nor released in the meanwhile.
+ *
+ * Since: 3.3
+ */
+void
+na_icontext_begin_selection( GList *selection )
+{
+	if( st_classes ){
+		classes_free( st_classes );
+	}
+
+	st_classes = classes_new( selection );
+}
+
+/**
+ * na_icontext_end_selection:
+ *
+ * Releases the equivalence classes built by na_icontext_begin_selection().
+ *
+ * Since: 3.3
+ */
+void
+na_icontext_end_selection( void )
+{
+	if( st_classes ){
+		classes_free( st_classes );
+		st_classes = NULL;
+	}
+}
+
+/**
+ * na_icontext_is_static:
+ * @context: a #NAIContext to be checked.
+ *
+ * Whether the candidacy of @context only depends on the mimetypes, the
+ * schemes, the folders, the file types and capabilities, and the count
+ * of the selected items.
+ *
+ * This is not the case when @context defines basenames conditions, or
+ * one of the dynamic TryExec, ShowIfRegistered, ShowIfTrue or
+ * ShowIfRunning conditions.
+ *
+ * Returns: %TRUE if the result of na_icontext_is_candidate() may be
+ * reused for another selection of same shape, %FALSE else.
+ *
+ * Since: 3.3
+ */
+gboolean
+na_icontext_is_static( const NAIContext *context )
+{
+	const ContextMatcher *matcher;
+
+	g_return_val_if_fail( NA_IS_ICONTEXT( context ), FALSE );
+
+	matcher = get_context_matcher( context );
+
+	return( matcher->all_basenames &&
+			!matcher->try_exec &&
+			!matcher->show_if_registered &&
+			!matcher->show_if_true &&
+			!matcher->show_if_running );
+}
+
+/**
+ * na_icontext_needs_attributes:
+ * @context: a #NAIContext to be checked.
+ *
+ * Whether the candidacy of @context depends on the attributes of the
+ * selected files which have to be queried, i.e. their file type (when
+ * the mimetypes condition targets 'allfiles') or their capabilities.
+ *
+ * Returns: %TRUE if na_icontext_is_candidate() may query the attributes
+ * of the selected files, %FALSE else.
+ *
+ * Since: 3.3
+ */
+gboolean
+na_icontext_needs_attributes( const NAIContext *context )
+{
+	const ContextMatcher *matcher;
+
+	g_return_val_if_fail( NA_IS_ICONTEXT( context ), FALSE );
+
+	matcher = get_context_matcher( context );
+
+	return(( !matcher->all_mimetypes && matcher->mimetypes_regular ) ||
+			matcher->caps_pos ||
+			matcher->caps_neg );
+}
+
 /**
  * na_icontext_is_valid:
  * @context: the #NAIContext to be checked.
@@ -282,6 +602,122 @@ na_icontext_is_valid( const NAIContext *context )
 	return( is_valid );
 }
 
+/**
+ * na_icontext_get_index_keys:
+ * @context: the #NAIContext to be examined.
+ * @index: the indexed conditions.
+ * @keys: [out]: a placeholder for the list of keys.
+ *
+ * Computes the keys under which the @context may be indexed, i.e. a
+ * set of values such that the @context may only be candidate if each
+ * selected item matches one of them.
+ *
+ * Only positive conditions are considered: negative ones may only
+ * further restrict the candidacy, and are so not relevant here.
+ *
+ * Returns: %TRUE if the @context is restricted to the returned @keys,
+ * which should then be na_core_utils_slist_free() by the caller;
+ * %FALSE if the @context may be candidate whatever be the selection
+ * regarding this @index, @keys being then set to %NULL.
+ *
+ * Since: 3.3
+ */
+gboolean
+na_icontext_get_index_keys( const NAIContext *context, NAIContextIndex index, GSList **keys )
+{
+	const ContextMatcher *matcher;
+	const ContextPattern *pattern;
+	gboolean restricted;
+	GSList *it;
+
+	g_return_val_if_fail( NA_IS_ICONTEXT( context ), FALSE );
+	g_return_val_if_fail( keys, FALSE );
+
+	*keys = NULL;
+	restricted = FALSE;
+	matcher = get_context_matcher( context );
+
+	switch( index ){
+		case ICONTEXT_INDEX_MIMETYPES:
+			restricted = !matcher->all_mimetypes;
+			for( it = matcher->mimetypes_pos ; it && restricted ; it = it->next ){
+				pattern = ( const ContextPattern * ) it->data;
+				if( pattern->kind == MIMETYPE_KIND_ALL ){
+					restricted = FALSE;
+				} else {
+					*keys = g_slist_prepend( *keys, g_strdup( pattern->pattern ));
+				}
+			}
+			break;
+
+		case ICONTEXT_INDEX_SCHEMES:
+			restricted = !matcher->all_schemes;
+			for( it = matcher->schemes_pos ; it && restricted ; it = it->next ){
+				if( !strcmp(( const gchar * ) it->data, "*" )){
+					restricted = FALSE;
+				} else {
+					*keys = g_slist_prepend( *keys, g_strdup(( const gchar * ) it->data ));
+				}
+			}
+			break;
+
+		/* only '*.ext' patterns may be indexed, 'ext' being itself
+		 * free of any wildcard
+		 */
+		case ICONTEXT_INDEX_EXTENSIONS:
+			restricted = !matcher->all_basenames;
+			for( it = matcher->basenames_pos ; it && restricted ; it = it->next ){
+				pattern = ( const ContextPattern * ) it->data;
+				if( pattern->pattern ){
+					if( g_str_has_prefix( pattern->pattern, "*." ) &&
+						strlen( pattern->pattern ) > 2 &&
+						!strpbrk( pattern->pattern+2, "*?" )){
+
+						*keys = g_slist_prepend( *keys, g_strdup( pattern->pattern+2 ));
+					} else {
+						restricted = FALSE;
+					}
+				}
+			}
+			break;
+	}
+
+	if( !restricted ){
+		na_core_utils_slist_free( *keys );
+		*keys = NULL;
+	}
+
+	return( restricted );
+}
+
+/**
+ * na_icontext_is_mimetype_of:
+ * @mimetype: the mimetype of a file.
+ * @pattern: a mimetype condition, without its negation sign.
+ * @is_regular: whether the file is a regular one.
+ *
+ * Returns: %TRUE if a file of @mimetype matches the @pattern condition,
+ * %FALSE else.
+ *
+ * Since: 3.3
+ */
+gboolean
+na_icontext_is_mimetype_of( const gchar *mimetype, const gchar *pattern, gboolean is_regular )
+{
+	ContextPattern cpattern;
+
+	g_return_val_if_fail( mimetype, FALSE );
+	g_return_val_if_fail( pattern, FALSE );
+
+	/* the content type of the pattern is only computed on a memo miss */
+	cpattern.pattern = ( gchar * ) pattern;
+	cpattern.content_type = NULL;
+	cpattern.kind = get_mimetype_kind( pattern );
+	cpattern.spec = NULL;
+
+	return( is_mimetype_of( &cpattern, mimetype, is_regular ));
+}
+
 /**
  * na_icontext_check_mimetypes:
  * @context: the #NAIContext object to be checked.
@@ -328,12 +764,54 @@ na_icontext_check_mimetypes( const NAIContext *context )
  *
  * Copy specific data from @source to @context.
  *
+ * The compiled conditions of @source, if any, are shared with @context.
+ *
  * Since: 3.1
  */
 void
 na_icontext_copy( NAIContext *context, const NAIContext *source )
 {
-	/* nothing to do for now */
+	ContextMatcher *matcher;
+
+	g_return_if_fail( NA_IS_ICONTEXT( context ));
+	g_return_if_fail( NA_IS_ICONTEXT( source ));
+
+	matcher = ( ContextMatcher * ) g_object_get_data( G_OBJECT( source ), NA_ICONTEXT_DATA_MATCHER );
+
+	if( matcher ){
+		g_object_set_data_full( G_OBJECT( context ), NA_ICONTEXT_DATA_MATCHER, matcher_ref( matcher ), ( GDestroyNotify ) matcher_unref );
+
+	} else {
+		g_object_set_data( G_OBJECT( context ), NA_ICONTEXT_DATA_MATCHER, NULL );
+	}
+}
+
+/**
+ * na_icontext_data_changed:
+ * @context: the #NAIContext which has been modified.
+ * @name: the name of the modified elementary data.
+ *
+ * Let the @context know that one of its elementary data has been set.
+ *
+ * If this data is one of the conditions, the compiled form of the
+ * conditions is released, and will be rebuilt the next time the
+ * @context is checked.
+ *
+ * Since: 3.3
+ */
+void
+na_icontext_data_changed( NAIContext *context, const gchar *name )
+{
+	guint i;
+
+	g_return_if_fail( NA_IS_ICONTEXT( context ));
+
+	for( i = 0 ; st_matcher_data[i] ; ++i ){
+		if( !strcmp( st_matcher_data[i], name )){
+			g_object_set_data( G_OBJECT( context ), NA_ICONTEXT_DATA_MATCHER, NULL );
+			break;
+		}
+	}
 }
 
 /**
@@ -349,6 +827,13 @@ na_icontext_copy( NAIContext *context, const NAIContext *source )
  *       in order to optimize computation time;
  *     </para>
  *   </listitem>
+ *   <listitem>
+ *     <para>
+ *       This compiles the conditions into a read-only form, so that
+ *       na_icontext_is_candidate() does not have to read nor to parse
+ *       them again.
+ *     </para>
+ *   </listitem>
  * </itemizedlist>
  *
  * Since: 2.30
@@ -357,6 +842,8 @@ void
 na_icontext_read_done( NAIContext *context )
 {
 	na_object_check_mimetypes( context );
+
+	g_object_set_data_full( G_OBJECT( context ), NA_ICONTEXT_DATA_MATCHER, matcher_new( context ), ( GDestroyNotify ) matcher_unref );
 }
 
 /**
@@ -466,29 +953,43 @@ v_is_candidate( NAIContext *context, guint target, GList *selection )
 	return( is_candidate );
 }
 
+static gboolean
+is_candidate_but_dynamic( const NAIContext *context, const ContextMatcher *matcher, guint target, GList *files, SelectionClasses *classes )
+{
+	return( v_is_candidate( NA_ICONTEXT( context ), target, files ) &&
+			is_candidate_for_target( matcher, target, files ) &&
+			is_candidate_for_show_in( matcher, target, files ) &&
+			is_candidate_for_mimetypes( matcher, target, classes ) &&
+			is_candidate_for_basenames( matcher, target, classes ) &&
+			is_candidate_for_selection_count( matcher, target, classes ) &&
+			is_candidate_for_schemes( matcher, target, classes ) &&
+			is_candidate_for_folders( matcher, target, classes ) &&
+			is_candidate_for_capabilities( matcher, target, classes ));
+}
+
 /*
  * whether the given NAIContext object is candidate for this target
  * target is context menu for location, context menu for selection or toolbar for location
  * only actions are concerned by this check
  */
 static gboolean
-is_candidate_for_target( const NAIContext *object, guint target, GList *files )
+is_candidate_for_target( const ContextMatcher *matcher, guint target, GList *files )
 {
 	static const gchar *thisfn = "na_icontext_is_candidate_for_target";
 	gboolean ok = TRUE;
 
-	if( NA_IS_OBJECT_ACTION( object )){
+	if( matcher->is_action ){
 		switch( target ){
 			case ITEM_TARGET_LOCATION:
-				ok = na_object_is_target_location( object );
+				ok = matcher->target_location;
 				break;
 
 			case ITEM_TARGET_TOOLBAR:
-				ok = na_object_is_target_toolbar( object );
+				ok = matcher->target_toolbar;
 				break;
 
 			case ITEM_TARGET_SELECTION:
-				ok = na_object_is_target_selection( object );
+				ok = matcher->target_selection;
 				break;
 
 			case ITEM_TARGET_ANY:
@@ -503,7 +1004,6 @@ is_candidate_for_target( const NAIContext *object, guint target, GList *files )
 
 	if( !ok ){
 		g_debug( "%s: object is not candidate because target doesn't match (asked=%d)", thisfn, target );
-		/*na_object_dump( object );*/
 	}
 
 	return( ok );
@@ -514,12 +1014,10 @@ is_candidate_for_target( const NAIContext *object, guint target, GList *files )
  * only one of these two data may be set
  */
 static gboolean
-is_candidate_for_show_in( const NAIContext *object, guint target, GList *files )
+is_candidate_for_show_in( const ContextMatcher *matcher, guint target, GList *files )
 {
 	static const gchar *thisfn = "na_icontext_is_candidate_for_show_in";
 	gboolean ok = TRUE;
-	GSList *only_in = na_object_get_only_show_in( object );
-	GSList *not_in = na_object_get_not_show_in( object );
 	static gchar *environment = NULL;
 
 	/* there is a memory leak here when desktop comes from user preferences
@@ -534,168 +1032,94 @@ is_candidate_for_show_in( const NAIContext *object, guint target, GList *files )
 		g_debug( "%s: found %s desktop", thisfn, environment );
 	}
 
-	if( only_in && g_slist_length( only_in )){
-		ok = ( na_core_utils_slist_count( only_in, environment ) > 0 );
-	} else if( not_in && g_slist_length( not_in )){
-		ok = ( na_core_utils_slist_count( not_in, environment ) == 0 );
+	if( matcher->only_show_in ){
+		ok = ( na_core_utils_slist_count( matcher->only_show_in, environment ) > 0 );
+	} else if( matcher->not_show_in ){
+		ok = ( na_core_utils_slist_count( matcher->not_show_in, environment ) == 0 );
 	}
 
 	if( !ok ){
-		gchar *only_str = na_core_utils_slist_to_text( only_in );
-		gchar *not_str = na_core_utils_slist_to_text( not_in );
-		g_debug( "%s: object is not candidate because OnlyShowIn=%s, NotShowIn=%s", thisfn, only_str, not_str );
-		g_free( not_str );
-		g_free( only_str );
+		g_debug( "%s: object is not candidate because of OnlyShowIn/NotShowIn for %s desktop", thisfn, environment );
 	}
 
-	na_core_utils_slist_free( not_in );
-	na_core_utils_slist_free( only_in );
-
 	return( ok );
 }
 
 /*
  * if the data is set, it should be the path of an executable file
+ *
+ * the dynamic conditions are evaluated by the worker threads of the
+ * na-dynamic-condition module, so that the deadline of the menu is honored
  */
 static gboolean
-is_candidate_for_try_exec( const NAIContext *object, guint target, GList *files )
+is_candidate_for_try_exec( const ContextMatcher *matcher, guint target, GList *files )
 {
 	static const gchar *thisfn = "na_icontext_is_candidate_for_try_exec";
 	gboolean ok = TRUE;
-	GError *error = NULL;
-	gchar *tryexec = na_object_get_try_exec( object );
+	const gchar *tryexec = matcher->try_exec;
 
-	if( tryexec && strlen( tryexec )){
-		ok = FALSE;
-		GFile *file = g_file_new_for_path( tryexec );
-		GFileInfo *info = g_file_query_info( file, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE, G_FILE_QUERY_INFO_NONE, NULL, &error );
-		if( error ){
-			g_debug( "%s: %s", thisfn, error->message );
-			g_error_free( error );
-
-		} else {
-			ok = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE );
-		}
-
-		if( info ){
-			g_object_unref( info );
-		}
-
-		g_object_unref( file );
+	if( tryexec ){
+		ok = na_dynamic_condition_evaluate( DYNAMIC_CONDITION_TRY_EXEC, tryexec );
 	}
 
 	if( !ok ){
 		g_debug( "%s: object is not candidate because TryExec=%s", thisfn, tryexec );
 	}
 
-	g_free( tryexec );
-
 	return( ok );
 }
 
 static gboolean
-is_candidate_for_show_if_registered( const NAIContext *object, guint target, GList *files )
+is_candidate_for_show_if_registered( const ContextMatcher *matcher, guint target, GList *files )
 {
 	static const gchar *thisfn = "na_icontext_is_candidate_for_show_if_registered";
 	gboolean ok = TRUE;
-	gchar *name = na_object_get_show_if_registered( object );
+	const gchar *name = matcher->show_if_registered;
 
-	if( name && strlen( name )){
-		ok = FALSE;
-#ifdef HAVE_GDBUS
-#else
-# ifdef HAVE_DBUS_GLIB
-		GError *error = NULL;
-		DBusGConnection *connection = dbus_g_bus_get( DBUS_BUS_SESSION, &error );
-
-		if( !connection ){
-			if( error ){
-				g_warning( "%s: %s", thisfn, error->message );
-				g_error_free( error );
-			}
-
-		} else {
-			DBusGProxy *proxy = dbus_g_proxy_new_for_name( connection, name, NULL, NULL );
-			ok = ( proxy != NULL );
-			dbus_g_connection_unref( connection );
-		}
-# endif
-#endif
+	if( name ){
+		ok = na_dynamic_condition_evaluate( DYNAMIC_CONDITION_SHOW_IF_REGISTERED, name );
 	}
 
 	if( !ok ){
 		g_debug( "%s: object is not candidate because ShowIfRegistered=%s", thisfn, name );
 	}
 
-	g_free( name );
-
 	return( ok );
 }
 
 static gboolean
-is_candidate_for_show_if_true( const NAIContext *object, guint target, GList *files )
+is_candidate_for_show_if_true( const ContextMatcher *matcher, guint target, GList *files )
 {
 	static const gchar *thisfn = "na_icontext_is_candidate_for_show_if_true";
 	gboolean ok = TRUE;
-	gchar *command = na_object_get_show_if_true( object );
-
-	if( command && strlen( command )){
-		ok = FALSE;
-		gchar *stdout = NULL;
-		g_spawn_command_line_sync( command, &stdout, NULL, NULL, NULL );
-
-		if( stdout && !strcmp( stdout, "true" )){
-			ok = TRUE;
-		}
+	const gchar *command = matcher->show_if_true;
 
-		g_free( stdout );
+	if( command ){
+		ok = na_dynamic_condition_evaluate( DYNAMIC_CONDITION_SHOW_IF_TRUE, command );
 	}
 
 	if( !ok ){
 		g_debug( "%s: object is not candidate because ShowIfTrue=%s", thisfn, command );
 	}
 
-	g_free( command );
-
 	return( ok );
 }
 
 static gboolean
-is_candidate_for_show_if_running( const NAIContext *object, guint target, GList *files )
+is_candidate_for_show_if_running( const ContextMatcher *matcher, guint target, GList *files )
 {
 	static const gchar *thisfn = "na_icontext_is_candidate_for_show_if_running";
 	gboolean ok = TRUE;
-	gchar *searched;
-	glibtop_proclist proclist;
-	glibtop_proc_state procstate;
-	pid_t *pid_list;
-	guint i;
-	gchar *running = na_object_get_show_if_running( object );
-
-	if( running && strlen( running )){
-		ok = FALSE;
-		searched = g_path_get_basename( running );
-		pid_list = glibtop_get_proclist( &proclist, GLIBTOP_KERN_PROC_ALL, 0 );
-
-		for( i=0 ; i<proclist.number && !ok ; ++i ){
-			glibtop_get_proc_state( &procstate, pid_list[i] );
-			/*g_debug( "%s: i=%d, cmd=%s", thisfn, i, procstate.cmd );*/
-			if( strcmp( procstate.cmd, searched ) == 0 ){
-				g_debug( "%s: i=%d, cmd=%s", thisfn, i, procstate.cmd );
-				ok = TRUE;
-			}
-		}
+	const gchar *running = matcher->show_if_running;
 
-		g_free( pid_list );
-		g_free( searched );
+	if( running ){
+		ok = na_dynamic_condition_evaluate( DYNAMIC_CONDITION_SHOW_IF_RUNNING, running );
 	}
 
 	if( !ok ){
 		g_debug( "%s: object is not candidate because ShowIfRunning=%s", thisfn, running );
 	}
 
-	g_free( running );
-
 	return( ok );
 }
 
@@ -712,72 +1136,81 @@ is_candidate_for_show_if_running( const NAIContext *object, guint target, GList
  * (they are ORed), while not being of any negative assertions (they are
  * ANDed)
  *
- * here, for each mimetype of the selection, do
- * . match is FALSE while this mimetype has not matched a positive assertion
- * . nomatch is FALSE while this mimetype has not matched a negative assertion
- * we are going to check each mimetype filter
- *  while we have not found a match among positive conditions (i.e. while !match)
- *  we have to check all negative conditions to verify that the current
- *  examined mimetype never match these
+ * positive and negative assertions have been splitted at compile time:
+ * for each mimetype of the selection, we so just have to search for a
+ * matching positive assertion, and then to check that the mimetype does
+ * not match any negative one
  */
 static gboolean
-is_candidate_for_mimetypes( const NAIContext *object, guint target, GList *files )
+is_candidate_for_mimetypes( const ContextMatcher *matcher, guint target, SelectionClasses *classes )
 {
 	static const gchar *thisfn = "na_icontext_is_candidate_for_mimetypes";
 	gboolean ok = TRUE;
-	gboolean all = na_object_get_all_mimetypes( object );
 
-	g_debug( "%s: all=%s", thisfn, all ? "True":"False" );
+	g_debug( "%s: all=%s", thisfn, matcher->all_mimetypes ? "True":"False" );
 
-	if( !all ){
-		GSList *mimetypes = na_object_get_mimetypes( object );
-		GSList *im;
-		GList *it;
+	if( !matcher->all_mimetypes ){
+		GHashTable *mimetypes;
+		GHashTableIter iter;
+		const gchar *ftype;
+		MimetypeClass *class;
 
-		for( it = files ; it && ok ; it = it->next ){
-			gchar *ftype;
-			gboolean regular, match, positive;
+		mimetypes = classes_get_mimetypes( classes );
 
-			match = FALSE;
-			ftype = na_selected_info_get_mime_type( NA_SELECTED_INFO( it->data ));
-			regular = na_selected_info_is_regular( NA_SELECTED_INFO( it->data ));
-
-			if( ftype ){
-				for( im = mimetypes ; im && ok ; im = im->next ){
-					const gchar *imtype = ( const gchar * ) im->data;
-					positive = is_positive_assertion( imtype );
-
-					if( !positive || !match ){
-						if( is_mimetype_of( positive ? imtype : imtype+1, ftype, regular )){
-							g_debug( "%s: condition=%s, positive=%s, ftype=%s, matched",
-									thisfn, imtype, positive ? "True":"False", ftype );
-							if( positive ){
-								match = TRUE;
-							} else {
-								ok = FALSE;
-							}
-						}
-					}
-				}
+		if( classes->null_mimetype_uri ){
+			g_warning( "%s: null mimetype found for %s", thisfn, classes->null_mimetype_uri );
+			ok = FALSE;
+		}
 
-				if( !match ){
-					gchar *mimetypes_str = na_core_utils_slist_to_text( mimetypes );
-					g_debug( "%s: no positive match found for Mimetypes=%s", thisfn, mimetypes_str );
-					g_free( mimetypes_str );
-					ok = FALSE;
+		g_hash_table_iter_init( &iter, mimetypes );
+
+		while( ok && g_hash_table_iter_next( &iter, ( gpointer * ) &ftype, ( gpointer * ) &class )){
+
+			/* the file type is only relevant with 'allfiles' patterns */
+			if( matcher->mimetypes_regular ){
+				mimetype_class_set_regular( class );
+
+				if( class->has_regular ){
+					ok = is_mimetype_candidate( matcher, ftype, TRUE );
+				}
+				if( ok && class->has_other ){
+					ok = is_mimetype_candidate( matcher, ftype, FALSE );
 				}
 
 			} else {
-				gchar *uri = na_selected_info_get_uri( NA_SELECTED_INFO( it->data ));
-				g_warning( "%s: null mimetype found for %s", thisfn, uri );
-				g_free( uri );
-				ok = FALSE;
+				ok = is_mimetype_candidate( matcher, ftype, FALSE );
 			}
-
-			g_free( ftype );
 		}
+	}
+
+	return( ok );
+}
+
+static gboolean
+is_mimetype_candidate( const ContextMatcher *matcher, const gchar *ftype, gboolean regular )
+{
+	static const gchar *thisfn = "na_icontext_is_mimetype_candidate";
+	gboolean ok, match;
+	GSList *im;
+
+	ok = TRUE;
+	match = FALSE;
+
+	for( im = matcher->mimetypes_pos ; im && !match ; im = im->next ){
+		match = is_mimetype_of(( const ContextPattern * ) im->data, ftype, regular );
+	}
 
-		na_core_utils_slist_free( mimetypes );
+	if( !match ){
+		g_debug( "%s: no positive match found for ftype=%s", thisfn, ftype );
+		ok = FALSE;
+	}
+
+	for( im = matcher->mimetypes_neg ; im && ok ; im = im->next ){
+		if( is_mimetype_of(( const ContextPattern * ) im->data, ftype, regular )){
+			g_debug( "%s: condition=!%s, ftype=%s, matched",
+					thisfn, (( const ContextPattern * ) im->data )->pattern, ftype );
+			ok = FALSE;
+		}
 	}
 
 	return( ok );
@@ -804,6 +1237,23 @@ is_file_mimetype( const gchar *mimetype )
 			!strcmp( mimetype, "all/allfiles" ));
 }
 
+/*
+ * the mimetype patterns are classified once, when they are compiled
+ */
+static guint
+get_mimetype_kind( const gchar *mimetype )
+{
+	if( is_all_mimetype( mimetype )){
+		return( MIMETYPE_KIND_ALL );
+	}
+
+	if( is_file_mimetype( mimetype )){
+		return( MIMETYPE_KIND_FILES );
+	}
+
+	return( MIMETYPE_KIND_TYPE );
+}
+
 /*
  * does the file fgroup/fsubgroup have a mimetype which is 'a sort of'
  *  mimetype specified one ?
@@ -813,208 +1263,246 @@ is_file_mimetype( const gchar *mimetype )
  * this is not true on Win32 platforms
  */
 static gboolean
-is_mimetype_of( const gchar *mimetype, const gchar *ftype, gboolean is_regular )
+is_mimetype_of( const ContextPattern *pattern, const gchar *ftype, gboolean is_regular )
 {
-	static const gchar *thisfn = "na_icontext_is_mimetype_of";
-	gboolean is_type_of;
-	gchar *file_content_type, *def_content_type;
-
-	if( is_all_mimetype( mimetype )){
+	if( pattern->kind == MIMETYPE_KIND_ALL ){
 		return( TRUE );
 	}
 
-	if( is_file_mimetype( mimetype ) && is_regular ){
+	if( pattern->kind == MIMETYPE_KIND_FILES && is_regular ){
 		return( TRUE );
 	}
 
-	is_type_of = FALSE;
-	file_content_type = g_content_type_from_mime_type( ftype );
-	def_content_type = g_content_type_from_mime_type( mimetype );
-
-	if( file_content_type && def_content_type ){
-		is_type_of = g_content_type_is_a( file_content_type, def_content_type );
-		g_debug( "%s: def_mimetype=%s content_type=%s file_mimetype=%s content_type=%s is_a=%s",
-				thisfn, mimetype, def_content_type, ftype, file_content_type,
-				is_type_of ? "True":"False" );
-	}
-
-	g_free( file_content_type );
-	g_free( def_content_type );
-
-	return( is_type_of );
+	return( mimetype_memo_is_a( ftype, pattern ));
 }
 
+/*
+ * the content types are only computed, and the shared-mime-info tree only
+ * walked, the first time a (file mimetype, pattern) pair is seen
+ *
+ * the content type of the pattern has been computed at compile time,
+ * unless called from na_icontext_is_mimetype_of()
+ */
 static gboolean
-is_candidate_for_basenames( const NAIContext *object, guint target, GList *files )
+mimetype_memo_is_a( const gchar *ftype, const ContextPattern *pattern )
 {
-	static const gchar *thisfn = "na_icontext_is_candidate_for_basenames";
-	gboolean ok = TRUE;
-	GSList *basenames = na_object_get_basenames( object );
-
-	if( basenames ){
-		if( strcmp( basenames->data, "*" ) != 0 || g_slist_length( basenames ) > 1 ){
-			gboolean matchcase = na_object_get_matchcase( object );
-			GSList *ib;
-			GList *it;
-			gchar *tmp;
-
-			for( it = files ; it && ok ; it = it->next ){
-				gchar *pattern, *bname, *bname_utf8;
-				gboolean match, positive;
-				gchar *pattern_utf8;
-
-				bname = na_selected_info_get_basename( NA_SELECTED_INFO( it->data ));
-				bname_utf8 = g_filename_to_utf8( bname, -1, NULL, NULL, NULL );
-				if( !matchcase ){
-					tmp = g_utf8_strdown( bname_utf8, -1 );
-					g_free( bname_utf8 );
-					bname_utf8 = tmp;
-				}
-				match = FALSE;
-
-				for( ib = basenames ; ib && ok ; ib = ib->next ){
-					pattern = matchcase ?
-						g_strdup(( gchar * ) ib->data ) :
-						g_utf8_strdown(( gchar * ) ib->data, -1 );
-					positive = is_positive_assertion( pattern );
-					pattern_utf8 = g_filename_to_utf8( positive ? pattern : pattern+1, -1, NULL, NULL, NULL );
-
-					if( !positive || !match ){
-						if( g_pattern_match_simple( pattern_utf8, bname_utf8 )){
-							g_debug( "%s: condition=%s, positive=%s, basename=%s: matched",
-									thisfn, pattern_utf8, positive ? "True":"False", bname_utf8 );
-							if( positive ){
-								match = TRUE;
-							} else {
-								ok = FALSE;
-							}
-						}
-					}
+	static const gchar *thisfn = "na_icontext_mimetype_memo_is_a";
+	GHashTable *patterns;
+	gpointer found;
+	gboolean is_type_of;
+	gchar *file_content_type, *computed;
+	const gchar *pattern_content_type;
 
-					g_free( pattern_utf8 );
-					g_free( pattern );
-				}
+	mimetype_memo_init();
+
+	patterns = ( GHashTable * ) g_hash_table_lookup( st_mimetype_memo, ftype );
+
+	if( patterns ){
+		found = g_hash_table_lookup( patterns, pattern->pattern );
+		if( found ){
+			return( GPOINTER_TO_UINT( found ) - 1 );
+		}
+	}
+
+	file_content_type = g_content_type_from_mime_type( ftype );
+	computed = pattern->content_type ? NULL : g_content_type_from_mime_type( pattern->pattern );
+	pattern_content_type = pattern->content_type ? pattern->content_type : computed;
+
+	is_type_of = FALSE;
+
+	if( file_content_type && pattern_content_type ){
+		is_type_of = g_content_type_is_a( file_content_type, pattern_content_type );
+		g_debug( "%s: def_mimetype=%s content_type=%s file_mimetype=%s content_type=%s is_a=%s",
+				thisfn, pattern->pattern, pattern_content_type, ftype, file_content_type,
+				is_type_of ? "True":"False" );
+	}
+
+	g_free( computed );
+	g_free( file_content_type );
+
+	if( st_mimetype_memo_count >= st_mimetype_memo_max ){
+		g_hash_table_remove_all( st_mimetype_memo );
+		st_mimetype_memo_count = 0;
+		patterns = NULL;
+	}
+
+	if( !patterns ){
+		patterns = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+		g_hash_table_insert( st_mimetype_memo, g_strdup( ftype ), patterns );
+	}
+
+	g_hash_table_insert( patterns, g_strdup( pattern->pattern ), GUINT_TO_POINTER( 1+is_type_of ));
+	st_mimetype_memo_count += 1;
+
+	return( is_type_of );
+}
+
+/*
+ * the memo is invalidated when any of the mime.cache files of the
+ * shared-mime-info database is updated
+ */
+static void
+mimetype_memo_init( void )
+{
+	const gchar * const *dirs;
+	guint i;
+
+	if( !st_mimetype_memo ){
+		st_mimetype_memo = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, ( GDestroyNotify ) g_hash_table_destroy );
+
+		mimetype_memo_monitor( g_get_user_data_dir());
+
+		dirs = g_get_system_data_dirs();
+		for( i = 0 ; dirs[i] ; ++i ){
+			mimetype_memo_monitor( dirs[i] );
+		}
+	}
+}
+
+static void
+mimetype_memo_monitor( const gchar *data_dir )
+{
+	static const gchar *thisfn = "na_icontext_mimetype_memo_monitor";
+	gchar *path;
+	GFile *file;
+	GFileMonitor *monitor;
+
+	path = g_build_filename( data_dir, "mime", "mime.cache", NULL );
+	file = g_file_new_for_path( path );
+	monitor = g_file_monitor_file( file, G_FILE_MONITOR_NONE, NULL, NULL );
+
+	if( monitor ){
+		g_debug( "%s: monitoring %s", thisfn, path );
+		g_signal_connect( monitor, "changed", G_CALLBACK( on_mime_database_changed ), NULL );
+		st_mimetype_monitors = g_list_prepend( st_mimetype_monitors, monitor );
+	}
+
+	g_object_unref( file );
+	g_free( path );
+}
+
+static void
+on_mime_database_changed( GFileMonitor *monitor, GFile *file, GFile *other, GFileMonitorEvent event, void *empty )
+{
+	static const gchar *thisfn = "na_icontext_on_mime_database_changed";
+
+	g_debug( "%s: clearing %u memoized results", thisfn, st_mimetype_memo_count );
+
+	g_hash_table_remove_all( st_mimetype_memo );
+	st_mimetype_memo_count = 0;
+}
+
+static gboolean
+is_candidate_for_basenames( const ContextMatcher *matcher, guint target, SelectionClasses *classes )
+{
+	static const gchar *thisfn = "na_icontext_is_candidate_for_basenames";
+	gboolean ok = TRUE;
 
-				if( !match ){
-					gchar *basenames_str = na_core_utils_slist_to_text( basenames );
-					g_debug( "%s: no positive match found for Basenames=%s", thisfn, basenames_str );
-					g_free( basenames_str );
+	if( !matcher->all_basenames ){
+		GSList *ib;
+		GHashTableIter iter;
+		const gchar *bname_utf8;
+		gboolean match;
+
+		g_hash_table_iter_init( &iter, classes_get_basenames( classes, matcher->matchcase ));
+
+		while( ok && g_hash_table_iter_next( &iter, ( gpointer * ) &bname_utf8, NULL )){
+			match = FALSE;
+
+			for( ib = matcher->basenames_pos ; ib && !match ; ib = ib->next ){
+				const ContextPattern *pattern = ( const ContextPattern * ) ib->data;
+				match = ( pattern->spec && g_pattern_match_string( pattern->spec, bname_utf8 ));
+			}
+
+			if( !match ){
+				g_debug( "%s: no positive match found for basename=%s", thisfn, bname_utf8 );
+				ok = FALSE;
+			}
+
+			for( ib = matcher->basenames_neg ; ib && ok ; ib = ib->next ){
+				const ContextPattern *pattern = ( const ContextPattern * ) ib->data;
+				if( pattern->spec && g_pattern_match_string( pattern->spec, bname_utf8 )){
+					g_debug( "%s: condition=!%s, basename=%s: matched", thisfn, pattern->pattern, bname_utf8 );
 					ok = FALSE;
 				}
-
-				g_free( bname_utf8 );
-				g_free( bname );
 			}
 		}
-
-		na_core_utils_slist_free( basenames );
 	}
 
 	return( ok );
 }
 
 static gboolean
-is_candidate_for_selection_count( const NAIContext *object, guint target, GList *files )
+is_candidate_for_selection_count( const ContextMatcher *matcher, guint target, SelectionClasses *classes )
 {
 	static const gchar *thisfn = "na_icontext_is_candidate_for_selection_count";
 	gboolean ok = TRUE;
-	gint limit;
 	guint count;
-	gchar *selection_count = na_object_get_selection_count( object );
 
-	if( selection_count && strlen( selection_count )){
-		limit = atoi( selection_count+1 );
-		count = g_list_length( files );
+	if( matcher->count_op != COUNT_NONE ){
+		count = classes->count;
 		ok = FALSE;
 
-		switch( selection_count[0] ){
-			case '<':
-				ok = ( count < limit );
+		switch( matcher->count_op ){
+			case COUNT_LESS:
+				ok = ( count < matcher->count_limit );
 				break;
-			case '=':
-				ok = ( count == limit );
+			case COUNT_EQUAL:
+				ok = ( count == matcher->count_limit );
 				break;
-			case '>':
-				ok = ( count > limit );
+			case COUNT_GREATER:
+				ok = ( count > matcher->count_limit );
 				break;
 			default:
 				break;
 		}
-	}
 
-	if( !ok ){
-		g_debug( "%s: object is not candidate because SelectionCount=%s", thisfn, selection_count );
+		if( !ok ){
+			g_debug( "%s: object is not candidate because SelectionCount (op=%u, limit=%d, count=%u)",
+					thisfn, matcher->count_op, matcher->count_limit, count );
+		}
 	}
 
-	g_free( selection_count );
-
 	return( ok );
 }
 
 /*
  * it is likely that all selected items have the same scheme, because they
  * are all in the same location and the scheme mainly depends on location
- * so we have here a great possible optimization by only testing the
- * first selected item.
- * note that this optimization may be wrong, for example when ran from the
- * command-line with a random set of pseudo-selected items
- * so we take care of only checking _distincts_ schemes of provided selection
- * against schemes conditions.
+ * so we only check the _distinct_ schemes of the selection against the
+ * schemes conditions.
  */
 static gboolean
-is_candidate_for_schemes( const NAIContext *object, guint target, GList *files )
+is_candidate_for_schemes( const ContextMatcher *matcher, guint target, SelectionClasses *classes )
 {
 	static const gchar *thisfn = "na_icontext_is_candidate_for_schemes";
 	gboolean ok = TRUE;
-	GSList *schemes = na_object_get_schemes( object );
-
-	if( schemes ){
-		if( strcmp( schemes->data, "*" ) != 0 || g_slist_length( schemes ) > 1 ){
-			GSList *distincts = NULL;
-			GList *it;
-
-			for( it = files ; it && ok ; it = it->next ){
-				gchar *scheme = na_selected_info_get_uri_scheme( NA_SELECTED_INFO( it->data ));
-
-				if( na_core_utils_slist_count( distincts, scheme ) == 0 ){
-					GSList *is;
-					gchar *pattern;
-					gboolean match, positive;
-
-					match = FALSE;
-					distincts = g_slist_prepend( distincts, g_strdup( scheme ));
-
-					for( is = schemes ; is && ok ; is = is->next ){
-						pattern = ( gchar * ) is->data;
-						positive = is_positive_assertion( pattern );
-
-						if( !positive || !match ){
-							if( is_compatible_scheme( positive ? pattern : pattern+1, scheme )){
-								if( positive ){
-									match = TRUE;
-								} else {
-									ok = FALSE;
-								}
-							}
-						}
-					}
 
-					ok &= match;
-				}
+	if( !matcher->all_schemes ){
+		GHashTableIter iter;
+		const gchar *scheme;
+		GSList *is;
+		gboolean match;
+
+		g_hash_table_iter_init( &iter, classes_get_schemes( classes ));
 
-				g_free( scheme );
+		while( ok && g_hash_table_iter_next( &iter, ( gpointer * ) &scheme, NULL )){
+			match = FALSE;
+
+			for( is = matcher->schemes_pos ; is && !match ; is = is->next ){
+				match = is_compatible_scheme(( const gchar * ) is->data, scheme );
 			}
 
-			na_core_utils_slist_free( distincts );
-		}
+			for( is = matcher->schemes_neg ; is && match ; is = is->next ){
+				match = !is_compatible_scheme(( const gchar * ) is->data, scheme );
+			}
 
-		if( !ok ){
-			gchar *schemes_str = na_core_utils_slist_to_text( schemes );
-			g_debug( "%s: object is not candidate because Schemes=%s", thisfn, schemes_str );
-			g_free( schemes_str );
-		}
+			ok &= match;
 
-		na_core_utils_slist_free( schemes );
+			if( !ok ){
+				g_debug( "%s: object is not candidate because of Schemes for scheme=%s", thisfn, scheme );
+			}
+		}
 	}
 
 	g_debug( "%s: ok=%s", thisfn, ok ? "True":"False" );
@@ -1041,135 +1529,373 @@ is_compatible_scheme( const gchar *pattern, const gchar *scheme )
  * assuming here the same sort of optimization than for schemes
  * i.e. we assume that all selected items are most probably located
  * in the same dirname
- * so we take care of only checking _distinct_ dirnames against folder
- * conditions
+ * so we only check the _distinct_ dirnames against folder conditions
+ *
+ * note that each positive folder condition must be satisfied, while
+ * no negative one may be
  */
 static gboolean
-is_candidate_for_folders( const NAIContext *object, guint target, GList *files )
+is_candidate_for_folders( const ContextMatcher *matcher, guint target, SelectionClasses *classes )
 {
 	static const gchar *thisfn = "na_icontext_is_candidate_for_folders";
 	gboolean ok = TRUE;
-	GSList *folders = na_object_get_folders( object );
 
-	if( folders ){
-		if( strcmp( folders->data, "/" ) != 0 || g_slist_length( folders ) > 1 ){
-			GSList *distincts = NULL;
-			GList *it;
+	if( !matcher->all_folders ){
+		GHashTableIter iter;
+		const gchar *dirname_utf8;
+		const ContextPattern *pattern;
+		GSList *id;
+		gboolean match;
 
-			for( it = files ; it && ok ; it = it->next ){
-				gchar *dirname = na_selected_info_get_dirname( NA_SELECTED_INFO( it->data ));
+		g_hash_table_iter_init( &iter, classes_get_dirnames( classes ));
 
-				if( na_core_utils_slist_count( distincts, dirname ) == 0 ){
-					g_debug( "%s: examining new distinct selected dirname=%s", thisfn, dirname );
+		while( ok && g_hash_table_iter_next( &iter, NULL, ( gpointer * ) &dirname_utf8 )){
+			if( !dirname_utf8 ){
+				continue;
+			}
 
-					GSList *id;
-					gchar *dirname_utf8, *pattern_utf8;
-					const gchar *pattern;
-					gboolean match, positive;
-					gboolean has_pattern;
+			g_debug( "%s: examining distinct selected dirname=%s", thisfn, dirname_utf8 );
 
-					distincts = g_slist_prepend( distincts, g_strdup( dirname ));
-					dirname_utf8 = g_filename_to_utf8( dirname, -1, NULL, NULL, NULL );
+			for( id = matcher->folders_pos ; id && ok ; id = id->next ){
+				pattern = ( const ContextPattern * ) id->data;
+				match = ( pattern->spec && g_pattern_match_string( pattern->spec, dirname_utf8 )) ||
+						( pattern->pattern && g_str_has_prefix( dirname_utf8, pattern->pattern ));
+				ok &= match;
+			}
 
-					for( id = folders ; id && ok ; id = id->next ){
-						pattern = ( const gchar * ) id->data;
-						g_debug( "%s: examining new condition pattern=%s", thisfn, pattern );
-						positive = is_positive_assertion( pattern );
-						pattern_utf8 = g_filename_to_utf8( positive ? pattern : pattern+1, -1, NULL, NULL, NULL );
-						has_pattern = ( g_strstr_len( pattern_utf8, -1, "*" ) != NULL );
+			for( id = matcher->folders_neg ; id && ok ; id = id->next ){
+				pattern = ( const ContextPattern * ) id->data;
+				match = ( pattern->spec && g_pattern_match_string( pattern->spec, dirname_utf8 )) ||
+						( pattern->pattern && g_str_has_prefix( dirname_utf8, pattern->pattern ));
+				ok &= !match;
+			}
 
-						match = ( has_pattern && g_pattern_match_simple( pattern_utf8, dirname_utf8 )) ||
-								g_str_has_prefix( dirname_utf8, pattern_utf8 );
+			if( !ok ){
+				g_debug( "%s: object is not candidate because of Folders for dirname=%s", thisfn, dirname_utf8 );
+			}
+		}
+	}
 
-						ok &= ( match && positive ) || ( !match && !positive );
+	return( ok );
+}
 
-						g_free( pattern_utf8 );
-					}
+static gboolean
+is_candidate_for_capabilities( const ContextMatcher *matcher, guint target, SelectionClasses *classes )
+{
+	static const gchar *thisfn = "na_icontext_is_candidate_for_capabilities";
+	gboolean ok = TRUE;
 
-					g_free( dirname_utf8 );
-				}
+	if( matcher->caps_pos || matcher->caps_neg ){
+		GHashTableIter iter;
+		gpointer key;
+		guint caps, cap;
 
-				g_free( dirname );
-			}
+		g_hash_table_iter_init( &iter, classes_get_capabilities( classes ));
 
-			na_core_utils_slist_free( distincts );
+		/* be conservative when some attributes are unknown */
+		if( classes->unresolved ){
+			g_debug( "%s: object is not candidate because of unresolved Capabilities", thisfn );
+			ok = FALSE;
 		}
 
-		if( !ok ){
-			gchar *folders_str = na_core_utils_slist_to_text( folders );
-			g_debug( "%s: object is not candidate because Folders=%s", thisfn, folders_str );
-			g_free( folders_str );
-		}
+		while( ok && g_hash_table_iter_next( &iter, &key, NULL )){
+			caps = GPOINTER_TO_UINT( key ) - 1;
 
-		na_core_utils_slist_free( folders );
+			for( cap = CAP_OWNER ; cap <= CAP_UNKNOWN && ok ; cap <<= 1 ){
+				if( matcher->caps_pos & cap ){
+					ok = (( caps & cap ) != 0 );
+				}
+				if( ok && ( matcher->caps_neg & cap )){
+					ok = (( caps & cap ) == 0 );
+				}
+				if( !ok ){
+					g_debug( "%s: object is not candidate because of Capabilities (capability=%u)", thisfn, cap );
+				}
+			}
+		}
 	}
 
 	return( ok );
 }
 
 static gboolean
-is_candidate_for_capabilities( const NAIContext *object, guint target, GList *files )
+is_capable( const NASelectedInfo *nsi, guint capability )
 {
-	static const gchar *thisfn = "na_icontext_is_candidate_for_capabilities";
-	gboolean ok = TRUE;
-	GSList *capabilities = na_object_get_capabilities( object );
+	gboolean match;
 
-	if( capabilities ){
-		GSList *ic;
-		GList *it;
-		const gchar *cap;
-		gboolean match, positive;
+	match = FALSE;
 
-		for( it = files ; it && ok ; it = it->next ){
-			for( ic = capabilities ; ic && ok ; ic = ic->next ){
-				cap = ( const gchar * ) ic->data;
-				positive = is_positive_assertion( cap );
-				match = FALSE;
+	switch( capability ){
+		case CAP_OWNER:
+			match = na_selected_info_is_owner( nsi, getlogin());
+			break;
 
-				if( !strcmp( positive ? cap : cap+1, "Owner" )){
-					match = na_selected_info_is_owner( NA_SELECTED_INFO( it->data ), getlogin());
+		case CAP_READABLE:
+			match = na_selected_info_is_readable( nsi );
+			break;
 
-				} else if( !strcmp( positive ? cap : cap+1, "Readable" )){
-					match = na_selected_info_is_readable( NA_SELECTED_INFO( it->data ));
+		case CAP_WRITABLE:
+			match = na_selected_info_is_writable( nsi );
+			break;
 
-				} else if( !strcmp( positive ? cap : cap+1, "Writable" )){
-					match = na_selected_info_is_writable( NA_SELECTED_INFO( it->data ));
+		case CAP_EXECUTABLE:
+			match = na_selected_info_is_executable( nsi );
+			break;
 
-				} else if( !strcmp( positive ? cap : cap+1, "Executable" )){
-					match = na_selected_info_is_executable( NA_SELECTED_INFO( it->data ));
+		case CAP_LOCAL:
+			match = na_selected_info_is_local( nsi );
+			break;
 
-				} else if( !strcmp( positive ? cap : cap+1, "Local" )){
-					match = na_selected_info_is_local( NA_SELECTED_INFO( it->data ));
+		/* unknown capabilities have been warned at compile time */
+		default:
+			break;
+	}
 
-				} else {
-					g_warning( "%s: unknown capability %s", thisfn, cap );
+	return( match );
+}
+
+/*
+ * returns the equivalence classes of the selection, either those built
+ * by na_icontext_begin_selection(), or newly allocated ones
+ */
+static SelectionClasses *
+classes_get( GList *selection, gboolean *allocated )
+{
+	*allocated = FALSE;
+
+	if( st_classes && st_classes->selection == selection ){
+		return( st_classes );
+	}
+
+	*allocated = TRUE;
+
+	return( classes_new( selection ));
+}
+
+static SelectionClasses *
+classes_new( GList *selection )
+{
+	SelectionClasses *classes;
+
+	classes = g_new0( SelectionClasses, 1 );
+	classes->selection = selection;
+	classes->count = g_list_length( selection );
+
+	return( classes );
+}
+
+static void
+classes_free( SelectionClasses *classes )
+{
+	if( classes->mimetypes ){
+		g_hash_table_destroy( classes->mimetypes );
+	}
+	if( classes->basenames ){
+		g_hash_table_destroy( classes->basenames );
+	}
+	if( classes->basenames_down ){
+		g_hash_table_destroy( classes->basenames_down );
+	}
+	if( classes->schemes ){
+		g_hash_table_destroy( classes->schemes );
+	}
+	if( classes->dirnames ){
+		g_hash_table_destroy( classes->dirnames );
+	}
+	if( classes->capabilities ){
+		g_hash_table_destroy( classes->capabilities );
+	}
+	g_free( classes->null_mimetype_uri );
+	g_free( classes );
+}
+
+static GHashTable *
+classes_get_mimetypes( SelectionClasses *classes )
+{
+	GList *it;
+	const gchar *ftype;
+	MimetypeClass *class;
+
+	if( !classes->mimetypes ){
+		classes->mimetypes = g_hash_table_new_full( g_direct_hash, g_direct_equal, NULL, ( GDestroyNotify ) mimetype_class_free );
+
+		for( it = classes->selection ; it ; it = it->next ){
+			ftype = na_selected_info_peek_mime_type( NA_SELECTED_INFO( it->data ));
+
+			if( !ftype ){
+				if( !classes->null_mimetype_uri ){
+					classes->null_mimetype_uri = na_selected_info_get_uri( NA_SELECTED_INFO( it->data ));
 				}
+				continue;
+			}
+
+			class = ( MimetypeClass * ) g_hash_table_lookup( classes->mimetypes, ftype );
 
-				ok &= (( positive && match ) || ( !positive && !match ));
+			if( !class ){
+				class = g_new0( MimetypeClass, 1 );
+				g_hash_table_insert( classes->mimetypes, ( gpointer ) ftype, class );
 			}
+
+			class->files = g_list_prepend( class->files, it->data );
 		}
+	}
 
-		if( !ok ){
-			gchar *capabilities_str = na_core_utils_slist_to_text( capabilities );
-			g_debug( "%s: object is not candidate because Capabilities=%s", thisfn, capabilities_str );
-			g_free( capabilities_str );
+	return( classes->mimetypes );
+}
+
+/*
+ * if the basenames are not case sensitive, then the patterns have been
+ * lowercased at compile time, and the selected basenames are lowercased
+ * here
+ */
+static GHashTable *
+classes_get_basenames( SelectionClasses *classes, gboolean matchcase )
+{
+	GHashTable **set;
+	GList *it;
+	gchar *bname, *bname_utf8, *tmp;
+
+	set = matchcase ? &classes->basenames : &classes->basenames_down;
+
+	if( !*set ){
+		*set = set_new();
+
+		for( it = classes->selection ; it ; it = it->next ){
+			bname = na_selected_info_get_basename( NA_SELECTED_INFO( it->data ));
+			bname_utf8 = g_filename_to_utf8( bname, -1, NULL, NULL, NULL );
+			g_free( bname );
+
+			if( bname_utf8 && !matchcase ){
+				tmp = g_utf8_strdown( bname_utf8, -1 );
+				g_free( bname_utf8 );
+				bname_utf8 = tmp;
+			}
+
+			if( bname_utf8 ){
+				g_hash_table_replace( *set, bname_utf8, GUINT_TO_POINTER( 1 ));
+			}
 		}
+	}
 
-		na_core_utils_slist_free( capabilities );
+	return( *set );
+}
+
+static GHashTable *
+classes_get_schemes( SelectionClasses *classes )
+{
+	GList *it;
+	const gchar *scheme;
+
+	if( !classes->schemes ){
+		classes->schemes = g_hash_table_new( g_direct_hash, g_direct_equal );
+
+		for( it = classes->selection ; it ; it = it->next ){
+			scheme = na_selected_info_peek_uri_scheme( NA_SELECTED_INFO( it->data ));
+			g_hash_table_insert( classes->schemes, ( gpointer ) scheme, GUINT_TO_POINTER( 1 ));
+		}
 	}
 
-	return( ok );
+	return( classes->schemes );
+}
+
+/*
+ * each distinct dirname is only converted once to UTF-8; the value is
+ * %NULL when the dirname cannot be converted
+ */
+static GHashTable *
+classes_get_dirnames( SelectionClasses *classes )
+{
+	GList *it;
+	const gchar *dirname;
+
+	if( !classes->dirnames ){
+		classes->dirnames = g_hash_table_new_full( g_direct_hash, g_direct_equal, NULL, g_free );
+
+		for( it = classes->selection ; it ; it = it->next ){
+			dirname = na_selected_info_peek_dirname( NA_SELECTED_INFO( it->data ));
+
+			if( dirname && !g_hash_table_lookup_extended( classes->dirnames, dirname, NULL, NULL )){
+				g_hash_table_insert( classes->dirnames,
+						( gpointer ) dirname, g_filename_to_utf8( dirname, -1, NULL, NULL, NULL ));
+			}
+		}
+	}
+
+	return( classes->dirnames );
+}
+
+/*
+ * the capabilities of each selected item are computed as a bit field
+ */
+static GHashTable *
+classes_get_capabilities( SelectionClasses *classes )
+{
+	GList *it;
+	guint caps, cap;
+
+	if( !classes->capabilities ){
+		classes->capabilities = g_hash_table_new( g_direct_hash, g_direct_equal );
+
+		for( it = classes->selection ; it ; it = it->next ){
+			caps = 0;
+			for( cap = CAP_OWNER ; cap < CAP_UNKNOWN ; cap <<= 1 ){
+				if( is_capable( NA_SELECTED_INFO( it->data ), cap )){
+					caps |= cap;
+				}
+			}
+			g_hash_table_insert( classes->capabilities, GUINT_TO_POINTER( 1+caps ), GUINT_TO_POINTER( 1 ));
+
+			if( na_selected_info_is_unresolved( NA_SELECTED_INFO( it->data ))){
+				classes->unresolved = TRUE;
+			}
+		}
+	}
+
+	return( classes->capabilities );
+}
+
+/*
+ * the file type of the members of a mimetype class is only examined
+ * when a condition needs it
+ */
+static void
+mimetype_class_set_regular( MimetypeClass *class )
+{
+	GList *it;
+
+	if( !class->regular_done ){
+		for( it = class->files ; it && !( class->has_regular && class->has_other ) ; it = it->next ){
+			if( na_selected_info_is_regular( NA_SELECTED_INFO( it->data ))){
+				class->has_regular = TRUE;
+			} else {
+				class->has_other = TRUE;
+			}
+		}
+		class->regular_done = TRUE;
+	}
+}
+
+static void
+mimetype_class_free( MimetypeClass *class )
+{
+	g_list_free( class->files );
+	g_free( class );
+}
+
+static GHashTable *
+set_new( void )
+{
+	return( g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL ));
 }
 
 static gboolean
 is_valid_basenames( const NAIContext *object )
 {
 	gboolean valid;
-	GSList *basenames;
+	const GSList *basenames;
 
-	basenames = na_object_get_basenames( object );
-	valid = basenames && g_slist_length( basenames ) > 0;
-	na_core_utils_slist_free( basenames );
+	basenames = na_object_peek_basenames( object );
+	valid = ( basenames != NULL );
 
 	if( !valid ){
 		na_object_debug_invalid( object, "basenames" );
@@ -1189,11 +1915,11 @@ is_valid_mimetypes( const NAIContext *object )
 {
 	static const gchar *thisfn = "na_icontext_is_valid_mimetypes";
 	gboolean valid;
-	GSList *mimetypes, *it;
+	const GSList *mimetypes, *it;
 	guint count_ok, count_errs;
 	const gchar *imtype;
 
-	mimetypes = na_object_get_mimetypes( object );
+	mimetypes = na_object_peek_mimetypes( object );
 	count_ok = 0;
 	count_errs = 0;
 
@@ -1229,8 +1955,6 @@ is_valid_mimetypes( const NAIContext *object )
 		na_object_debug_invalid( object, "mimetypes" );
 	}
 
-	na_core_utils_slist_free( mimetypes );
-
 	return( valid );
 }
 
@@ -1238,11 +1962,10 @@ static gboolean
 is_valid_schemes( const NAIContext *object )
 {
 	gboolean valid;
-	GSList *schemes;
+	const GSList *schemes;
 
-	schemes = na_object_get_schemes( object );
-	valid = schemes && g_slist_length( schemes ) > 0;
-	na_core_utils_slist_free( schemes );
+	schemes = na_object_peek_schemes( object );
+	valid = ( schemes != NULL );
 
 	if( !valid ){
 		na_object_debug_invalid( object, "schemes" );
@@ -1255,11 +1978,10 @@ static gboolean
 is_valid_folders( const NAIContext *object )
 {
 	gboolean valid;
-	GSList *folders;
+	const GSList *folders;
 
-	folders = na_object_get_folders( object );
-	valid = folders && g_slist_length( folders ) > 0;
-	na_core_utils_slist_free( folders );
+	folders = na_object_peek_folders( object );
+	valid = ( folders != NULL );
 
 	if( !valid ){
 		na_object_debug_invalid( object, "folders" );
@@ -1288,3 +2010,346 @@ is_positive_assertion( const gchar *assertion )
 
 	return( positive );
 }
+
+/*
+ * returns the compiled conditions of the @context, compiling them if
+ * they have not been yet, or if they have been modified since the last
+ * compilation
+ */
+static ContextMatcher *
+get_context_matcher( const NAIContext *context )
+{
+	ContextMatcher *matcher;
+
+	matcher = ( ContextMatcher * ) g_object_get_data( G_OBJECT( context ), NA_ICONTEXT_DATA_MATCHER );
+
+	if( !matcher ){
+		matcher = matcher_new( context );
+		g_object_set_data_full( G_OBJECT( context ), NA_ICONTEXT_DATA_MATCHER, matcher, ( GDestroyNotify ) matcher_unref );
+	}
+
+	return( matcher );
+}
+
+/*
+ * compiles the conditions of the @context
+ *
+ * all data are read once here, so that candidate checks do not have
+ * anymore to duplicate them, nor to parse them
+ */
+static ContextMatcher *
+matcher_new( const NAIContext *context )
+{
+	static const gchar *thisfn = "na_icontext_matcher_new";
+	ContextMatcher *matcher;
+	const GSList *list;
+
+	g_debug( "%s: context=%p (%s)", thisfn, ( void * ) context, G_OBJECT_TYPE_NAME( context ));
+
+	matcher = g_new0( ContextMatcher, 1 );
+	matcher->ref_count = 1;
+
+	matcher->is_action = NA_IS_OBJECT_ACTION( context );
+	if( matcher->is_action ){
+		matcher->target_location = na_object_is_target_location( context );
+		matcher->target_selection = na_object_is_target_selection( context );
+		matcher->target_toolbar = na_object_is_target_toolbar( context );
+	}
+
+	matcher->only_show_in = na_object_get_only_show_in( context );
+	matcher->not_show_in = na_object_get_not_show_in( context );
+
+	matcher->try_exec = na_object_get_try_exec( context );
+	matcher->show_if_registered = na_object_get_show_if_registered( context );
+	matcher->show_if_true = na_object_get_show_if_true( context );
+	matcher->show_if_running = na_object_get_show_if_running( context );
+
+	/* empty strings are considered as unset
+	 */
+	if( matcher->try_exec && !strlen( matcher->try_exec )){
+		g_free( matcher->try_exec );
+		matcher->try_exec = NULL;
+	}
+	if( matcher->show_if_registered && !strlen( matcher->show_if_registered )){
+		g_free( matcher->show_if_registered );
+		matcher->show_if_registered = NULL;
+	}
+	if( matcher->show_if_true && !strlen( matcher->show_if_true )){
+		g_free( matcher->show_if_true );
+		matcher->show_if_true = NULL;
+	}
+	if( matcher->show_if_running && !strlen( matcher->show_if_running )){
+		g_free( matcher->show_if_running );
+		matcher->show_if_running = NULL;
+	}
+
+	matcher->all_mimetypes = na_object_get_all_mimetypes( context );
+	if( !matcher->all_mimetypes ){
+		matcher_split_mimetypes( matcher, na_object_peek_mimetypes( context ));
+	}
+
+	matcher->matchcase = na_object_get_matchcase( context );
+	list = na_object_peek_basenames( context );
+	matcher->all_basenames = matcher_is_all( list, "*" );
+	if( !matcher->all_basenames ){
+		matcher_split_basenames( matcher, list );
+	}
+
+	matcher_set_selection_count( matcher, na_object_peek_selection_count( context ));
+
+	list = na_object_peek_schemes( context );
+	matcher->all_schemes = matcher_is_all( list, "*" );
+	if( !matcher->all_schemes ){
+		matcher_split_schemes( matcher, list );
+	}
+
+	list = na_object_peek_folders( context );
+	matcher->all_folders = matcher_is_all( list, "/" );
+	if( !matcher->all_folders ){
+		matcher_split_folders( matcher, list );
+	}
+
+	matcher_set_capabilities( matcher, na_object_peek_capabilities( context ));
+
+	return( matcher );
+}
+
+static ContextMatcher *
+matcher_ref( ContextMatcher *matcher )
+{
+	matcher->ref_count += 1;
+
+	return( matcher );
+}
+
+static void
+matcher_unref( ContextMatcher *matcher )
+{
+	matcher->ref_count -= 1;
+
+	if( !matcher->ref_count ){
+		na_core_utils_slist_free( matcher->only_show_in );
+		na_core_utils_slist_free( matcher->not_show_in );
+		g_free( matcher->try_exec );
+		g_free( matcher->show_if_registered );
+		g_free( matcher->show_if_true );
+		g_free( matcher->show_if_running );
+		pattern_list_free( matcher->mimetypes_pos );
+		pattern_list_free( matcher->mimetypes_neg );
+		pattern_list_free( matcher->basenames_pos );
+		pattern_list_free( matcher->basenames_neg );
+		na_core_utils_slist_free( matcher->schemes_pos );
+		na_core_utils_slist_free( matcher->schemes_neg );
+		pattern_list_free( matcher->folders_pos );
+		pattern_list_free( matcher->folders_neg );
+		g_free( matcher );
+	}
+}
+
+/*
+ * an unset list, or a list with only the @all pattern, does not filter
+ * anything
+ */
+static gboolean
+matcher_is_all( const GSList *list, const gchar *all )
+{
+	return( !list || ( !list->next && !strcmp(( const gchar * ) list->data, all )));
+}
+
+static void
+matcher_split_mimetypes( ContextMatcher *matcher, const GSList *mimetypes )
+{
+	const GSList *im;
+	const gchar *imtype;
+	gboolean positive;
+	ContextPattern *pattern;
+
+	for( im = mimetypes ; im ; im = im->next ){
+		imtype = ( const gchar * ) im->data;
+		positive = is_positive_assertion( imtype );
+
+		pattern = g_new0( ContextPattern, 1 );
+		pattern->pattern = g_strdup( positive ? imtype : imtype+1 );
+		pattern->content_type = g_content_type_from_mime_type( pattern->pattern );
+		pattern->kind = get_mimetype_kind( pattern->pattern );
+
+		if( pattern->kind == MIMETYPE_KIND_FILES ){
+			matcher->mimetypes_regular = TRUE;
+		}
+
+		if( positive ){
+			matcher->mimetypes_pos = g_slist_append( matcher->mimetypes_pos, pattern );
+		} else {
+			matcher->mimetypes_neg = g_slist_append( matcher->mimetypes_neg, pattern );
+		}
+	}
+}
+
+/*
+ * if the basenames are not case sensitive, then the patterns are
+ * lowercased here, while the selected basenames will be lowercased at
+ * candidate check time
+ */
+static void
+matcher_split_basenames( ContextMatcher *matcher, const GSList *basenames )
+{
+	const GSList *ib;
+	gchar *lowered;
+	const gchar *str;
+	gboolean positive;
+	ContextPattern *pattern;
+
+	for( ib = basenames ; ib ; ib = ib->next ){
+		lowered = matcher->matchcase ?
+				g_strdup(( const gchar * ) ib->data ) :
+				g_utf8_strdown(( const gchar * ) ib->data, -1 );
+		positive = is_positive_assertion( lowered );
+		str = positive ? lowered : lowered+1;
+
+		pattern = g_new0( ContextPattern, 1 );
+		pattern->pattern = g_filename_to_utf8( str, -1, NULL, NULL, NULL );
+		if( pattern->pattern ){
+			pattern->spec = g_pattern_spec_new( pattern->pattern );
+		}
+
+		if( positive ){
+			matcher->basenames_pos = g_slist_append( matcher->basenames_pos, pattern );
+		} else {
+			matcher->basenames_neg = g_slist_append( matcher->basenames_neg, pattern );
+		}
+
+		g_free( lowered );
+	}
+}
+
+static void
+matcher_split_schemes( ContextMatcher *matcher, const GSList *schemes )
+{
+	const GSList *is;
+	const gchar *str;
+
+	for( is = schemes ; is ; is = is->next ){
+		str = ( const gchar * ) is->data;
+
+		if( is_positive_assertion( str )){
+			matcher->schemes_pos = g_slist_append( matcher->schemes_pos, g_strdup( str ));
+		} else {
+			matcher->schemes_neg = g_slist_append( matcher->schemes_neg, g_strdup( str+1 ));
+		}
+	}
+}
+
+/*
+ * folders are always compared as a prefix of the selected dirname,
+ * and also as a pattern when they contain a wildcard
+ */
+static void
+matcher_split_folders( ContextMatcher *matcher, const GSList *folders )
+{
+	const GSList *id;
+	const gchar *str;
+	gboolean positive;
+	ContextPattern *pattern;
+
+	for( id = folders ; id ; id = id->next ){
+		str = ( const gchar * ) id->data;
+		positive = is_positive_assertion( str );
+
+		pattern = g_new0( ContextPattern, 1 );
+		pattern->pattern = g_filename_to_utf8( positive ? str : str+1, -1, NULL, NULL, NULL );
+		if( pattern->pattern && g_strstr_len( pattern->pattern, -1, "*" )){
+			pattern->spec = g_pattern_spec_new( pattern->pattern );
+		}
+
+		if( positive ){
+			matcher->folders_pos = g_slist_append( matcher->folders_pos, pattern );
+		} else {
+			matcher->folders_neg = g_slist_append( matcher->folders_neg, pattern );
+		}
+	}
+}
+
+static void
+matcher_set_selection_count( ContextMatcher *matcher, const gchar *selection_count )
+{
+	matcher->count_op = COUNT_NONE;
+
+	if( selection_count && strlen( selection_count )){
+		matcher->count_limit = atoi( selection_count+1 );
+
+		switch( selection_count[0] ){
+			case '<':
+				matcher->count_op = COUNT_LESS;
+				break;
+			case '=':
+				matcher->count_op = COUNT_EQUAL;
+				break;
+			case '>':
+				matcher->count_op = COUNT_GREATER;
+				break;
+			default:
+				matcher->count_op = COUNT_INVALID;
+				break;
+		}
+	}
+}
+
+static void
+matcher_set_capabilities( ContextMatcher *matcher, const GSList *capabilities )
+{
+	static const gchar *thisfn = "na_icontext_matcher_set_capabilities";
+	const GSList *ic;
+	const gchar *cap, *name;
+	gboolean positive;
+	guint bit;
+
+	for( ic = capabilities ; ic ; ic = ic->next ){
+		cap = ( const gchar * ) ic->data;
+		positive = is_positive_assertion( cap );
+		name = positive ? cap : cap+1;
+
+		if( !strcmp( name, "Owner" )){
+			bit = CAP_OWNER;
+
+		} else if( !strcmp( name, "Readable" )){
+			bit = CAP_READABLE;
+
+		} else if( !strcmp( name, "Writable" )){
+			bit = CAP_WRITABLE;
+
+		} else if( !strcmp( name, "Executable" )){
+			bit = CAP_EXECUTABLE;
+
+		} else if( !strcmp( name, "Local" )){
+			bit = CAP_LOCAL;
+
+		} else {
+			g_warning( "%s: unknown capability %s", thisfn, cap );
+			bit = CAP_UNKNOWN;
+		}
+
+		if( positive ){
+			matcher->caps_pos |= bit;
+		} else {
+			matcher->caps_neg |= bit;
+		}
+	}
+}
+
+static void
+pattern_list_free( GSList *patterns )
+{
+	g_slist_foreach( patterns, ( GFunc ) pattern_free, NULL );
+	g_slist_free( patterns );
+}
+
+static void
+pattern_free( ContextPattern *pattern )
+{
+	if( pattern->spec ){
+		g_pattern_spec_free( pattern->spec );
+	}
+	g_free( pattern->content_type );
+	g_free( pattern->pattern );
+	g_free( pattern );
+}
@@ -0,0 +1,146 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2014 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "na-intern.h"
+
+/* st_pool: string -> reference count, updated in place
+ *
+ * st_mutex protects st_pool, as the selected items may be built from
+ * any thread
+ */
+#if GLIB_CHECK_VERSION( 2, 32, 0 )
+static GMutex      st_mutex_struct;
+#endif
+
+static GMutex     *st_mutex = NULL;
+static GHashTable *st_pool  = NULL;
+
+static void intern_init( void );
+
+/*
+ * na_intern_ref:
+ * @str: a string, may be %NULL.
+ *
+ * Returns: the interned copy of @str, or %NULL if @str is %NULL.
+ *
+ * The returned string is owned by the pool, and must not be modified.
+ * It should be released with na_intern_unref().
+ */
+const gchar *
+na_intern_ref( const gchar *str )
+{
+	gpointer key, value;
+	gchar *interned;
+	guint *count;
+
+	if( !str ){
+		return( NULL );
+	}
+
+	intern_init();
+
+	g_mutex_lock( st_mutex );
+
+	if( g_hash_table_lookup_extended( st_pool, str, &key, &value )){
+		interned = ( gchar * ) key;
+		count = ( guint * ) value;
+		*count += 1;
+
+	} else {
+		interned = g_strdup( str );
+		count = g_new( guint, 1 );
+		*count = 1;
+		g_hash_table_insert( st_pool, interned, count );
+	}
+
+	g_mutex_unlock( st_mutex );
+
+	return( interned );
+}
+
+/*
+ * na_intern_unref:
+ * @str: a string returned by na_intern_ref(), may be %NULL.
+ *
+ * Releases a reference on @str, which is removed from the pool when
+ * its last reference is released.
+ */
+void
+na_intern_unref( const gchar *str )
+{
+	static const gchar *thisfn = "na_intern_unref";
+	gpointer key, value;
+	guint *count;
+
+	if( !str ){
+		return;
+	}
+
+	intern_init();
+
+	g_mutex_lock( st_mutex );
+
+	if( g_hash_table_lookup_extended( st_pool, str, &key, &value ) && key == ( gpointer ) str ){
+		count = ( guint * ) value;
+		*count -= 1;
+
+		if( !*count ){
+			g_hash_table_remove( st_pool, key );
+		}
+
+	} else {
+		g_warning( "%s: str=%p (%s) is not interned", thisfn, ( void * ) str, str );
+	}
+
+	g_mutex_unlock( st_mutex );
+}
+
+/*
+ * may be first called concurrently from several threads
+ */
+static void
+intern_init( void )
+{
+	static gsize initialized = 0;
+
+	if( g_once_init_enter( &initialized )){
+#if GLIB_CHECK_VERSION( 2, 32, 0 )
+		g_mutex_init( &st_mutex_struct );
+		st_mutex = &st_mutex_struct;
+#else
+		st_mutex = g_mutex_new();
+#endif
+		st_pool = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, g_free );
+		g_once_init_leave( &initialized, 1 );
+	}
+}
@@ -0,0 +1,60 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2014 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_NA_INTERN_H__
+#define __CORE_NA_INTERN_H__
+
+/* @title: NAIntern
+ * @short_description: A process-wide pool of reference-counted strings.
+ * @include: core/na-intern.h
+ *
+ * The fields of the selected items are very repetitive: all items of a
+ * selection most often share the same scheme, the same dirname, the
+ * same owner and a few mimetypes. Rather than each item, and then each
+ * #NATokens, holding its own copy of these strings, they are stored
+ * once in the pool.
+ *
+ * Contrarily to g_intern_string(), a string is removed from the pool
+ * when its last reference is released, so that the pool does not grow
+ * with each visited folder.
+ *
+ * Two interned strings are equal if and only if they are the same
+ * pointer.
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+const gchar *na_intern_ref  ( const gchar *str );
+void         na_intern_unref( const gchar *str );
+
+G_END_DECLS
+
+#endif /* __CORE_NA_INTERN_H__ */
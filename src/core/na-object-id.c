@@ -201,18 +201,7 @@ instance_finalize( GObject *object )
 gint
 na_object_id_sort_alpha_asc( const NAObjectId *a, const NAObjectId *b )
 {
-	gchar *label_a, *label_b;
-	gint compare;
-
-	label_a = na_object_get_label( a );
-	label_b = na_object_get_label( b );
-
-	compare = na_core_utils_str_collate( label_a, label_b );
-
-	g_free( label_b );
-	g_free( label_a );
-
-	return( compare );
+	return( na_core_utils_str_collate( na_object_peek_label( a ), na_object_peek_label( b )));
 }
 
 /**
@@ -308,6 +308,35 @@ static NADataDef data_def_profile [] = {
 				NULL,
 				NULL },
 
+	{ NAFO_DATA_EXECUTION_CHUNKED,
+				TRUE,
+				TRUE,
+				TRUE,
+				N_( "Chunked execution" ),
+				N_( "Whether a command which holds a plural parameter should be split " \
+					"in several command lines which each fit in the system limits, " \
+					"and be ran through a bounded pool of concurrent children. " \
+					"The %c parameter is then the count of the items of each " \
+					"command line.\n" \
+					"A command which holds a singular parameter is then also ran " \
+					"through this pool.\n" \
+					"Defaults to FALSE." ),
+				NA_DATA_TYPE_BOOLEAN,
+				"false",
+				FALSE,
+				TRUE,
+				TRUE,
+				FALSE,
+				FALSE,
+				"execution-chunked",
+				"ExecutionChunked",
+				0,
+				NULL,
+				0,
+				0,
+				NULL,
+				NULL },
+
 	{ NULL },
 };
 
@@ -39,6 +39,7 @@
 #include "na-io-provider.h"
 #include "na-module.h"
 #include "na-pivot.h"
+#include "na-selected-info.h"
 
 /* private class data
  */
@@ -46,6 +47,23 @@ struct _NAPivotClassPrivate {
 	void *empty;						/* so that gcc -pedantic is happy */
 };
 
+/* an index of the items tree
+ *
+ * each item, whatever be its level in the tree, is registered for each
+ * key it may be candidate for, or in the 'any' list if it may be
+ * candidate whatever be the selection regarding this index
+ *
+ * indexed items are not reffed: the index is reset each time the items
+ * tree is replaced
+ */
+typedef struct {
+	GHashTable *keys;					/* key -> GList of NAObjectItem's */
+	GList      *any;
+}
+	PivotIndex;
+
+#define PIVOT_INDEX_N					3
+
 /* private instance data
  */
 struct _NAPivotPrivate {
@@ -64,6 +82,16 @@ struct _NAPivotPrivate {
 	/* timeout to manage i/o providers 'item-changed' burst
 	 */
 	NATimeout   change_timeout;
+
+	/* index of the items tree, built on demand
+	 * the mimetype lookups memoize the items found for each file mimetype
+	 * the file type is only taken into account when an item needs it,
+	 * so that the attributes of the selected files are not queried else
+	 */
+	gboolean    index_built;
+	gboolean    index_file_type;
+	PivotIndex  index[ PIVOT_INDEX_N ];
+	GHashTable *mimetype_lookups;
 };
 
 /* NAPivot properties
@@ -100,6 +128,20 @@ static void          instance_finalize( GObject *object );
 
 static NAObjectItem *get_item_from_tree( const NAPivot *pivot, GList *tree, const gchar *id );
 
+static void          index_build( NAPivot *pivot );
+static void          index_build_rec( NAPivot *pivot, GList *tree );
+static gboolean      index_get_item_keys( const NAObjectItem *item, NAIContextIndex idx, GSList **keys );
+static void          index_reset( NAPivot *pivot );
+static GHashTable   *index_get_accepted( NAPivot *pivot, NAIContextIndex idx, NASelectedInfo *nsi );
+static GList        *index_lookup_mimetype( NAPivot *pivot, const gchar *mimetype, gboolean is_regular );
+static void          index_add_items( GHashTable *set, GList *items );
+static GHashTable   *index_intersect( GHashTable *result, GHashTable *accepted );
+static gboolean      index_is_not_accepted( gpointer key, gpointer value, GHashTable *accepted );
+static gchar        *index_get_file_key( NAPivot *pivot, NAIContextIndex idx, NASelectedInfo *nsi );
+static gboolean     index_is_regular( NAPivot *pivot, NASelectedInfo *nsi );
+static gboolean     index_needs_attributes( const NAObjectItem *item );
+static void          index_free_bucket( gpointer key, GList *items, gpointer user_data );
+
 /* NAIIOProvider management */
 static void          on_items_changed_timeout( NAPivot *pivot );
 
@@ -199,6 +241,7 @@ instance_init( GTypeInstance *instance, gpointer klass )
 {
 	static const gchar *thisfn = "na_pivot_instance_init";
 	NAPivot *self;
+	guint i;
 
 	g_return_if_fail( NA_IS_PIVOT( instance ));
 
@@ -220,6 +263,13 @@ instance_init( GTypeInstance *instance, gpointer klass )
 	self->private->change_timeout.handler = ( NATimeoutFunc ) on_items_changed_timeout;
 	self->private->change_timeout.user_data = self;
 	self->private->change_timeout.source_id = 0;
+
+	self->private->index_built = FALSE;
+	for( i = 0 ; i < PIVOT_INDEX_N ; ++i ){
+		self->private->index[i].keys = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+		self->private->index[i].any = NULL;
+	}
+	self->private->mimetype_lookups = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, ( GDestroyNotify ) g_list_free );
 }
 
 static void
@@ -293,6 +343,7 @@ instance_set_property( GObject *object, guint property_id, const GValue *value,
 
 			case PIVOT_PROP_TREE_ID:
 				self->private->tree = g_value_get_pointer( value );
+				index_reset( self );
 				break;
 
 			default:
@@ -327,6 +378,7 @@ instance_dispose( GObject *object )
 				( void * ) self->private->tree, g_list_length( self->private->tree ));
 		na_object_dump_tree( self->private->tree );
 		self->private->tree = na_object_free_items( self->private->tree );
+		index_reset( self );
 
 		/* release the settings */
 		na_settings_free();
@@ -346,6 +398,7 @@ instance_finalize( GObject *object )
 {
 	static const gchar *thisfn = "na_pivot_instance_finalize";
 	NAPivot *self;
+	guint i;
 
 	g_return_if_fail( NA_IS_PIVOT( object ));
 
@@ -353,6 +406,11 @@ instance_finalize( GObject *object )
 
 	self = NA_PIVOT( object );
 
+	for( i = 0 ; i < PIVOT_INDEX_N ; ++i ){
+		g_hash_table_destroy( self->private->index[i].keys );
+	}
+	g_hash_table_destroy( self->private->mimetype_lookups );
+
 	g_free( self->private );
 
 	/* chain call to parent class */
@@ -571,6 +629,7 @@ na_pivot_load_items( NAPivot *pivot )
 		messages = NULL;
 		na_object_free_items( pivot->private->tree );
 		pivot->private->tree = na_io_provider_load_items( pivot, pivot->private->loadable_set, &messages );
+		index_reset( pivot );
 
 		for( im = messages ; im ; im = im->next ){
 			g_warning( "%s: %s", thisfn, ( const gchar * ) im->data );
@@ -580,6 +639,376 @@ na_pivot_load_items( NAPivot *pivot )
 	}
 }
 
+/*
+ * na_pivot_get_candidates:
+ * @pivot: this #NAPivot instance.
+ * @selection: the current selection, as a list of #NASelectedInfo.
+ *
+ * Intersects the index of the items tree with the mimetypes, schemes
+ * and extensions of the @selection.
+ *
+ * The index is only a first filter: the returned items have still to
+ * be checked with na_icontext_is_candidate(), but the items which are
+ * not returned are sure not to be candidate. A menu is returned as soon
+ * as one of its children may be candidate.
+ *
+ * Returns: the set of #NAObjectItem items, whatever be their level in
+ * the tree, which may be candidate for this @selection, as a #GHashTable
+ * which should be g_hash_table_destroy() by the caller, or %NULL if
+ * the set cannot be restricted.
+ */
+GHashTable *
+na_pivot_get_candidates( NAPivot *pivot, GList *selection )
+{
+	static const gchar *thisfn = "na_pivot_get_candidates";
+	GHashTable *result, *seen;
+	GList *it;
+	guint idx;
+	gchar *key;
+
+	g_return_val_if_fail( NA_IS_PIVOT( pivot ), NULL );
+
+	result = NULL;
+
+	if( !pivot->private->dispose_has_run ){
+
+		if( !pivot->private->index_built ){
+			index_build( pivot );
+		}
+
+		/* only distinct keys of the selection have to be checked
+		 */
+		for( idx = ICONTEXT_INDEX_MIMETYPES ; idx <= ICONTEXT_INDEX_EXTENSIONS ; ++idx ){
+			seen = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+
+			for( it = selection ; it && ( !result || g_hash_table_size( result )) ; it = it->next ){
+				key = index_get_file_key( pivot, idx, NA_SELECTED_INFO( it->data ));
+
+				if( g_hash_table_lookup_extended( seen, key, NULL, NULL )){
+					g_free( key );
+
+				} else {
+					g_hash_table_insert( seen, key, NULL );
+					result = index_intersect( result, index_get_accepted( pivot, idx, NA_SELECTED_INFO( it->data )));
+				}
+			}
+
+			g_hash_table_destroy( seen );
+		}
+
+		g_debug( "%s: pivot=%p, selection_count=%u, candidates_count=%d",
+				thisfn, ( void * ) pivot, g_list_length( selection ), result ? ( gint ) g_hash_table_size( result ) : -1 );
+	}
+
+	return( result );
+}
+
+static void
+index_build( NAPivot *pivot )
+{
+	static const gchar *thisfn = "na_pivot_index_build";
+
+	index_build_rec( pivot, pivot->private->tree );
+	pivot->private->index_built = TRUE;
+
+	g_debug( "%s: pivot=%p, mimetypes=%u, schemes=%u, extensions=%u",
+			thisfn, ( void * ) pivot,
+			g_hash_table_size( pivot->private->index[ICONTEXT_INDEX_MIMETYPES-1].keys ),
+			g_hash_table_size( pivot->private->index[ICONTEXT_INDEX_SCHEMES-1].keys ),
+			g_hash_table_size( pivot->private->index[ICONTEXT_INDEX_EXTENSIONS-1].keys ));
+}
+
+static void
+index_build_rec( NAPivot *pivot, GList *tree )
+{
+	GList *it, *bucket;
+	GSList *keys, *ik;
+	NAObjectItem *item;
+	PivotIndex *index;
+	guint idx;
+
+	for( it = tree ; it ; it = it->next ){
+		if( NA_IS_OBJECT_ITEM( it->data )){
+			item = NA_OBJECT_ITEM( it->data );
+
+			if( !pivot->private->index_file_type ){
+				pivot->private->index_file_type = index_needs_attributes( item );
+			}
+
+			for( idx = ICONTEXT_INDEX_MIMETYPES ; idx <= ICONTEXT_INDEX_EXTENSIONS ; ++idx ){
+				index = &pivot->private->index[idx-1];
+
+				if( index_get_item_keys( item, idx, &keys )){
+					for( ik = keys ; ik ; ik = ik->next ){
+						bucket = ( GList * ) g_hash_table_lookup( index->keys, ik->data );
+						if( !bucket || bucket->data != ( gpointer ) item ){
+							g_hash_table_insert( index->keys, g_strdup(( const gchar * ) ik->data ), g_list_prepend( bucket, item ));
+						}
+					}
+					na_core_utils_slist_free( keys );
+
+				} else {
+					index->any = g_list_prepend( index->any, item );
+				}
+			}
+
+			if( NA_IS_OBJECT_MENU( item )){
+				index_build_rec( pivot, na_object_get_items( item ));
+			}
+		}
+	}
+}
+
+/*
+ * an item is restricted by its own conditions if any, else by the
+ * conditions of its children: an action may only be candidate if one
+ * of its profiles is, a menu is only displayed if one of its subitems
+ * is candidate
+ */
+static gboolean
+index_get_item_keys( const NAObjectItem *item, NAIContextIndex idx, GSList **keys )
+{
+	gboolean restricted, sub_restricted;
+	GSList *sub_keys;
+	GList *it;
+
+	restricted = na_icontext_get_index_keys( NA_ICONTEXT( item ), idx, keys );
+
+	if( !restricted ){
+		restricted = TRUE;
+
+		for( it = na_object_get_items( item ) ; it && restricted ; it = it->next ){
+			if( NA_IS_OBJECT_ITEM( it->data )){
+				sub_restricted = index_get_item_keys( NA_OBJECT_ITEM( it->data ), idx, &sub_keys );
+			} else {
+				sub_restricted = na_icontext_get_index_keys( NA_ICONTEXT( it->data ), idx, &sub_keys );
+			}
+
+			if( sub_restricted ){
+				*keys = g_slist_concat( *keys, sub_keys );
+			} else {
+				restricted = FALSE;
+			}
+		}
+
+		if( !restricted ){
+			na_core_utils_slist_free( *keys );
+			*keys = NULL;
+		}
+	}
+
+	return( restricted );
+}
+
+static void
+index_reset( NAPivot *pivot )
+{
+	guint i;
+
+	for( i = 0 ; i < PIVOT_INDEX_N ; ++i ){
+		g_hash_table_foreach( pivot->private->index[i].keys, ( GHFunc ) index_free_bucket, NULL );
+		g_hash_table_remove_all( pivot->private->index[i].keys );
+		g_list_free( pivot->private->index[i].any );
+		pivot->private->index[i].any = NULL;
+	}
+
+	g_hash_table_remove_all( pivot->private->mimetype_lookups );
+	pivot->private->index_built = FALSE;
+	pivot->private->index_file_type = FALSE;
+}
+
+/*
+ * returns the set of items which accept this selected item regarding
+ * the @idx index
+ */
+static GHashTable *
+index_get_accepted( NAPivot *pivot, NAIContextIndex idx, NASelectedInfo *nsi )
+{
+	GHashTable *accepted;
+	PivotIndex *index;
+	gchar *str, *utf8, *lowered, *dot;
+
+	accepted = g_hash_table_new( g_direct_hash, g_direct_equal );
+	index = &pivot->private->index[idx-1];
+	index_add_items( accepted, index->any );
+
+	switch( idx ){
+		case ICONTEXT_INDEX_MIMETYPES:
+			str = na_selected_info_get_mime_type( nsi );
+			if( str ){
+				index_add_items( accepted, index_lookup_mimetype( pivot, str, index_is_regular( pivot, nsi )));
+			}
+			g_free( str );
+			break;
+
+		case ICONTEXT_INDEX_SCHEMES:
+			str = na_selected_info_get_uri_scheme( nsi );
+			if( str ){
+				index_add_items( accepted, ( GList * ) g_hash_table_lookup( index->keys, str ));
+			}
+			g_free( str );
+			break;
+
+		/* a '*.ext' pattern matches a basename if 'ext' is found after
+		 * any of its dots; case insensitive patterns have been lowered
+		 */
+		case ICONTEXT_INDEX_EXTENSIONS:
+			str = na_selected_info_get_basename( nsi );
+			utf8 = str ? g_filename_to_utf8( str, -1, NULL, NULL, NULL ) : NULL;
+			if( utf8 ){
+				lowered = g_utf8_strdown( utf8, -1 );
+				for( dot = strchr( utf8, '.' ) ; dot ; dot = strchr( dot+1, '.' )){
+					index_add_items( accepted, ( GList * ) g_hash_table_lookup( index->keys, dot+1 ));
+				}
+				for( dot = strchr( lowered, '.' ) ; dot ; dot = strchr( dot+1, '.' )){
+					index_add_items( accepted, ( GList * ) g_hash_table_lookup( index->keys, dot+1 ));
+				}
+				g_free( lowered );
+			}
+			g_free( utf8 );
+			g_free( str );
+			break;
+	}
+
+	return( accepted );
+}
+
+/*
+ * the items whose mimetypes conditions match a file mimetype are
+ * computed once, and then memoized until the index be reset
+ */
+static GList *
+index_lookup_mimetype( NAPivot *pivot, const gchar *mimetype, gboolean is_regular )
+{
+	GList *items;
+	gchar *key;
+	GHashTableIter iter;
+	gpointer pattern, bucket;
+
+	key = g_strdup_printf( "%d%s", is_regular ? 1 : 0, mimetype );
+
+	if( g_hash_table_lookup_extended( pivot->private->mimetype_lookups, key, NULL, ( gpointer * ) &items )){
+		g_free( key );
+
+	} else {
+		items = NULL;
+		g_hash_table_iter_init( &iter, pivot->private->index[ICONTEXT_INDEX_MIMETYPES-1].keys );
+
+		while( g_hash_table_iter_next( &iter, &pattern, &bucket )){
+			if( na_icontext_is_mimetype_of( mimetype, ( const gchar * ) pattern, is_regular )){
+				items = g_list_concat( items, g_list_copy(( GList * ) bucket ));
+			}
+		}
+
+		g_hash_table_insert( pivot->private->mimetype_lookups, key, items );
+	}
+
+	return( items );
+}
+
+static void
+index_add_items( GHashTable *set, GList *items )
+{
+	GList *it;
+
+	for( it = items ; it ; it = it->next ){
+		g_hash_table_insert( set, it->data, it->data );
+	}
+}
+
+/*
+ * takes ownership of @accepted
+ */
+static GHashTable *
+index_intersect( GHashTable *result, GHashTable *accepted )
+{
+	if( !result ){
+		return( accepted );
+	}
+
+	g_hash_table_foreach_remove( result, ( GHRFunc ) index_is_not_accepted, accepted );
+	g_hash_table_destroy( accepted );
+
+	return( result );
+}
+
+static gboolean
+index_is_not_accepted( gpointer key, gpointer value, GHashTable *accepted )
+{
+	return( g_hash_table_lookup( accepted, key ) == NULL );
+}
+
+/*
+ * two selected items which have the same key are accepted by the same
+ * set of items
+ */
+static gchar *
+index_get_file_key( NAPivot *pivot, NAIContextIndex idx, NASelectedInfo *nsi )
+{
+	gchar *key, *str, *dot;
+
+	key = NULL;
+
+	switch( idx ){
+		case ICONTEXT_INDEX_MIMETYPES:
+			str = na_selected_info_get_mime_type( nsi );
+			key = g_strdup_printf( "%d%s", index_is_regular( pivot, nsi ) ? 1 : 0, str ? str : "" );
+			g_free( str );
+			break;
+
+		case ICONTEXT_INDEX_SCHEMES:
+			str = na_selected_info_get_uri_scheme( nsi );
+			key = g_strdup( str ? str : "" );
+			g_free( str );
+			break;
+
+		case ICONTEXT_INDEX_EXTENSIONS:
+			str = na_selected_info_get_basename( nsi );
+			dot = str ? strchr( str, '.' ) : NULL;
+			key = g_strdup( dot ? dot : "" );
+			g_free( str );
+			break;
+	}
+
+	return( key );
+}
+
+/*
+ * the file type is not relevant when no item targets 'allfiles'
+ */
+static gboolean
+index_is_regular( NAPivot *pivot, NASelectedInfo *nsi )
+{
+	return( pivot->private->index_file_type && na_selected_info_is_regular( nsi ));
+}
+
+/*
+ * whether the item, or one of its profiles, depends on the attributes
+ * of the selected files; subitems of a menu are examined on their own
+ */
+static gboolean
+index_needs_attributes( const NAObjectItem *item )
+{
+	gboolean needs;
+	GList *it;
+
+	needs = na_icontext_needs_attributes( NA_ICONTEXT( item ));
+
+	for( it = na_object_get_items( item ) ; it && !needs ; it = it->next ){
+		if( !NA_IS_OBJECT_ITEM( it->data )){
+			needs = na_icontext_needs_attributes( NA_ICONTEXT( it->data ));
+		}
+	}
+
+	return( needs );
+}
+
+static void
+index_free_bucket( gpointer key, GList *items, gpointer user_data )
+{
+	g_list_free( items );
+}
+
 /*
  * na_pivot_set_new_items:
  * @pivot: this #NAPivot instance.
@@ -602,6 +1031,7 @@ na_pivot_set_new_items( NAPivot *pivot, GList *items )
 
 		na_object_free_items( pivot->private->tree );
 		pivot->private->tree = items;
+		index_reset( pivot );
 	}
 }
 
@@ -0,0 +1,281 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2014 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+#include <sys/types.h>
+#include <glibtop/proclist.h>
+#include <glibtop/procstate.h>
+
+#include "na-process-snapshot.h"
+
+/* the snapshot is a set of command names, as returned by libgtop
+ *
+ * st_mutex protects the snapshot itself, while st_build_mutex serializes
+ * the calls to libgtop, which is not thread-safe; the snapshot is only
+ * replaced when a new one has been fully built, so that readers are never
+ * blocked by a build
+ */
+#if GLIB_CHECK_VERSION( 2, 32, 0 )
+static GMutex      st_mutex_struct;
+static GMutex      st_build_mutex_struct;
+#endif
+
+static GMutex     *st_mutex       = NULL;
+static GMutex     *st_build_mutex = NULL;
+static GHashTable *st_commands    = NULL;
+static gint64      st_built       = 0;		/* monotonic time of the last build */
+static gint64      st_build_cost  = 0;		/* duration of the last build (us) */
+
+static void        snapshot_init( void );
+static gint64      get_monotonic_time( void );
+static gboolean    is_fresh( gint64 max_age );
+static GHashTable *snapshot_build( void );
+static gchar      *get_searched_name( const gchar *command );
+
+/*
+ * na_process_snapshot_is_running:
+ * @command: the path or the name of an executable.
+ * @max_age: the maximal age of the snapshot (us).
+ *
+ * Returns: %TRUE if a process runs @command, %FALSE else.
+ *
+ * The snapshot is rebuilt if it is older than @max_age.
+ */
+gboolean
+na_process_snapshot_is_running( const gchar *command, gint64 max_age )
+{
+	static const gchar *thisfn = "na_process_snapshot_is_running";
+	gboolean running, fresh;
+	GHashTable *commands;
+	gint64 start;
+
+	g_return_val_if_fail( command && strlen( command ), FALSE );
+
+	snapshot_init();
+
+	if( na_process_snapshot_peek( command, max_age, &running )){
+		return( running );
+	}
+
+	g_mutex_lock( st_build_mutex );
+
+	/* another thread may have rebuilt the snapshot while we were waiting */
+	g_mutex_lock( st_mutex );
+	fresh = is_fresh( max_age );
+	g_mutex_unlock( st_mutex );
+
+	if( !fresh ){
+		start = get_monotonic_time();
+		commands = snapshot_build();
+
+		g_mutex_lock( st_mutex );
+		if( st_commands ){
+			g_hash_table_destroy( st_commands );
+		}
+		st_commands = commands;
+		st_built = get_monotonic_time();
+		st_build_cost = st_built - start;
+		g_debug( "%s: %u commands, build cost=%" G_GINT64_FORMAT " us",
+				thisfn, g_hash_table_size( st_commands ), st_build_cost );
+		g_mutex_unlock( st_mutex );
+	}
+
+	g_mutex_unlock( st_build_mutex );
+
+	running = FALSE;
+	na_process_snapshot_peek( command, -1, &running );
+
+	return( running );
+}
+
+/*
+ * na_process_snapshot_peek:
+ * @command: the path or the name of an executable.
+ * @max_age: the maximal age of the snapshot (us), or -1 for any age.
+ * @running: [out]: whether a process runs @command.
+ *
+ * Returns: %TRUE if the snapshot is not older than @max_age, and @running
+ * has been set, %FALSE else.
+ *
+ * This function never rebuilds the snapshot, and so may be called from
+ * the main thread.
+ */
+gboolean
+na_process_snapshot_peek( const gchar *command, gint64 max_age, gboolean *running )
+{
+	gboolean found;
+	gchar *searched;
+
+	g_return_val_if_fail( command && strlen( command ), FALSE );
+	g_return_val_if_fail( running, FALSE );
+
+	snapshot_init();
+
+	found = FALSE;
+	searched = get_searched_name( command );
+
+	g_mutex_lock( st_mutex );
+
+	if( st_commands && ( max_age < 0 || is_fresh( max_age ))){
+		*running = ( g_hash_table_lookup( st_commands, searched ) != NULL );
+		found = TRUE;
+	}
+
+	g_mutex_unlock( st_mutex );
+
+	g_free( searched );
+
+	return( found );
+}
+
+/*
+ * na_process_snapshot_get_age:
+ *
+ * Returns: the age of the current snapshot (us), or -1 if there is not
+ * yet any.
+ */
+gint64
+na_process_snapshot_get_age( void )
+{
+	gint64 age;
+
+	snapshot_init();
+
+	g_mutex_lock( st_mutex );
+	age = st_commands ? get_monotonic_time() - st_built : -1;
+	g_mutex_unlock( st_mutex );
+
+	return( age );
+}
+
+/*
+ * na_process_snapshot_get_build_cost:
+ *
+ * Returns: the time spent to build the current snapshot (us).
+ */
+gint64
+na_process_snapshot_get_build_cost( void )
+{
+	gint64 cost;
+
+	snapshot_init();
+
+	g_mutex_lock( st_mutex );
+	cost = st_build_cost;
+	g_mutex_unlock( st_mutex );
+
+	return( cost );
+}
+
+/*
+ * may be first called concurrently from several threads, as the
+ * dynamic conditions are evaluated by the worker threads
+ */
+static void
+snapshot_init( void )
+{
+	static gsize initialized = 0;
+
+	if( g_once_init_enter( &initialized )){
+#if GLIB_CHECK_VERSION( 2, 32, 0 )
+		g_mutex_init( &st_mutex_struct );
+		g_mutex_init( &st_build_mutex_struct );
+		st_build_mutex = &st_build_mutex_struct;
+		st_mutex = &st_mutex_struct;
+#else
+		st_build_mutex = g_mutex_new();
+		st_mutex = g_mutex_new();
+#endif
+		g_once_init_leave( &initialized, 1 );
+	}
+}
+
+static gint64
+get_monotonic_time( void )
+{
+#if GLIB_CHECK_VERSION( 2, 28, 0 )
+	return( g_get_monotonic_time());
+#else
+	GTimeVal now;
+
+	g_get_current_time( &now );
+
+	return(( gint64 ) now.tv_sec * G_USEC_PER_SEC + now.tv_usec );
+#endif
+}
+
+/*
+ * st_mutex must be locked
+ */
+static gboolean
+is_fresh( gint64 max_age )
+{
+	return( st_commands && get_monotonic_time() - st_built <= max_age );
+}
+
+/*
+ * walks once through the process table - st_build_mutex must be locked
+ */
+static GHashTable *
+snapshot_build( void )
+{
+	GHashTable *commands;
+	glibtop_proclist proclist;
+	glibtop_proc_state procstate;
+	pid_t *pid_list;
+	guint i;
+
+	commands = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, NULL );
+
+	pid_list = glibtop_get_proclist( &proclist, GLIBTOP_KERN_PROC_ALL, 0 );
+
+	for( i=0 ; i<proclist.number ; ++i ){
+		glibtop_get_proc_state( &procstate, pid_list[i] );
+		if( !g_hash_table_lookup( commands, procstate.cmd )){
+			g_hash_table_insert( commands, g_strdup( procstate.cmd ), GUINT_TO_POINTER( 1 ));
+		}
+	}
+
+	g_free( pid_list );
+
+	return( commands );
+}
+
+/*
+ * the process table only knows about the basename of the commands
+ */
+static gchar *
+get_searched_name( const gchar *command )
+{
+	return( g_path_get_basename( command ));
+}
@@ -0,0 +1,57 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2014 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_NA_PROCESS_SNAPSHOT_H__
+#define __CORE_NA_PROCESS_SNAPSHOT_H__
+
+/* @title: Process snapshot
+ * @short_description: A snapshot of the names of the running commands.
+ * @include: core/na-process-snapshot.h
+ *
+ * ShowIfRunning conditions are checked against a snapshot of the process
+ * table, which is stored as a set of command names. The snapshot is only
+ * rebuilt when it is older than the maximal age requested by the caller,
+ * so that each ShowIfRunning check is a hash lookup.
+ *
+ * All the functions are thread-safe.
+ */
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+gboolean na_process_snapshot_is_running    ( const gchar *command, gint64 max_age );
+gboolean na_process_snapshot_peek          ( const gchar *command, gint64 max_age, gboolean *running );
+
+gint64   na_process_snapshot_get_age       ( void );
+gint64   na_process_snapshot_get_build_cost( void );
+
+G_END_DECLS
+
+#endif /* __CORE_NA_PROCESS_SNAPSHOT_H__ */
@@ -34,8 +34,9 @@
 #include <glib/gi18n.h>
 #include <string.h>
 
-#include "na-gnome-vfs-uri.h"
+#include "na-intern.h"
 #include "na-selected-info.h"
+#include "na-uri.h"
 
 /* private class data
  */
@@ -47,23 +48,56 @@ struct _NASelectedInfoClassPrivate {
  */
 struct _NASelectedInfoPrivate {
 	gboolean       dispose_has_run;
-	gchar         *uri;
-	gchar         *filename;
-	gchar         *dirname;
+	NAUri          parts;				/* the owned URI and its components */
+	gchar         *filename;			/* materialized on first need */
+	const gchar   *dirname;				/* interned */
 	gchar         *basename;
-	gchar         *hostname;
-	gchar         *username;
-	gchar         *scheme;
-	guint          port;
-	gchar         *mimetype;
+	const gchar   *scheme;				/* interned */
+	const gchar   *mimetype;			/* interned */
 	GFileType      file_type;
 	gboolean       can_read;
 	gboolean       can_write;
 	gboolean       can_execute;
-	gchar         *owner;
+	const gchar   *owner;				/* interned */
 	gboolean       attributes_are_set;
+	gboolean       attributes_queried;
+	gboolean       attributes_unresolved;
 };
 
+/* the attributes queried for each selected item
+ */
+#define QUERY_ATTRIBUTES				G_FILE_ATTRIBUTE_STANDARD_TYPE \
+											"," G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE \
+											"," G_FILE_ATTRIBUTE_ACCESS_CAN_READ \
+											"," G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE \
+											"," G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE \
+											"," G_FILE_ATTRIBUTE_OWNER_USER
+
+/* the longest time na_selected_info_query_list() may block its caller,
+ * in milliseconds, as for the deadline of the dynamic conditions
+ */
+#define QUERY_MAX_DEADLINE				1000
+
+/* a batch of asynchronous queries, as run by na_selected_info_query_list()
+ * the batch is released when the last of its requests has completed,
+ * which may happen after the deadline
+ */
+typedef struct {
+	GMainContext *context;
+	GCancellable *cancellable;
+	GList        *pending;				/* NASelectedInfo's not yet requested */
+	GList        *running;				/* NASelectedInfo's being requested */
+	guint         max_queries;
+	gboolean      expired;
+}
+	QueryBatch;
+
+typedef struct {
+	QueryBatch     *batch;
+	NASelectedInfo *nsi;
+}
+	QueryRequest;
+
 
 static GObjectClass *st_parent_class = NULL;
 
@@ -76,8 +110,17 @@ static void            instance_finalize( GObject *object );
 static void            dump( const NASelectedInfo *nsi );
 static const char     *dump_file_type( GFileType type );
 static NASelectedInfo *new_from_nautilus_file_info( NautilusFileInfo *item );
-static NASelectedInfo *new_from_uri( const gchar *uri, const gchar *mimetype, gchar **errmsg );
-static void            query_file_attributes( NASelectedInfo *info, GFile *location, gchar **errmsg );
+static NASelectedInfo *new_from_uri( const gchar *uri, const gchar *mimetype );
+static const gchar    *get_filename( const NASelectedInfo *nsi );
+static gboolean        is_local_canonical( const NASelectedInfo *nsi );
+static void            query_file_attributes( const NASelectedInfo *nsi, gchar **errmsg );
+static void            set_file_attributes( const NASelectedInfo *nsi, GFileInfo *info );
+static void            batch_fill( QueryBatch *batch );
+static void            batch_expire( QueryBatch *batch );
+static void            batch_free( QueryBatch *batch );
+static gboolean        on_batch_deadline( QueryBatch *batch );
+static gboolean        on_batch_drain( QueryBatch *batch );
+static void            on_query_info_ready( GFile *location, GAsyncResult *result, QueryRequest *request );
 
 GType
 na_selected_info_get_type( void )
@@ -149,7 +192,6 @@ instance_init( GTypeInstance *instance, gpointer klass )
 	self->private = g_new0( NASelectedInfoPrivate, 1 );
 
 	self->private->dispose_has_run = FALSE;
-	self->private->uri = NULL;
 }
 
 static void
@@ -185,15 +227,13 @@ instance_finalize( GObject *object )
 
 	g_debug( "%s: object=%p (%s)", thisfn, ( void * ) object, G_OBJECT_TYPE_NAME( object ));
 
-	g_free( self->private->uri );
+	na_uri_clear( &self->private->parts );
 	g_free( self->private->filename );
-	g_free( self->private->dirname );
+	na_intern_unref( self->private->dirname );
 	g_free( self->private->basename );
-	g_free( self->private->hostname );
-	g_free( self->private->username );
-	g_free( self->private->scheme );
-	g_free( self->private->mimetype );
-	g_free( self->private->owner );
+	na_intern_unref( self->private->scheme );
+	na_intern_unref( self->private->mimetype );
+	na_intern_unref( self->private->owner );
 
 	g_free( self->private );
 
@@ -251,6 +291,91 @@ na_selected_info_get_list_from_list( GList *nautilus_selection )
 	return( selected ? g_list_reverse( selected ) : NULL );
 }
 
+/*
+ * na_selected_info_query_list:
+ * @files: a #GList list of #NASelectedInfo items.
+ * @max_queries: the maximum count of simultaneous queries, or zero for
+ *  no limit.
+ * @deadline: the maximum time to wait for the results, in milliseconds;
+ *  zero, or a value greater than one second, is clamped to one second.
+ *
+ * Queries in parallel the attributes of the @files which have not been
+ * queried yet.
+ *
+ * This call is synchronous: it blocks the caller until all the queries
+ * have completed, or for up to @deadline.
+ *
+ * The files whose attributes have not been resolved when the @deadline
+ * expires are left in an unresolved state, where all capabilities are
+ * %FALSE (see na_selected_info_is_unresolved()).
+ *
+ * Must be called from the main thread.
+ */
+void
+na_selected_info_query_list( GList *files, guint max_queries, guint deadline )
+{
+	static const gchar *thisfn = "na_selected_info_query_list";
+	QueryBatch *batch;
+	GList *it;
+	GSource *timeout;
+
+	batch = NULL;
+
+	for( it = files ; it ; it = it->next ){
+		if( !NA_SELECTED_INFO( it->data )->private->attributes_queried ){
+			if( !batch ){
+				batch = g_new0( QueryBatch, 1 );
+			}
+			batch->pending = g_list_prepend( batch->pending, g_object_ref( it->data ));
+		}
+	}
+
+	if( !batch ){
+		return;
+	}
+
+	if( !deadline || deadline > QUERY_MAX_DEADLINE ){
+		deadline = QUERY_MAX_DEADLINE;
+	}
+
+	g_debug( "%s: count=%u, max_queries=%u, deadline=%u",
+			thisfn, g_list_length( batch->pending ), max_queries, deadline );
+
+	batch->pending = g_list_reverse( batch->pending );
+	batch->max_queries = max_queries;
+	batch->cancellable = g_cancellable_new();
+
+	/* the results are dispatched to a private main context, so that the
+	 * file manager does not process other events while we are waiting
+	 */
+	batch->context = g_main_context_new();
+	g_main_context_push_thread_default( batch->context );
+
+	timeout = g_timeout_source_new( deadline );
+	g_source_set_callback( timeout, ( GSourceFunc ) on_batch_deadline, batch, NULL );
+	g_source_attach( timeout, batch->context );
+
+	batch_fill( batch );
+
+	while( batch->running && !batch->expired ){
+		g_main_context_iteration( batch->context, TRUE );
+	}
+
+	g_source_destroy( timeout );
+	g_source_unref( timeout );
+
+	g_main_context_pop_thread_default( batch->context );
+
+	if( batch->running ){
+		g_debug( "%s: deadline expired, %u queries still running", thisfn, g_list_length( batch->running ));
+		g_cancellable_cancel( batch->cancellable );
+		g_timeout_add( 100, ( GSourceFunc ) on_batch_drain, batch );
+
+	} else {
+		batch_free( batch );
+	}
+}
+
 /*
  * na_selected_info_copy_list:
  * @files: a #GList list of #NASelectedInfo items.
@@ -304,6 +429,10 @@ na_selected_info_get_basename( const NASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		if( !nsi->private->basename ){
+			nsi->private->basename = is_local_canonical( nsi ) ?
+					na_uri_get_basename( &nsi->private->parts ) : g_path_get_basename( get_filename( nsi ));
+		}
 		basename = g_strdup( nsi->private->basename );
 	}
 
@@ -321,18 +450,7 @@ na_selected_info_get_basename( const NASelectedInfo *nsi )
 gchar *
 na_selected_info_get_dirname( const NASelectedInfo *nsi )
 {
-	gchar *dirname;
-
-	g_return_val_if_fail( NA_IS_SELECTED_INFO( nsi ), NULL );
-
-	dirname = NULL;
-
-	if( !nsi->private->dispose_has_run ){
-
-		dirname = g_strdup( nsi->private->dirname );
-	}
-
-	return( dirname );
+	return( g_strdup( na_selected_info_peek_dirname( nsi )));
 }
 
 /*
@@ -345,20 +463,7 @@ na_selected_info_get_dirname( const NASelectedInfo *nsi )
 gchar *
 na_selected_info_get_mime_type( const NASelectedInfo *nsi )
 {
-	gchar *mimetype;
-
-	g_return_val_if_fail( NA_IS_SELECTED_INFO( nsi ), NULL );
-
-	mimetype = NULL;
-
-	if( !nsi->private->dispose_has_run ){
-
-		if( nsi->private->mimetype ){
-			mimetype = g_strdup( nsi->private->mimetype );
-		}
-	}
-
-	return( mimetype );
+	return( g_strdup( na_selected_info_peek_mime_type( nsi )));
 }
 
 /*
@@ -379,7 +484,7 @@ na_selected_info_get_path( const NASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
-		path = g_strdup( nsi->private->filename );
+		path = g_strdup( get_filename( nsi ));
 	}
 
 	return( path );
@@ -403,7 +508,7 @@ na_selected_info_get_uri( const NASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
-		uri = g_strdup( nsi->private->uri );
+		uri = g_strdup( nsi->private->parts.uri );
 	}
 
 	return( uri );
@@ -427,7 +532,7 @@ na_selected_info_get_uri_host( const NASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
-		host = g_strdup( nsi->private->hostname );
+		host = na_uri_get_host( &nsi->private->parts );
 	}
 
 	return( host );
@@ -451,7 +556,7 @@ na_selected_info_get_uri_user( const NASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
-		user = g_strdup( nsi->private->username );
+		user = na_uri_get_user( &nsi->private->parts );
 	}
 
 	return( user );
@@ -474,7 +579,7 @@ na_selected_info_get_uri_port( const NASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
-		port = nsi->private->port;
+		port = na_uri_get_port( &nsi->private->parts );
 	}
 
 	return( port );
@@ -490,18 +595,82 @@ na_selected_info_get_uri_port( const NASelectedInfo *nsi )
 gchar *
 na_selected_info_get_uri_scheme( const NASelectedInfo *nsi )
 {
-	gchar *scheme;
+	return( g_strdup( na_selected_info_peek_uri_scheme( nsi )));
+}
+
+/*
+ * na_selected_info_peek_dirname:
+ * @nsi: this #NASelectedInfo object.
+ *
+ * Returns: the dirname of the file associated with this
+ * #NASelectedInfo object, as an interned string which is owned by
+ * the @nsi object, and must not be freed by the caller.
+ *
+ * The dirnames of two #NASelectedInfo objects are equal if and only if
+ * they are the same pointer.
+ */
+const gchar *
+na_selected_info_peek_dirname( const NASelectedInfo *nsi )
+{
+	gchar *dirname;
 
 	g_return_val_if_fail( NA_IS_SELECTED_INFO( nsi ), NULL );
 
-	scheme = NULL;
+	if( !nsi->private->dispose_has_run && !nsi->private->dirname ){
 
-	if( !nsi->private->dispose_has_run ){
+		dirname = is_local_canonical( nsi ) ?
+				na_uri_get_dirname( &nsi->private->parts ) : g_path_get_dirname( get_filename( nsi ));
+		nsi->private->dirname = na_intern_ref( dirname );
+		g_free( dirname );
+	}
+
+	return( nsi->private->dispose_has_run ? NULL : nsi->private->dirname );
+}
+
+/*
+ * na_selected_info_peek_mime_type:
+ * @nsi: this #NASelectedInfo object.
+ *
+ * Returns: the mime type associated with this #NASelectedInfo object,
+ * as an interned string which is owned by the @nsi object, and must not
+ * be freed by the caller.
+ */
+const gchar *
+na_selected_info_peek_mime_type( const NASelectedInfo *nsi )
+{
+	g_return_val_if_fail( NA_IS_SELECTED_INFO( nsi ), NULL );
+
+	if( !nsi->private->dispose_has_run && !nsi->private->mimetype ){
 
-		scheme = g_strdup( nsi->private->scheme );
+		query_file_attributes( nsi, NULL );
 	}
 
-	return( scheme );
+	return( nsi->private->dispose_has_run ? NULL : nsi->private->mimetype );
+}
+
+/*
+ * na_selected_info_peek_uri_scheme:
+ * @nsi: this #NASelectedInfo object.
+ *
+ * Returns: the scheme associated to this @nsi object, as an interned
+ * string which is owned by the @nsi object, and must not be freed by
+ * the caller.
+ */
+const gchar *
+na_selected_info_peek_uri_scheme( const NASelectedInfo *nsi )
+{
+	gchar *scheme;
+
+	g_return_val_if_fail( NA_IS_SELECTED_INFO( nsi ), NULL );
+
+	if( !nsi->private->dispose_has_run && !nsi->private->scheme ){
+
+		scheme = na_uri_get_scheme( &nsi->private->parts );
+		nsi->private->scheme = na_intern_ref( scheme );
+		g_free( scheme );
+	}
+
+	return( nsi->private->dispose_has_run ? NULL : nsi->private->scheme );
 }
 
 /*
@@ -521,6 +690,7 @@ na_selected_info_is_directory( const NASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		query_file_attributes( nsi, NULL );
 		is_dir = ( nsi->private->file_type == G_FILE_TYPE_DIRECTORY );
 	}
 
@@ -544,6 +714,7 @@ na_selected_info_is_regular( const NASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		query_file_attributes( nsi, NULL );
 		is_regular = ( nsi->private->file_type == G_FILE_TYPE_REGULAR );
 	}
 
@@ -567,6 +738,7 @@ na_selected_info_is_executable( const NASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		query_file_attributes( nsi, NULL );
 		is_exe = nsi->private->can_execute;
 	}
 
@@ -583,7 +755,6 @@ gboolean
 na_selected_info_is_local( const NASelectedInfo *nsi )
 {
 	gboolean is_local;
-	gchar *scheme;
 
 	g_return_val_if_fail( NA_IS_SELECTED_INFO( nsi ), FALSE );
 
@@ -591,9 +762,7 @@ na_selected_info_is_local( const NASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
-		scheme = na_selected_info_get_uri_scheme( nsi );
-		is_local = ( strcmp( scheme, "file" ) == 0 );
-		g_free( scheme );
+		is_local = na_uri_has_scheme( &nsi->private->parts, "file" );
 	}
 
 	return( is_local );
@@ -617,7 +786,8 @@ na_selected_info_is_owner( const NASelectedInfo *nsi, const gchar *user )
 
 	if( !nsi->private->dispose_has_run ){
 
-		is_owner = ( strcmp( nsi->private->owner, user ) == 0 );
+		query_file_attributes( nsi, NULL );
+		is_owner = ( nsi->private->owner && user && strcmp( nsi->private->owner, user ) == 0 );
 	}
 
 	return( is_owner );
@@ -640,12 +810,37 @@ na_selected_info_is_readable( const NASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		query_file_attributes( nsi, NULL );
 		is_readable = nsi->private->can_read;
 	}
 
 	return( is_readable );
 }
 
+/*
+ * na_selected_info_is_unresolved:
+ * @nsi: this #NASelectedInfo object.
+ *
+ * Returns: %TRUE if the attributes of the item could not be resolved
+ * before the deadline of na_selected_info_query_list(), %FALSE else.
+ */
+gboolean
+na_selected_info_is_unresolved( const NASelectedInfo *nsi )
+{
+	gboolean is_unresolved;
+
+	g_return_val_if_fail( NA_IS_SELECTED_INFO( nsi ), FALSE );
+
+	is_unresolved = FALSE;
+
+	if( !nsi->private->dispose_has_run ){
+
+		is_unresolved = nsi->private->attributes_unresolved;
+	}
+
+	return( is_unresolved );
+}
+
 /*
  * na_selected_info_is_writable:
  * @nsi: this #NASelectedInfo object.
@@ -663,6 +858,7 @@ na_selected_info_is_writable( const NASelectedInfo *nsi )
 
 	if( !nsi->private->dispose_has_run ){
 
+		query_file_attributes( nsi, NULL );
 		is_writable = nsi->private->can_write;
 	}
 
@@ -676,6 +872,10 @@ na_selected_info_is_writable( const NASelectedInfo *nsi )
  * @errmsg: a pointer to a string which will contain an error message on
  *  return.
  *
+ * When @errmsg is not %NULL, the attributes of the file are queried
+ * right now, so that an error may be reported to the caller. Else, they
+ * are only queried on first need.
+ *
  * Returns: a newly allocated #NASelectedInfo object for the given @uri.
  */
 NASelectedInfo *
@@ -685,7 +885,11 @@ na_selected_info_create_for_uri( const gchar *uri, const gchar *mimetype, gchar
 
 	g_debug( "%s: uri=%s, mimetype=%s", thisfn, uri, mimetype );
 
-	NASelectedInfo *obj = new_from_uri( uri, mimetype, errmsg );
+	NASelectedInfo *obj = new_from_uri( uri, mimetype );
+
+	if( errmsg ){
+		query_file_attributes( obj, errmsg );
+	}
 
 	return( obj );
 }
@@ -695,16 +899,16 @@ dump( const NASelectedInfo *nsi )
 {
 	static const gchar *thisfn = "na_selected_info_dump";
 
-	g_debug( "%s:                uri=%s", thisfn, nsi->private->uri );
+	g_debug( "%s:                uri=%s", thisfn, nsi->private->parts.uri );
 	g_debug( "%s:           mimetype=%s", thisfn, nsi->private->mimetype );
 	g_debug( "%s:           filename=%s", thisfn, nsi->private->filename );
 	g_debug( "%s:            dirname=%s", thisfn, nsi->private->dirname );
 	g_debug( "%s:           basename=%s", thisfn, nsi->private->basename );
-	g_debug( "%s:           hostname=%s", thisfn, nsi->private->hostname );
-	g_debug( "%s:           username=%s", thisfn, nsi->private->username );
-	g_debug( "%s:             scheme=%s", thisfn, nsi->private->scheme );
-	g_debug( "%s:               port=%d", thisfn, nsi->private->port );
+	g_debug( "%s:          canonical=%s", thisfn, na_uri_is_canonical( &nsi->private->parts ) ? "True":"False" );
+	g_debug( "%s:               port=%d", thisfn, na_uri_get_port( &nsi->private->parts ));
+	g_debug( "%s: attributes_queried=%s", thisfn, nsi->private->attributes_queried ? "True":"False" );
 	g_debug( "%s: attributes_are_set=%s", thisfn, nsi->private->attributes_are_set ? "True":"False" );
+	g_debug( "%s:         unresolved=%s", thisfn, nsi->private->attributes_unresolved ? "True":"False" );
 	g_debug( "%s:          file_type=%s", thisfn, dump_file_type( nsi->private->file_type ));
 	g_debug( "%s:           can_read=%s", thisfn, nsi->private->can_read ? "True":"False" );
 	g_debug( "%s:          can_write=%s", thisfn, nsi->private->can_write ? "True":"False" );
@@ -739,7 +943,7 @@ new_from_nautilus_file_info( NautilusFileInfo *item )
 {
 	gchar *uri = nautilus_file_info_get_uri( item );
 	gchar *mimetype = nautilus_file_info_get_mime_type( item );
-	NASelectedInfo *info = new_from_uri( uri, mimetype, NULL );
+	NASelectedInfo *info = new_from_uri( uri, mimetype );
 	g_free( mimetype );
 	g_free( uri );
 
@@ -750,7 +954,7 @@ new_from_nautilus_file_info( NautilusFileInfo *item )
  * Nautilus uses to address the desktop via the 'x-nautilus-desktop:///' URI.
  * g_filename_from_uri() complains that
  * "The URI 'x-nautilus-desktop:///' is not an absolute URI using the "file" scheme".
- * In this case, we prefer the vfs->path member wich is just a decomposition of the
+ * In this case, we prefer the path component of the URI, which is just a decomposition of the
  * URI, and does not try to interpret it.
  *
  * *********************************************************************************
@@ -802,80 +1006,115 @@ new_from_nautilus_file_info( NautilusFileInfo *item )
  *   escaped, and so Nautilus does not escape them
  *
  * As a result, we may have valid, non-escaped, simple quotes in an URI.
+ *
+ * The URI is only decomposed here, in one pass: the URI-derived
+ * properties are materialized on first need. The attributes of the
+ * file, which require a (maybe remote) query, are also only loaded on
+ * first need, and the mimetype provided by Nautilus does not require it.
  */
 static NASelectedInfo *
-new_from_uri( const gchar *uri, const gchar *mimetype, gchar **errmsg )
+new_from_uri( const gchar *uri, const gchar *mimetype )
 {
-	GFile *location;
-	NAGnomeVFSURI *vfs;
-
 	NASelectedInfo *info = g_object_new( NA_TYPE_SELECTED_INFO, NULL );
 
-	info->private->uri = g_strdup( uri );
-	if( mimetype ){
-		info->private->mimetype = g_strdup( mimetype );
-	}
+	na_uri_parse( &info->private->parts, uri );
+	info->private->mimetype = na_intern_ref( mimetype );
 
-	/* pwi 2011-05-18
-	 * Filename and dirname should be taken from the GFile location, itself taken
-	 * from the URI, so that we have dir='/home/pierre/.gvfs/sftp on stormy.trychlos.org/etc'
-	 * Taking filename and dirname from URI just gives '/etc'
-	 * see #650523
-	 */
-	location = g_file_new_for_uri( uri );
-	info->private->filename = g_file_get_path( location );
+	dump( info );
 
-	vfs = g_new0( NAGnomeVFSURI, 1 );
-	na_gnome_vfs_uri_parse( vfs, uri );
-	if( !info->private->filename ){
-		g_debug( "na_selected_info_new_from_uri: uri='%s', filename=NULL, setting it to '%s'", uri, vfs->path );
-		info->private->filename = g_strdup( vfs->path );
-	}
+	return( info );
+}
 
-	info->private->basename = g_path_get_basename( info->private->filename );
-	info->private->dirname = g_path_get_dirname( info->private->filename );
-	info->private->hostname = g_strdup( vfs->host_name );
-	info->private->username = g_strdup( vfs->user_name );
-	info->private->scheme = g_strdup( vfs->scheme );
-	info->private->port = vfs->host_port;
-	na_gnome_vfs_uri_free( vfs );
+/*
+ * pwi 2011-05-18
+ * Filename and dirname should be taken from the GFile location, itself taken
+ * from the URI, so that we have dir='/home/pierre/.gvfs/sftp on stormy.trychlos.org/etc'
+ * Taking filename and dirname from URI just gives '/etc'
+ * see #650523
+ *
+ * a local URI whose path is already canonical does not need a GFile
+ */
+static const gchar *
+get_filename( const NASelectedInfo *nsi )
+{
+	GFile *location;
 
-	query_file_attributes( info, location, errmsg );
-	g_object_unref( location );
+	if( !nsi->private->filename ){
 
-	dump( info );
+		if( is_local_canonical( nsi )){
+			nsi->private->filename = na_uri_get_path( &nsi->private->parts );
 
-	return( info );
+		} else {
+			location = g_file_new_for_uri( nsi->private->parts.uri );
+			nsi->private->filename = g_file_get_path( location );
+			g_object_unref( location );
+
+			if( !nsi->private->filename ){
+				nsi->private->filename = na_uri_get_path( &nsi->private->parts );
+				g_debug( "na_selected_info_get_filename: uri='%s', filename=NULL, setting it to '%s'",
+						nsi->private->parts.uri, nsi->private->filename );
+			}
+		}
+	}
+
+	return( nsi->private->filename );
 }
 
+static gboolean
+is_local_canonical( const NASelectedInfo *nsi )
+{
+	return( na_uri_has_scheme( &nsi->private->parts, "file" ) &&
+			!nsi->private->parts.host.length &&
+			na_uri_is_canonical( &nsi->private->parts ));
+}
+
+/*
+ * the attributes are queried once, the first time they are needed,
+ * whether the query succeeds or not
+ */
 static void
-query_file_attributes( NASelectedInfo *nsi, GFile *location, gchar **errmsg )
+query_file_attributes( const NASelectedInfo *nsi, gchar **errmsg )
 {
 	static const gchar *thisfn = "na_selected_info_query_file_attributes";
+	GFile *location;
 	GError *error;
 
+	if( nsi->private->attributes_queried ){
+		return;
+	}
+
+	nsi->private->attributes_queried = TRUE;
+
 	error = NULL;
-	GFileInfo *info = g_file_query_info( location,
-			G_FILE_ATTRIBUTE_STANDARD_TYPE
-				"," G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE
-				"," G_FILE_ATTRIBUTE_ACCESS_CAN_READ
-				"," G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE
-				"," G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE
-				"," G_FILE_ATTRIBUTE_OWNER_USER,
-			G_FILE_QUERY_INFO_NONE, NULL, &error );
+	location = g_file_new_for_uri( nsi->private->parts.uri );
+	GFileInfo *info = g_file_query_info( location, QUERY_ATTRIBUTES, G_FILE_QUERY_INFO_NONE, NULL, &error );
+
+	g_object_unref( location );
 
 	if( error ){
 		if( errmsg ){
-			*errmsg = g_strdup_printf( _( "Error when querying informations for %s URI: %s" ), nsi->private->uri, error->message );
+			*errmsg = g_strdup_printf( _( "Error when querying informations for %s URI: %s" ), nsi->private->parts.uri, error->message );
 		} else {
-			g_warning( "%s: uri=%s, g_file_query_info: %s", thisfn, nsi->private->uri, error->message );
+			g_warning( "%s: uri=%s, g_file_query_info: %s", thisfn, nsi->private->parts.uri, error->message );
 		}
 		g_error_free( error );
 		return;
 	}
 
+	set_file_attributes( nsi, info );
+
+	g_object_unref( info );
+}
+
+static void
+set_file_attributes( const NASelectedInfo *nsi, GFileInfo *info )
+{
+	gchar *str;
+
 	if( !nsi->private->mimetype ){
-		nsi->private->mimetype = g_strdup( g_file_info_get_attribute_as_string( info, G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE ));
+		str = g_file_info_get_attribute_as_string( info, G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE );
+		nsi->private->mimetype = na_intern_ref( str );
+		g_free( str );
 	}
 
 	nsi->private->file_type = ( GFileType ) g_file_info_get_attribute_uint32( info, G_FILE_ATTRIBUTE_STANDARD_TYPE );
@@ -884,9 +1123,148 @@ query_file_attributes( NASelectedInfo *nsi, GFile *location, gchar **errmsg )
 	nsi->private->can_write = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE );
 	nsi->private->can_execute = g_file_info_get_attribute_boolean( info, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE );
 
-	nsi->private->owner = g_strdup( g_file_info_get_attribute_as_string( info, G_FILE_ATTRIBUTE_OWNER_USER ));
+	str = g_file_info_get_attribute_as_string( info, G_FILE_ATTRIBUTE_OWNER_USER );
+	nsi->private->owner = na_intern_ref( str );
+	g_free( str );
 
 	nsi->private->attributes_are_set = TRUE;
+}
 
-	g_object_unref( info );
+/*
+ * starts new requests, up to the maximum count of simultaneous queries
+ * the item is flagged as queried as soon as its request is started
+ */
+static void
+batch_fill( QueryBatch *batch )
+{
+	NASelectedInfo *nsi;
+	QueryRequest *request;
+	GFile *location;
+
+	while( batch->pending &&
+			( !batch->max_queries || g_list_length( batch->running ) < batch->max_queries )){
+
+		nsi = NA_SELECTED_INFO( batch->pending->data );
+		batch->pending = g_list_delete_link( batch->pending, batch->pending );
+
+		if( nsi->private->attributes_queried ){
+			g_object_unref( nsi );
+			continue;
+		}
+
+		nsi->private->attributes_queried = TRUE;
+		batch->running = g_list_prepend( batch->running, nsi );
+
+		request = g_new0( QueryRequest, 1 );
+		request->batch = batch;
+		request->nsi = nsi;
+
+		location = g_file_new_for_uri( nsi->private->parts.uri );
+		g_file_query_info_async( location, QUERY_ATTRIBUTES, G_FILE_QUERY_INFO_NONE,
+				G_PRIORITY_DEFAULT, batch->cancellable, ( GAsyncReadyCallback ) on_query_info_ready, request );
+		g_object_unref( location );
+	}
+}
+
+/*
+ * the items which are not resolved at the deadline are flagged as such
+ * the late results are ignored
+ */
+static void
+batch_expire( QueryBatch *batch )
+{
+	GList *it;
+
+	batch->expired = TRUE;
+
+	for( it = batch->running ; it ; it = it->next ){
+		NA_SELECTED_INFO( it->data )->private->attributes_unresolved = TRUE;
+	}
+
+	for( it = batch->pending ; it ; it = it->next ){
+		NA_SELECTED_INFO( it->data )->private->attributes_queried = TRUE;
+		NA_SELECTED_INFO( it->data )->private->attributes_unresolved = TRUE;
+	}
+
+	g_list_foreach( batch->pending, ( GFunc ) g_object_unref, NULL );
+	g_list_free( batch->pending );
+	batch->pending = NULL;
+}
+
+static void
+batch_free( QueryBatch *batch )
+{
+	g_list_foreach( batch->pending, ( GFunc ) g_object_unref, NULL );
+	g_list_free( batch->pending );
+	g_object_unref( batch->cancellable );
+	g_main_context_unref( batch->context );
+	g_free( batch );
+}
+
+static gboolean
+on_batch_deadline( QueryBatch *batch )
+{
+	batch_expire( batch );
+
+	return( FALSE );
+}
+
+/*
+ * after the deadline, the cancelled requests are completed in the
+ * private main context, which is so iterated from the main loop until
+ * the last one has returned
+ */
+static gboolean
+on_batch_drain( QueryBatch *batch )
+{
+	while( g_main_context_iteration( batch->context, FALSE ))
+		;
+
+	if( batch->running ){
+		return( TRUE );
+	}
+
+	batch_free( batch );
+
+	return( FALSE );
+}
+
+static void
+on_query_info_ready( GFile *location, GAsyncResult *result, QueryRequest *request )
+{
+	static const gchar *thisfn = "na_selected_info_on_query_info_ready";
+	QueryBatch *batch;
+	NASelectedInfo *nsi;
+	GFileInfo *info;
+	GError *error;
+
+	batch = request->batch;
+	nsi = request->nsi;
+	g_free( request );
+
+	error = NULL;
+	info = g_file_query_info_finish( location, result, &error );
+
+	if( !batch->expired ){
+		if( error ){
+			g_warning( "%s: uri=%s, g_file_query_info_async: %s", thisfn, nsi->private->parts.uri, error->message );
+
+		} else {
+			set_file_attributes( nsi, info );
+		}
+	}
+
+	if( error ){
+		g_error_free( error );
+	}
+	if( info ){
+		g_object_unref( info );
+	}
+
+	batch->running = g_list_remove( batch->running, nsi );
+	g_object_unref( nsi );
+
+	if( !batch->expired ){
+		batch_fill( batch );
+	}
 }
@@ -76,6 +76,7 @@ GType           na_selected_info_get_type( void );
 
 GList          *na_selected_info_get_list_from_item( NautilusFileInfo *item );
 GList          *na_selected_info_get_list_from_list( GList *nautilus_selection );
+void            na_selected_info_query_list        ( GList *files, guint max_queries, guint deadline );
 GList          *na_selected_info_copy_list         ( GList *files );
 void            na_selected_info_free_list         ( GList *files );
 
@@ -88,12 +89,17 @@ gchar          *na_selected_info_get_uri_host  ( const NASelectedInfo *nsi );
 gchar          *na_selected_info_get_uri_user  ( const NASelectedInfo *nsi );
 guint           na_selected_info_get_uri_port  ( const NASelectedInfo *nsi );
 gchar          *na_selected_info_get_uri_scheme( const NASelectedInfo *nsi );
+const gchar    *na_selected_info_peek_dirname   ( const NASelectedInfo *nsi );
+const gchar    *na_selected_info_peek_mime_type ( const NASelectedInfo *nsi );
+const gchar    *na_selected_info_peek_uri_scheme( const NASelectedInfo *nsi );
+
 gboolean        na_selected_info_is_directory  ( const NASelectedInfo *nsi );
 gboolean        na_selected_info_is_regular    ( const NASelectedInfo *nsi );
 gboolean        na_selected_info_is_executable ( const NASelectedInfo *nsi );
 gboolean        na_selected_info_is_local      ( const NASelectedInfo *nsi );
 gboolean        na_selected_info_is_owner      ( const NASelectedInfo *nsi, const gchar *user );
 gboolean        na_selected_info_is_readable   ( const NASelectedInfo *nsi );
+gboolean        na_selected_info_is_unresolved ( const NASelectedInfo *nsi );
 gboolean        na_selected_info_is_writable   ( const NASelectedInfo *nsi );
 
 NASelectedInfo *na_selected_info_create_for_uri( const gchar *uri, const gchar *mimetype, gchar **errmsg );
@@ -140,12 +140,26 @@ static const KeyDef st_def_keys[] = {
 	{ NA_IPREFS_COMMAND_LEGEND_WSP,               GROUP_NACT,    NA_DATA_TYPE_UINT_LIST,   "" },
 	{ NA_IPREFS_CONFIRM_LOGOUT_WSP,               GROUP_NACT,    NA_DATA_TYPE_UINT_LIST,   "" },
 	{ NA_IPREFS_DESKTOP_ENVIRONMENT,              GROUP_RUNTIME, NA_DATA_TYPE_STRING,      "" },
+	/* the two deadlines apply to each menu request, during which the file
+	 * manager is blocked: zero means the maximum, which is one second */
+	{ NA_IPREFS_DYNAMIC_DEADLINE,                 GROUP_RUNTIME, NA_DATA_TYPE_UINT,        "250" },
+	{ NA_IPREFS_DYNAMIC_MAX_CHILDREN,             GROUP_RUNTIME, NA_DATA_TYPE_UINT,        "2" },
+	{ NA_IPREFS_DYNAMIC_PROCESS_SNAPSHOT_TTL,     GROUP_RUNTIME, NA_DATA_TYPE_UINT,        "1000" },
+	{ NA_IPREFS_DYNAMIC_SHOW_IF_REGISTERED_POLICY, GROUP_RUNTIME, NA_DATA_TYPE_STRING,      "Last" },
+	{ NA_IPREFS_DYNAMIC_SHOW_IF_RUNNING_POLICY,   GROUP_RUNTIME, NA_DATA_TYPE_STRING,      "Last" },
+	{ NA_IPREFS_DYNAMIC_SHOW_IF_TRUE_POLICY,      GROUP_RUNTIME, NA_DATA_TYPE_STRING,      "Last" },
+	{ NA_IPREFS_DYNAMIC_SHOW_IF_TRUE_TIMEOUT,     GROUP_RUNTIME, NA_DATA_TYPE_UINT,        "5000" },
+	{ NA_IPREFS_DYNAMIC_SHOW_IF_TRUE_TTL,         GROUP_RUNTIME, NA_DATA_TYPE_UINT,        "2000" },
+	{ NA_IPREFS_DYNAMIC_TRY_EXEC_POLICY,          GROUP_RUNTIME, NA_DATA_TYPE_STRING,      "Last" },
+	{ NA_IPREFS_DYNAMIC_TRY_EXEC_REMOTE_TTL,      GROUP_RUNTIME, NA_DATA_TYPE_UINT,        "10000" },
 	{ NA_IPREFS_WORKING_DIR_WSP,                  GROUP_NACT,    NA_DATA_TYPE_UINT_LIST,   "" },
 	{ NA_IPREFS_WORKING_DIR_URI,                  GROUP_NACT,    NA_DATA_TYPE_STRING,      "file:///" },
 	{ NA_IPREFS_SHOW_IF_RUNNING_WSP,              GROUP_NACT,    NA_DATA_TYPE_UINT_LIST,   "" },
 	{ NA_IPREFS_SHOW_IF_RUNNING_URI,              GROUP_NACT,    NA_DATA_TYPE_STRING,      "file:///bin" },
 	{ NA_IPREFS_TRY_EXEC_WSP,                     GROUP_NACT,    NA_DATA_TYPE_UINT_LIST,   "" },
 	{ NA_IPREFS_TRY_EXEC_URI,                     GROUP_NACT,    NA_DATA_TYPE_STRING,      "file:///bin" },
+	{ NA_IPREFS_EXECUTION_MAX_CHILDREN,           GROUP_RUNTIME, NA_DATA_TYPE_UINT,        "4" },
+	{ NA_IPREFS_EXECUTION_OUTPUT_MAX_SIZE,        GROUP_RUNTIME, NA_DATA_TYPE_UINT,        "65536" },
 	{ NA_IPREFS_EXPORT_ASK_USER_WSP,              GROUP_NACT,    NA_DATA_TYPE_UINT_LIST,   "" },
 	{ NA_IPREFS_EXPORT_ASK_USER_LAST_FORMAT,      GROUP_NACT,    NA_DATA_TYPE_STRING,      "Desktop1" },
 	{ NA_IPREFS_EXPORT_ASK_USER_KEEP_LAST_CHOICE, GROUP_NACT,    NA_DATA_TYPE_BOOLEAN,     "false" },
@@ -185,6 +199,10 @@ static const KeyDef st_def_keys[] = {
 	{ NA_IPREFS_RELABEL_DUPLICATE_PROFILE,        GROUP_NACT,    NA_DATA_TYPE_BOOLEAN,     "false" },
 	{ NA_IPREFS_SCHEME_ADD_SCHEME_WSP,            GROUP_NACT,    NA_DATA_TYPE_UINT_LIST,   "" },
 	{ NA_IPREFS_SCHEME_DEFAULT_LIST,              GROUP_NACT,    NA_DATA_TYPE_STRING_LIST, "" },
+	/* see NA_IPREFS_DYNAMIC_DEADLINE above */
+	{ NA_IPREFS_SELECTION_ATTRIBUTES_DEADLINE,    GROUP_RUNTIME, NA_DATA_TYPE_UINT,        "500" },
+	{ NA_IPREFS_SELECTION_ATTRIBUTES_MAX_QUERIES, GROUP_RUNTIME, NA_DATA_TYPE_UINT,        "16" },
+	{ NA_IPREFS_SELECTION_CACHE_TTL,              GROUP_RUNTIME, NA_DATA_TYPE_UINT,        "5000" },
 	{ NA_IPREFS_TERMINAL_PATTERN,                 GROUP_RUNTIME, NA_DATA_TYPE_STRING,      "" },
 	{ NA_IPREFS_IO_PROVIDER_READABLE,             NA_IPREFS_IO_PROVIDER_GROUP, NA_DATA_TYPE_BOOLEAN, "true" },
 	{ NA_IPREFS_IO_PROVIDER_WRITABLE,             NA_IPREFS_IO_PROVIDER_GROUP, NA_DATA_TYPE_BOOLEAN, "true" },
@@ -1412,7 +1430,7 @@ static void
 release_key_value( KeyValue *value )
 {
 	g_free(( gpointer ) value->group );
-	g_object_unref( value->boxed );
+	na_boxed_free( value->boxed );
 	g_free( value );
 }
 
@@ -79,6 +79,16 @@ G_BEGIN_DECLS
 #define NA_IPREFS_COMMAND_CHOOSER_URI				"command-command-chooser-lfu"
 #define NA_IPREFS_COMMAND_LEGEND_WSP				"command-legend-wsp"
 #define NA_IPREFS_DESKTOP_ENVIRONMENT				"desktop-environment"
+#define NA_IPREFS_DYNAMIC_DEADLINE					"dynamic-conditions-deadline"
+#define NA_IPREFS_DYNAMIC_MAX_CHILDREN				"dynamic-conditions-max-children"
+#define NA_IPREFS_DYNAMIC_PROCESS_SNAPSHOT_TTL		"dynamic-conditions-process-snapshot-ttl"
+#define NA_IPREFS_DYNAMIC_SHOW_IF_REGISTERED_POLICY	"dynamic-conditions-show-if-registered-policy"
+#define NA_IPREFS_DYNAMIC_SHOW_IF_RUNNING_POLICY	"dynamic-conditions-show-if-running-policy"
+#define NA_IPREFS_DYNAMIC_SHOW_IF_TRUE_POLICY		"dynamic-conditions-show-if-true-policy"
+#define NA_IPREFS_DYNAMIC_SHOW_IF_TRUE_TIMEOUT		"dynamic-conditions-show-if-true-timeout"
+#define NA_IPREFS_DYNAMIC_SHOW_IF_TRUE_TTL			"dynamic-conditions-show-if-true-ttl"
+#define NA_IPREFS_DYNAMIC_TRY_EXEC_POLICY			"dynamic-conditions-try-exec-policy"
+#define NA_IPREFS_DYNAMIC_TRY_EXEC_REMOTE_TTL		"dynamic-conditions-try-exec-remote-ttl"
 #define NA_IPREFS_CONFIRM_LOGOUT_WSP				"confirm-logout-wsp"
 #define NA_IPREFS_WORKING_DIR_WSP					"command-working-dir-chooser-wsp"
 #define NA_IPREFS_WORKING_DIR_URI					"command-working-dir-chooser-lfu"
@@ -86,6 +96,8 @@ G_BEGIN_DECLS
 #define NA_IPREFS_SHOW_IF_RUNNING_URI				"environment-show-if-running-lfu"
 #define NA_IPREFS_TRY_EXEC_WSP						"environment-try-exec-wsp"
 #define NA_IPREFS_TRY_EXEC_URI						"environment-try-exec-lfu"
+#define NA_IPREFS_EXECUTION_MAX_CHILDREN			"execution-max-children"
+#define NA_IPREFS_EXECUTION_OUTPUT_MAX_SIZE			"execution-output-max-size"
 #define NA_IPREFS_EXPORT_ASK_USER_WSP				"export-ask-user-wsp"
 #define NA_IPREFS_EXPORT_ASK_USER_LAST_FORMAT		"export-ask-user-last-format"
 #define NA_IPREFS_EXPORT_ASK_USER_KEEP_LAST_CHOICE	"export-ask-user-keep-last-choice"
@@ -125,6 +137,9 @@ G_BEGIN_DECLS
 #define NA_IPREFS_RELABEL_DUPLICATE_PROFILE			"relabel-when-duplicate-profile"
 #define NA_IPREFS_SCHEME_ADD_SCHEME_WSP				"scheme-add-scheme-wsp"
 #define NA_IPREFS_SCHEME_DEFAULT_LIST				"scheme-default-list"
+#define NA_IPREFS_SELECTION_ATTRIBUTES_DEADLINE		"selection-attributes-deadline"
+#define NA_IPREFS_SELECTION_ATTRIBUTES_MAX_QUERIES	"selection-attributes-max-queries"
+#define NA_IPREFS_SELECTION_CACHE_TTL				"selection-cache-ttl"
 #define NA_IPREFS_TERMINAL_PATTERN					"terminal-pattern"
 
 #define NA_IPREFS_IO_PROVIDER_GROUP					"io-provider"
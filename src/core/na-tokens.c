@@ -31,15 +31,18 @@
 #include <config.h>
 #endif
 
-#include <gio/gunixinputstream.h>
 #include <glib/gi18n.h>
 #include <gtk/gtk.h>
 #include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <api/na-core-utils.h>
 #include <api/na-object-api.h>
 
+#include "na-exec-output.h"
 #include "na-gnome-vfs-uri.h"
+#include "na-intern.h"
 #include "na-selected-info.h"
 #include "na-settings.h"
 #include "na-tokens.h"
@@ -50,34 +53,107 @@ struct _NATokensClassPrivate {
 	void *empty;						/* so that gcc -pedantic is happy */
 };
 
+/* the data of a selected item
+ * the fields are only computed from the NASelectedInfo object when a
+ * token actually needs them; basedir and mimetype are interned strings
+ */
+typedef struct {
+	NASelectedInfo *info;				/* NULL for the example tokens */
+	guint           done;				/* bitmap of the computed fields */
+	gchar          *uri;
+	gchar          *filename;
+	const gchar    *basedir;
+	gchar          *basename;
+	gchar          *basename_woext;
+	gchar          *ext;
+	const gchar    *mimetype;
+}
+	TokensFile;
+
+enum {
+	FILE_URI      = 1 << 0,
+	FILE_FILENAME = 1 << 1,
+	FILE_BASEDIR  = 1 << 2,
+	FILE_BASENAME = 1 << 3,
+	FILE_SPLIT    = 1 << 4,				/* basename_woext and ext */
+	FILE_MIMETYPE = 1 << 5,
+	FILE_ALL      = ( 1 << 6 )-1
+};
+
 /* private instance data
+ * scheme is an interned string
  */
 struct _NATokensPrivate {
-	gboolean dispose_has_run;
-	guint    count;
-	GSList  *uris;
-	GSList  *filenames;
-	GSList  *basedirs;
-	GSList  *basenames;
-	GSList  *basenames_woext;
-	GSList  *exts;
-	GSList  *mimetypes;
-	gchar   *hostname;
-	gchar   *username;
-	guint    port;
-	gchar   *scheme;
+	gboolean     dispose_has_run;
+	guint        count;
+	TokensFile  *files;
+	gchar       *hostname;
+	gchar       *username;
+	guint        port;
+	const gchar *scheme;
 };
 
+/* a pool of command lines, which are run with a bounded count of
+ * concurrent children, for the chunked execution of a profile
+ * the pool is released when its last child has exited
+ */
+typedef struct {
+	NAObjectProfile *profile;
+	NATokens        *tokens;
+	GList           *pending;			/* command lines not yet started */
+	guint            max_children;
+	guint            running;
+	guint            total;
+	guint            failed;
+	gint             last_status;		/* of the last failed child, -1 if it could not be spawned */
+}
+	ExecPool;
+
 /*  the structure passed to the callback which waits for the end of the child
  */
 typedef struct {
-	gchar   *command;
-	gboolean is_output_displayed;
-	gint     child_stdout;
-	gint     child_stderr;
+	gchar        *command;
+	gboolean      is_output_displayed;
+	NAExecOutput *output;
+	ExecPool     *pool;
 }
 	ChildStr;
 
+/* the limit of the size of the arguments when it cannot be read from
+ * the system, and the size kept free for the rest of the command
+ * the whole command is a single argument when it is run in a terminal,
+ * where Linux limits the size of an argument to MAX_ARG_STRLEN
+ */
+#define ARG_MAX_FALLBACK				131072
+#define ARG_MAX_MARGIN					4096
+#define ARG_STRLEN_MAX					131072
+
+extern char **environ;
+
+/* a compiled template
+ * an operation is either a literal slice of the string (code=0), or a
+ * token code
+ */
+typedef struct {
+	gchar code;
+	guint offset;
+	guint length;
+}
+	TemplateOp;
+
+struct _NATokensTemplate {
+	gchar      *string;
+	TemplateOp *ops;
+	guint       count;
+	guint       literal_length;
+	gboolean    has_tokens;
+	gboolean    singular;
+};
+
+/* the template of an empty string is a shared constant
+ */
+static NATokensTemplate st_empty_template = { ( gchar * ) "", NULL, 0, 0, FALSE, FALSE };
+
 static GObjectClass *st_parent_class = NULL;
 
 static GType     register_type( void );
@@ -87,17 +163,23 @@ static void      instance_dispose( GObject *object );
 static void      instance_finalize( GObject *object );
 
 static void      child_watch_fn( GPid pid, gint status, ChildStr *child_str );
-static void      display_output( const gchar *command, int fd_stdout, int fd_stderr );
-static gchar    *display_output_get_content( int fd );
-static void      execute_action_command( gchar *command, const NAObjectProfile *profile, const NATokens *tokens );
+static gboolean  execute_action_command( gchar *command, const NAObjectProfile *profile, const NATokens *tokens, ExecPool *pool );
+static void      execute_chunked( const NATokens *tokens, const NAObjectProfile *profile, const NATokensTemplate *template );
+static glong     get_arg_limit( const gchar *execution_mode );
+static glong     get_file_cost( const NATokensTemplate *template, const NATokens *tokens, guint i, gboolean requoted );
+static gboolean  command_fits( const gchar *execution_mode, const gchar *command, glong limit );
+static gchar    *get_run_command( const gchar *execution_mode, const gchar *command );
+static void      pool_fill( ExecPool *pool );
+static void      pool_child_exited( ExecPool *pool, gint status );
 static gchar    *get_command_execution_display_output( const gchar *command );
 static gchar    *get_command_execution_embedded( const gchar *command );
 static gchar    *get_command_execution_normal( const gchar *command );
 static gchar    *get_command_execution_terminal( const gchar *command );
-static gboolean  is_singular_exec( const NATokens *tokens, const gchar *exec );
-static gchar    *parse_singular( const NATokens *tokens, const gchar *input, guint i, gboolean utf8, gboolean quoted );
-static GString  *quote_string( GString *input, const gchar *name, gboolean quoted );
-static GString  *quote_string_list( GString *input, GSList *names, gboolean quoted );
+static void      template_compile( NATokensTemplate *template );
+static gchar    *template_render( const NATokensTemplate *template, const NATokens *tokens, guint i, guint from, guint to, gboolean quoted );
+static void      render_token( GString *output, const NATokens *tokens, gchar code, guint i, guint from, guint to, gboolean quoted );
+static const gchar *file_get( const NATokens *tokens, guint i, gchar code );
+static void      quote_string( GString *output, const gchar *name, gboolean quoted );
 
 GType
 na_tokens_get_type( void )
@@ -168,13 +250,8 @@ instance_init( GTypeInstance *instance, gpointer klass )
 
 	self->private = g_new0( NATokensPrivate, 1 );
 
-	self->private->uris = NULL;
-	self->private->filenames = NULL;
-	self->private->basedirs = NULL;
-	self->private->basenames = NULL;
-	self->private->basenames_woext = NULL;
-	self->private->exts = NULL;
-	self->private->mimetypes = NULL;
+	self->private->count = 0;
+	self->private->files = NULL;
 	self->private->hostname = NULL;
 	self->private->username = NULL;
 	self->private->port = 0;
@@ -188,6 +265,7 @@ instance_dispose( GObject *object )
 {
 	static const gchar *thisfn = "na_tokens_instance_dispose";
 	NATokens *self;
+	guint i;
 
 	g_return_if_fail( NA_IS_TOKENS( object ));
 
@@ -199,6 +277,13 @@ instance_dispose( GObject *object )
 
 		self->private->dispose_has_run = TRUE;
 
+		for( i = 0 ; i < self->private->count ; ++i ){
+			if( self->private->files[i].info ){
+				g_object_unref( self->private->files[i].info );
+				self->private->files[i].info = NULL;
+			}
+		}
+
 		if( G_OBJECT_CLASS( st_parent_class )->dispose ){
 			G_OBJECT_CLASS( st_parent_class )->dispose( object );
 		}
@@ -210,6 +295,8 @@ instance_finalize( GObject *object )
 {
 	static const gchar *thisfn = "na_tokens_instance_finalize";
 	NATokens *self;
+	TokensFile *file;
+	guint i;
 
 	g_return_if_fail( NA_IS_TOKENS( object ));
 
@@ -217,16 +304,20 @@ instance_finalize( GObject *object )
 
 	self = NA_TOKENS( object );
 
-	g_free( self->private->scheme );
+	na_intern_unref( self->private->scheme );
 	g_free( self->private->username );
 	g_free( self->private->hostname );
-	na_core_utils_slist_free( self->private->mimetypes );
-	na_core_utils_slist_free( self->private->exts );
-	na_core_utils_slist_free( self->private->basenames_woext );
-	na_core_utils_slist_free( self->private->basenames );
-	na_core_utils_slist_free( self->private->basedirs );
-	na_core_utils_slist_free( self->private->filenames );
-	na_core_utils_slist_free( self->private->uris );
+
+	for( i = 0, file = self->private->files ; i < self->private->count ; ++i, ++file ){
+		g_free( file->uri );
+		g_free( file->filename );
+		na_intern_unref( file->basedir );
+		g_free( file->basename );
+		g_free( file->basename_woext );
+		g_free( file->ext );
+		na_intern_unref( file->mimetype );
+	}
+	g_free( self->private->files );
 
 	g_free( self->private );
 
@@ -254,42 +345,40 @@ na_tokens_new_for_example( void )
 	const guint  ex_port = 8080;
 	const gchar *ex_host = _( "test.example.net" );
 	const gchar *ex_user = _( "user" );
+	const gchar *ex_uris[] = { ex_uri1, ex_uri2 };
+	const gchar *ex_mimetypes[] = { ex_mimetype1, ex_mimetype2 };
 	NAGnomeVFSURI *vfs;
-	gchar *dirname, *bname, *bname_woext, *ext;
-	GSList *is;
-	gboolean first;
+	TokensFile *file;
+	gchar *dirname;
+	guint i;
 
 	tokens = g_object_new( NA_TYPE_TOKENS, NULL );
-	first = TRUE;
 	tokens->private->count = 2;
+	tokens->private->files = g_new0( TokensFile, tokens->private->count );
 
-	tokens->private->uris = g_slist_append( tokens->private->uris, g_strdup( ex_uri1 ));
-	tokens->private->uris = g_slist_append( tokens->private->uris, g_strdup( ex_uri2 ));
-
-	for( is = tokens->private->uris ; is ; is = is->next ){
+	for( i = 0 ; i < tokens->private->count ; ++i ){
+		file = tokens->private->files+i;
 		vfs = g_new0( NAGnomeVFSURI, 1 );
-		na_gnome_vfs_uri_parse( vfs, is->data );
+		na_gnome_vfs_uri_parse( vfs, ex_uris[i] );
+
+		file->done = FILE_ALL;
+		file->uri = g_strdup( ex_uris[i] );
+		file->filename = g_strdup( vfs->path );
+		file->basename = g_path_get_basename( vfs->path );
+		na_core_utils_dir_split_ext( file->basename, &file->basename_woext, &file->ext );
+		file->mimetype = na_intern_ref( ex_mimetypes[i] );
 
-		tokens->private->filenames = g_slist_append( tokens->private->filenames, g_strdup( vfs->path ));
 		dirname = g_path_get_dirname( vfs->path );
-		tokens->private->basedirs = g_slist_append( tokens->private->basedirs, dirname );
-		bname = g_path_get_basename( vfs->path );
-		tokens->private->basenames = g_slist_append( tokens->private->basenames, bname );
-		na_core_utils_dir_split_ext( bname, &bname_woext, &ext );
-		tokens->private->basenames_woext = g_slist_append( tokens->private->basenames_woext, bname_woext );
-		tokens->private->exts = g_slist_append( tokens->private->exts, ext );
-
-		if( first ){
-			tokens->private->scheme = g_strdup( vfs->scheme );
-			first = FALSE;
+		file->basedir = na_intern_ref( dirname );
+		g_free( dirname );
+
+		if( !i ){
+			tokens->private->scheme = na_intern_ref( vfs->scheme );
 		}
 
 		na_gnome_vfs_uri_free( vfs );
 	}
 
-	tokens->private->mimetypes = g_slist_append( tokens->private->mimetypes, g_strdup( ex_mimetype1 ));
-	tokens->private->mimetypes = g_slist_append( tokens->private->mimetypes, g_strdup( ex_mimetype2 ));
-
 	tokens->private->hostname = g_strdup( ex_host );
 	tokens->private->username = g_strdup( ex_user );
 	tokens->private->port = ex_port;
@@ -308,41 +397,27 @@ na_tokens_new_from_selection( GList *selection )
 {
 	static const gchar *thisfn = "na_tokens_new_from_selection";
 	NATokens *tokens;
+	NASelectedInfo *first;
 	GList *it;
-	gchar *uri, *filename, *basedir, *basename, *bname_woext, *ext, *mimetype;
-	gboolean first;
-
-	g_debug( "%s: selection=%p (count=%d)", thisfn, ( void * ) selection, g_list_length( selection ));
+	guint i;
 
-	first = TRUE;
 	tokens = g_object_new( NA_TYPE_TOKENS, NULL );
-
 	tokens->private->count = g_list_length( selection );
 
-	for( it = selection ; it ; it = it->next ){
-		mimetype = na_selected_info_get_mime_type( NA_SELECTED_INFO( it->data ));
-
-		uri = na_selected_info_get_uri( NA_SELECTED_INFO( it->data ));
-		filename = na_selected_info_get_path( NA_SELECTED_INFO( it->data ));
-		basedir = na_selected_info_get_dirname( NA_SELECTED_INFO( it->data ));
-		basename = na_selected_info_get_basename( NA_SELECTED_INFO( it->data ));
-		na_core_utils_dir_split_ext( basename, &bname_woext, &ext );
-
-		if( first ){
-			tokens->private->hostname = na_selected_info_get_uri_host( NA_SELECTED_INFO( it->data ));
-			tokens->private->username = na_selected_info_get_uri_user( NA_SELECTED_INFO( it->data ));
-			tokens->private->port = na_selected_info_get_uri_port( NA_SELECTED_INFO( it->data ));
-			tokens->private->scheme = na_selected_info_get_uri_scheme( NA_SELECTED_INFO( it->data ));
-			first = FALSE;
-		}
+	g_debug( "%s: selection=%p (count=%u)", thisfn, ( void * ) selection, tokens->private->count );
 
-		tokens->private->uris = g_slist_append( tokens->private->uris, uri );
-		tokens->private->filenames = g_slist_append( tokens->private->filenames, filename );
-		tokens->private->basedirs = g_slist_append( tokens->private->basedirs, basedir );
-		tokens->private->basenames = g_slist_append( tokens->private->basenames, basename );
-		tokens->private->basenames_woext = g_slist_append( tokens->private->basenames_woext, bname_woext );
-		tokens->private->exts = g_slist_append( tokens->private->exts, ext );
-		tokens->private->mimetypes = g_slist_append( tokens->private->mimetypes, mimetype );
+	if( selection ){
+		first = NA_SELECTED_INFO( selection->data );
+		tokens->private->hostname = na_selected_info_get_uri_host( first );
+		tokens->private->username = na_selected_info_get_uri_user( first );
+		tokens->private->port = na_selected_info_get_uri_port( first );
+		tokens->private->scheme = na_intern_ref( na_selected_info_peek_uri_scheme( first ));
+	}
+
+	tokens->private->files = g_new0( TokensFile, tokens->private->count );
+
+	for( i = 0, it = selection ; it ; ++i, it = it->next ){
+		tokens->private->files[i].info = g_object_ref( it->data );
 	}
 
 	return( tokens );
@@ -365,7 +440,18 @@ na_tokens_new_from_selection( GList *selection )
 gchar *
 na_tokens_parse_for_display( const NATokens *tokens, const gchar *string, gboolean utf8 )
 {
-	return( parse_singular( tokens, string, 0, utf8, FALSE ));
+	NATokensTemplate *template;
+	gchar *output;
+
+	if( !string ){
+		return( NULL );
+	}
+
+	template = na_tokens_template_new( string );
+	output = na_tokens_template_render( template, tokens, 0, FALSE );
+	na_tokens_template_free( template );
+
+	return( output );
 }
 
 /*
@@ -379,7 +465,7 @@ void
 na_tokens_execute_action( const NATokens *tokens, const NAObjectProfile *profile )
 {
 	gchar *path, *parameters, *exec;
-	gboolean singular;
+	NATokensTemplate *template;
 	guint i;
 	gchar *command;
 
@@ -389,96 +475,132 @@ na_tokens_execute_action( const NATokens *tokens, const NAObjectProfile *profile
 	g_free( parameters );
 	g_free( path );
 
-	singular = is_singular_exec( tokens, exec );
+	template = na_tokens_template_new( exec );
 
-	if( singular ){
+	if( na_object_get_execution_chunked( profile )){
+		execute_chunked( tokens, profile, template );
+
+	} else if( template->singular ){
 		for( i = 0 ; i < tokens->private->count ; ++i ){
-			command = parse_singular( tokens, exec, i, FALSE, TRUE );
-			execute_action_command( command, profile, tokens );
+			command = na_tokens_template_render( template, tokens, i, TRUE );
+			execute_action_command( command, profile, tokens, NULL );
 			g_free( command );
 		}
 
 	} else {
-		command = parse_singular( tokens, exec, 0, FALSE, TRUE );
-		execute_action_command( command, profile, tokens );
+		command = na_tokens_template_render( template, tokens, 0, TRUE );
+		execute_action_command( command, profile, tokens, NULL );
 		g_free( command );
 	}
 
+	na_tokens_template_free( template );
 	g_free( exec );
 }
 
-static void
-child_watch_fn( GPid pid, gint status, ChildStr *child_str )
+/*
+ * na_tokens_template_new:
+ * @string: the input string, may or may not contain tokens.
+ *
+ * Compiles @string as a vector of literal slices and token codes, so
+ * that it may then be rendered without being parsed again.
+ *
+ * Returns: a new #NATokensTemplate, which should be
+ * na_tokens_template_free() by the caller, or %NULL if @string is %NULL.
+ */
+NATokensTemplate *
+na_tokens_template_new( const gchar *string )
 {
-	static const gchar *thisfn = "na_tokens_child_watch_fn";
+	NATokensTemplate *template;
 
-	g_debug( "%s: pid=%u, status=%d", thisfn, ( guint ) pid, status );
-	g_spawn_close_pid( pid );
-	if( child_str->is_output_displayed ){
-		display_output( child_str->command, child_str->child_stdout, child_str->child_stderr );
+	if( !string ){
+		return( NULL );
 	}
-	g_free( child_str->command );
-	g_free( child_str );
-}
-
-static void
-display_output( const gchar *command, int fd_stdout, int fd_stderr )
-{
-	GtkWidget *dialog;
-	gchar *std_output, *std_error;
 
-	dialog = gtk_message_dialog_new_with_markup(
-			NULL, GTK_DIALOG_MODAL, GTK_MESSAGE_INFO, GTK_BUTTONS_OK, "<b>%s</b>", _( "Output of the run command" ));
-	g_object_set( G_OBJECT( dialog ) , "title", PACKAGE_NAME, NULL );
+	if( !*string ){
+		return( &st_empty_template );
+	}
 
-	std_output = display_output_get_content( fd_stdout );
-	std_error = display_output_get_content( fd_stderr );
+	template = g_new0( NATokensTemplate, 1 );
+	template->string = g_strdup( string );
 
-	gtk_message_dialog_format_secondary_markup( GTK_MESSAGE_DIALOG( dialog ),
-			"<b>%s</b>\n%s\n\n<b>%s</b>\n%s\n\n<b>%s</b>\n%s\n\n",
-					_( "Run command:" ), command,
-					_( "Standard output:" ), std_output,
-					_( "Standard error:" ), std_error );
+	if( strchr( string, '%' )){
+		template_compile( template );
 
-	gtk_dialog_run( GTK_DIALOG( dialog ));
-	gtk_widget_destroy( dialog );
+	} else {
+		template->literal_length = strlen( string );
+	}
 
-	g_free( std_output );
-	g_free( std_error );
+	return( template );
 }
 
-static gchar *
-display_output_get_content( int fd )
+/*
+ * na_tokens_template_free:
+ * @template: a #NATokensTemplate, may be %NULL.
+ *
+ * Releases the @template.
+ */
+void
+na_tokens_template_free( NATokensTemplate *template )
 {
-	static const gchar *thisfn = "na_tokens_display_output_get_content";
-	GInputStream *stream;
-	GString *string;
-	gchar buf[1024];
-	GError *error;
-	gchar *msg;
-
-	string = g_string_new( "" );
-	memset( buf, '\0', sizeof( buf ));
+	if( template && template != &st_empty_template ){
+		g_free( template->ops );
+		g_free( template->string );
+		g_free( template );
+	}
+}
 
-	if( fd > 0 ){
-		stream = g_unix_input_stream_new( fd, TRUE );
-		error = NULL;
+/*
+ * na_tokens_template_has_tokens:
+ * @template: a #NATokensTemplate.
+ *
+ * Returns: %TRUE if the rendered @template may differ from the string
+ * it has been compiled from, %FALSE else.
+ */
+gboolean
+na_tokens_template_has_tokens( const NATokensTemplate *template )
+{
+	return( template && template->has_tokens );
+}
 
-		while( g_input_stream_read( stream, buf, sizeof( buf )-1, NULL, &error )){
-			string = g_string_append( string, buf );
-			memset( buf, '\0', sizeof( buf ));
-		}
-		if( error ){
-			g_warning( "%s: g_input_stream_read: %s", thisfn, error->message );
-			g_error_free( error );
-		}
-		g_input_stream_close( stream, NULL, NULL );
+/*
+ * na_tokens_template_render:
+ * @template: a #NATokensTemplate.
+ * @tokens: a #NATokens object.
+ * @i: the number of the iteration in a multiple selection, starting with zero.
+ * @quoted: whether the filenames have to be quoted (should be %TRUE when
+ *  about to execute a command).
+ *
+ * Expands the tokens of the @template in one pass. Templates without
+ * token are just copied.
+ *
+ * Returns: the expanded string, as a newly allocated string which should
+ * be g_free() by the caller, or %NULL if @template is %NULL.
+ */
+gchar *
+na_tokens_template_render( const NATokensTemplate *template, const NATokens *tokens, guint i, gboolean quoted )
+{
+	if( !template ){
+		return( NULL );
 	}
 
-	msg = g_locale_to_utf8( string->str, -1, NULL, NULL, NULL );
-	g_string_free( string, TRUE );
+	return( template_render( template, tokens, i, 0, tokens->private->count, quoted ));
+}
+
+static void
+child_watch_fn( GPid pid, gint status, ChildStr *child_str )
+{
+	static const gchar *thisfn = "na_tokens_child_watch_fn";
 
-	return( msg );
+	g_debug( "%s: pid=%u, status=%d", thisfn, ( guint ) pid, status );
+	g_spawn_close_pid( pid );
+	if( child_str->output ){
+		na_exec_output_child_exited( child_str->output, status );
+	}
+	if( child_str->pool ){
+		pool_child_exited( child_str->pool, status );
+	}
+	g_free( child_str->command );
+	g_free( child_str );
 }
 
 /*
@@ -488,8 +610,12 @@ display_output_get_content( int fd )
  * - Embedded: id. Terminal
  * - DisplayOutput: execute in a shell
  */
-static void
-execute_action_command( gchar *command, const NAObjectProfile *profile, const NATokens *tokens )
+/*
+ * Returns: %TRUE if a child has been started, which will be waited for
+ * in child_watch_fn(), %FALSE else.
+ */
+static gboolean
+execute_action_command( gchar *command, const NAObjectProfile *profile, const NATokens *tokens, ExecPool *pool )
 {
 	static const gchar *thisfn = "nautilus_actions_execute_action_command";
 	GError *error;
@@ -499,29 +625,21 @@ execute_action_command( gchar *command, const NAObjectProfile *profile, const NA
 	gchar *wdir, *wdir_nq;
 	GPid child_pid;
 	ChildStr *child_str;
+	gint child_stdout, child_stderr;
 
 	g_debug( "%s: profile=%p", thisfn, ( void * ) profile );
 
 	error = NULL;
 	run_command = NULL;
 	child_str = g_new0( ChildStr, 1 );
+	child_str->pool = pool;
 	child_pid = ( GPid ) 0;
 	execution_mode = na_object_get_execution_mode( profile );
 
-	if( !strcmp( execution_mode, "Normal" )){
-		run_command = get_command_execution_normal( command );
-
-	} else if( !strcmp( execution_mode, "Terminal" )){
-		run_command = get_command_execution_terminal( command );
+	child_str->is_output_displayed = !strcmp( execution_mode, "DisplayOutput" );
+	run_command = get_run_command( execution_mode, command );
 
-	} else if( !strcmp( execution_mode, "Embedded" )){
-		run_command = get_command_execution_embedded( command );
-
-	} else if( !strcmp( execution_mode, "DisplayOutput" )){
-		child_str->is_output_displayed = TRUE;
-		run_command = get_command_execution_display_output( command );
-
-	} else {
+	if( !run_command ){
 		g_warning( "%s: unknown execution mode: %s", thisfn, execution_mode );
 	}
 
@@ -534,7 +652,7 @@ execute_action_command( gchar *command, const NAObjectProfile *profile, const NA
 
 		} else {
 			wdir = na_object_get_working_dir( profile );
-			wdir_nq = parse_singular( tokens, wdir, 0, FALSE, FALSE );
+			wdir_nq = na_tokens_parse_for_display( tokens, wdir, FALSE );
 			g_debug( "%s: run_command=%s, wdir=%s", thisfn, run_command, wdir_nq );
 
 			/* it appears that at least mplayer does not support g_spawn_async_with_pipes
@@ -554,10 +672,14 @@ execute_action_command( gchar *command, const NAObjectProfile *profile, const NA
 						NULL,
 						&child_pid,
 						NULL,
-						&child_str->child_stdout,
-						&child_str->child_stderr,
+						&child_stdout,
+						&child_stderr,
 						&error );
 
+				if( !error ){
+					child_str->output = na_exec_output_new( child_str->command, child_stdout, child_stderr );
+				}
+
 			} else {
 				g_spawn_async(
 						wdir_nq,
@@ -593,6 +715,275 @@ execute_action_command( gchar *command, const NAObjectProfile *profile, const NA
 		g_free( child_str->command );
 		g_free( child_str );
 	}
+
+	return( child_pid != ( GPid ) 0 );
+}
+
+/*
+ * the selection is split in chunks which fit in the system limit of the
+ * size of the arguments, and the resulting command lines are run through
+ * a pool of concurrent children
+ *
+ * a command of singular form is run once per selected item, through the
+ * same pool
+ */
+static void
+execute_chunked( const NATokens *tokens, const NAObjectProfile *profile, const NATokensTemplate *template )
+{
+	static const gchar *thisfn = "na_tokens_execute_chunked";
+	ExecPool *pool;
+	glong limit, size, cost;
+	guint count, first, last;
+	gchar *command, *execution_mode;
+	gboolean requoted;
+
+	pool = g_new0( ExecPool, 1 );
+	pool->profile = g_object_ref(( gpointer ) profile );
+	pool->tokens = g_object_ref(( gpointer ) tokens );
+	pool->max_children = MAX( 1, na_settings_get_uint( NA_IPREFS_EXECUTION_MAX_CHILDREN, NULL, NULL ));
+
+	count = tokens->private->count;
+
+	if( template->singular ){
+		for( first = 0 ; first < count ; ++first ){
+			pool->pending = g_list_prepend( pool->pending, template_render( template, tokens, first, 0, count, TRUE ));
+		}
+
+	} else if( !count ){
+		pool->pending = g_list_prepend( pool->pending, template_render( template, tokens, 0, 0, 0, TRUE ));
+
+	} else {
+		execution_mode = na_object_get_execution_mode( profile );
+		requoted = ( strcmp( execution_mode, "Normal" ) != 0 );
+		limit = get_arg_limit( execution_mode );
+
+		for( first = 0 ; first < count ; first = last ){
+			command = template_render( template, tokens, first, first, first, TRUE );
+			size = strlen( command )+1;
+			g_free( command );
+
+			/* a chunk has at least one item, even if it does not fit
+			 */
+			for( last = first ; last < count ; ++last ){
+				cost = get_file_cost( template, tokens, last, requoted );
+				if( last > first && size+cost > limit ){
+					break;
+				}
+				size += cost;
+			}
+
+			/* the cost is only an estimation: the chunk is halved until
+			 * the actual command line fits
+			 */
+			command = template_render( template, tokens, first, first, last, TRUE );
+			while( last-first > 1 && !command_fits( execution_mode, command, limit )){
+				g_free( command );
+				last = first+( last-first )/2;
+				command = template_render( template, tokens, first, first, last, TRUE );
+			}
+
+			pool->pending = g_list_prepend( pool->pending, command );
+		}
+
+		g_free( execution_mode );
+	}
+
+	pool->pending = g_list_reverse( pool->pending );
+	pool->total = g_list_length( pool->pending );
+
+	g_debug( "%s: count=%u, commands=%u, max_children=%u", thisfn, count, pool->total, pool->max_children );
+
+	pool_fill( pool );
+}
+
+/*
+ * Returns: the size available for the command line
+ */
+static glong
+get_arg_limit( const gchar *execution_mode )
+{
+	glong limit;
+	gchar **env;
+
+	limit = sysconf( _SC_ARG_MAX );
+	if( limit <= 0 ){
+		limit = ARG_MAX_FALLBACK;
+	}
+
+	/* the environment of the child shares the same space
+	 */
+	for( env = environ ; env && *env ; ++env ){
+		limit -= strlen( *env )+1+sizeof( gchar * );
+	}
+
+	if( strcmp( execution_mode, "Normal" )){
+		limit = MIN( limit, ARG_STRLEN_MAX );
+	}
+
+	return( MAX( limit-ARG_MAX_MARGIN, ARG_MAX_MARGIN ));
+}
+
+/*
+ * Returns: the size added to the command line by the @i-th selected item,
+ * i.e. its quoted value for each plural token of the @template, plus the
+ * separator, plus the pointer of the argument
+ *
+ * when @requoted, the whole command is quoted again to be run in a
+ * terminal (see na_tokens_command_for_terminal()), and each single quote
+ * of the quoted value grows again
+ */
+static glong
+get_file_cost( const NATokensTemplate *template, const NATokens *tokens, guint i, gboolean requoted )
+{
+	glong cost;
+	const TemplateOp *op;
+	const gchar *value, *c;
+	guint n, quotes;
+
+	cost = 0;
+
+	for( n = 0, op = template->ops ; n < template->count ; ++n, ++op ){
+		if( !op->code || !g_ascii_isupper( op->code )){
+			continue;
+		}
+
+		value = file_get( tokens, i, g_ascii_tolower( op->code ));
+		if( !value ){
+			continue;
+		}
+
+		cost += strlen( value )+1+sizeof( gchar * );
+
+		for( quotes = 0, c = value ; *c ; ++c ){
+			quotes += ( *c == '\'' ) ? 1 : 0;
+		}
+
+		/* a quoted value is enclosed in single quotes, and each single
+		 * quote is itself replaced with four characters, three of them
+		 * being single quotes
+		 */
+		if( op->code != 'M' ){
+			cost += 2+3*quotes;
+			quotes = 2+3*quotes;
+		}
+
+		if( requoted ){
+			cost += 3*quotes;
+		}
+	}
+
+	return( cost );
+}
+
+/*
+ * Returns: %TRUE if the actual command line built from @command fits in
+ * the @limit, each argument being also smaller than MAX_ARG_STRLEN
+ */
+static gboolean
+command_fits( const gchar *execution_mode, const gchar *command, glong limit )
+{
+	gchar *run_command;
+	gchar **argv;
+	gint argc, i;
+	glong size, length;
+	gboolean fits;
+
+	fits = TRUE;
+	run_command = get_run_command( execution_mode, command );
+
+	if( run_command && g_shell_parse_argv( run_command, &argc, &argv, NULL )){
+		size = 0;
+		for( i = 0 ; i < argc && fits ; ++i ){
+			length = strlen( argv[i] )+1;
+			size += length+sizeof( gchar * );
+			fits = ( length <= ARG_STRLEN_MAX && size <= limit );
+		}
+		g_strfreev( argv );
+	}
+
+	g_free( run_command );
+
+	return( fits );
+}
+
+/*
+ * starts pending commands, up to the maximum count of concurrent
+ * children; an aggregated status is reported when the last child has
+ * exited, and the pool is released
+ */
+static void
+pool_fill( ExecPool *pool )
+{
+	static const gchar *thisfn = "na_tokens_pool_fill";
+	gchar *command;
+
+	while( pool->pending && pool->running < pool->max_children ){
+		command = ( gchar * ) pool->pending->data;
+		pool->pending = g_list_delete_link( pool->pending, pool->pending );
+
+		if( execute_action_command( command, pool->profile, pool->tokens, pool )){
+			pool->running += 1;
+		} else {
+			pool->failed += 1;
+			pool->last_status = -1;
+		}
+
+		g_free( command );
+	}
+
+	if( !pool->running && !pool->pending ){
+		if( pool->failed ){
+			g_warning( "%s: %u of %u command(s) failed, last status=%d",
+					thisfn, pool->failed, pool->total, pool->last_status );
+		} else {
+			g_debug( "%s: %u command(s) successfully run", thisfn, pool->total );
+		}
+
+		g_object_unref( pool->tokens );
+		g_object_unref( pool->profile );
+		g_free( pool );
+	}
+}
+
+static void
+pool_child_exited( ExecPool *pool, gint status )
+{
+	pool->running -= 1;
+
+	if( !WIFEXITED( status ) || WEXITSTATUS( status ) != 0 ){
+		pool->failed += 1;
+		pool->last_status = status;
+	}
+
+	pool_fill( pool );
+}
+
+/*
+ * Returns: the command line to be actually spawned for @command in the
+ * @execution_mode, as a newly allocated string which should be g_free()
+ * by the caller, or %NULL if the mode is unknown
+ */
+static gchar *
+get_run_command( const gchar *execution_mode, const gchar *command )
+{
+	gchar *run_command;
+
+	run_command = NULL;
+
+	if( !strcmp( execution_mode, "Normal" )){
+		run_command = get_command_execution_normal( command );
+
+	} else if( !strcmp( execution_mode, "Terminal" )){
+		run_command = get_command_execution_terminal( command );
+
+	} else if( !strcmp( execution_mode, "Embedded" )){
+		run_command = get_command_execution_embedded( command );
+
+	} else if( !strcmp( execution_mode, "DisplayOutput" )){
+		run_command = get_command_execution_display_output( command );
+	}
+
+	return( run_command );
 }
 
 static gchar *
@@ -654,27 +1045,56 @@ na_tokens_command_for_terminal( const gchar *pattern, const gchar *command )
 }
 
 /*
- * na_tokens_is_singular_exec:
- * @tokens: the current #NATokens object.
- * @exec: the to be executed command-line before having been parsed
+ * compiles @string into a vector of literal slices and token codes
  *
- * Returns: %TRUE if the first relevant parameter found in @exec
- * command-line is of singular form, %FALSE else.
+ * a '%' followed by an unknown character is removed, as is a final '%'
+ *
+ * the template is said of 'singular form' when its first relevant
+ * parameter is of singular form; all other parameters are irrelevant
+ * according to DES-EMA:
+ * c: selection count
+ * h: hostname
+ * n: username
+ * p: port
+ * s: scheme
+ * %: %
  */
-static gboolean
-is_singular_exec( const NATokens *tokens, const gchar *exec )
+static void
+template_compile( NATokensTemplate *template )
 {
-	gboolean singular;
+	GArray *ops;
+	TemplateOp op;
+	const gchar *begin, *iter;
 	gboolean found;
-	gchar *iter;
 
-	singular = FALSE;
+	ops = g_array_new( FALSE, FALSE, sizeof( TemplateOp ));
 	found = FALSE;
-	iter = ( gchar * ) exec;
+	begin = template->string;
+
+	for( iter = begin ; *iter ; ++iter ){
+		if( *iter != '%' ){
+			continue;
+		}
+
+		if( iter > begin ){
+			op.code = 0;
+			op.offset = begin - template->string;
+			op.length = iter - begin;
+			g_array_append_val( ops, op );
+			template->literal_length += op.length;
+		}
+
+		template->has_tokens = TRUE;
+
+		if( !iter[1] ){
+			begin = iter+1;
+			break;
+		}
 
-	while(( iter = g_strstr_len( iter, -1, "%" )) != NULL && !found ){
+		++iter;
+		begin = iter+1;
 
-		switch( iter[1] ){
+		switch( *iter ){
 			case 'b':
 			case 'd':
 			case 'f':
@@ -683,8 +1103,10 @@ is_singular_exec( const NATokens *tokens, const gchar *exec )
 			case 'u':
 			case 'w':
 			case 'x':
-				found = TRUE;
-				singular = TRUE;
+				if( !found ){
+					template->singular = TRUE;
+					found = TRUE;
+				}
 				break;
 
 			case 'B':
@@ -696,271 +1118,243 @@ is_singular_exec( const NATokens *tokens, const gchar *exec )
 			case 'W':
 			case 'X':
 				found = TRUE;
-				singular = FALSE;
 				break;
 
-			/* all other parameters are irrelevant according to DES-EMA
-			 * c: selection count
-			 * h: hostname
-			 * n: username
-			 * p: port
-			 * s: scheme
-			 * %: %
+			case 'c':
+			case 'h':
+			case 'n':
+			case 'p':
+			case 's':
+				break;
+
+			/* a percent sign is a literal slice of one character
 			 */
+			case '%':
+				begin = iter;
+				continue;
+
+			default:
+				continue;
 		}
 
-		iter += 2;			/* skip the % sign and the character after */
+		op.code = *iter;
+		op.offset = 0;
+		op.length = 0;
+		g_array_append_val( ops, op );
+	}
+
+	if( *begin ){
+		op.code = 0;
+		op.offset = begin - template->string;
+		op.length = strlen( begin );
+		g_array_append_val( ops, op );
+		template->literal_length += op.length;
 	}
 
-	return( singular );
+	template->count = ops->len;
+	template->ops = ( TemplateOp * ) g_array_free( ops, FALSE );
 }
 
 /*
- * parse_singular:
- * @tokens: a #NATokens object.
- * @input: the input string, may or may not contain tokens.
- * @i: the number of the iteration in a multiple selection, starting with zero.
- * @utf8: whether the @input string is UTF-8 encoded, or a standard ASCII
- *  string.
- * @quoted: whether the filenames have to be quoted (should be %TRUE when
- *  about to execute a command).
- *
- * A command is said of 'singular form' when its first parameter is not
- * of plural form. In the case of a multiple selection, singular form
- * commands are executed one time for each element of the selection
- *
- * Returns: a #GSList which contains two fields: the command and its parameters.
- * The returned #GSList should be na_core_utils_slist_free() by the caller.
+ * renders the @template, where the singular tokens refer to the @i-th
+ * selected item, and the plural tokens and the count to the [@from, @to)
+ * range of the selected items
  */
 static gchar *
-parse_singular( const NATokens *tokens, const gchar *input, guint i, gboolean utf8, gboolean quoted )
+template_render( const NATokensTemplate *template, const NATokens *tokens, guint i, guint from, guint to, gboolean quoted )
 {
 	GString *output;
-	gchar *iter, *prev_iter;
-	const gchar *nth;
-
-	output = g_string_new( "" );
+	const TemplateOp *op;
+	guint n;
 
-	/* return NULL if input is NULL
-	 */
-	if( !input ){
-		return( g_string_free( output, TRUE ));
+	if( !template->count ){
+		return( g_strdup( template->has_tokens ? "" : template->string ));
 	}
 
-	/* return an empty string if input is empty
-	 */
-	if( utf8 ){
-		if( !g_utf8_strlen( input, -1 )){
-			return( g_string_free( output, FALSE ));
-		}
-	} else {
-		if( !strlen( input )){
-			return( g_string_free( output, FALSE ));
+	output = g_string_sized_new( template->literal_length + template->count * 16 );
+
+	for( n = 0, op = template->ops ; n < template->count ; ++n, ++op ){
+		if( op->code ){
+			render_token( output, tokens, op->code, i, from, to, quoted );
+		} else {
+			g_string_append_len( output, template->string+op->offset, op->length );
 		}
 	}
 
-	iter = ( gchar * ) input;
-	prev_iter = iter;
-
-	while(( iter = g_strstr_len( iter, -1, "%" ))){
-		output = g_string_append_len( output, prev_iter, strlen( prev_iter ) - strlen( iter ));
-
-		switch( iter[1] ){
-			case 'b':
-				if( tokens->private->basenames ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->basenames, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
-				}
-				break;
-
-			case 'B':
-				if( tokens->private->basenames ){
-					output = quote_string_list( output, tokens->private->basenames, quoted );
-				}
-				break;
-
-			case 'c':
-				g_string_append_printf( output, "%d", tokens->private->count );
-				break;
-
-			case 'd':
-				if( tokens->private->basedirs ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->basedirs, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
-				}
-				break;
-
-			case 'D':
-				if( tokens->private->basedirs ){
-					output = quote_string_list( output, tokens->private->basedirs, quoted );
-				}
-				break;
+	return( g_string_free( output, FALSE ));
+}
 
-			case 'f':
-				if( tokens->private->filenames ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->filenames, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
+/*
+ * appends to @output the value of the @code token for the @i-th selected
+ * item, or for the [@from, @to) range of the selected items
+ */
+static void
+render_token( GString *output, const NATokens *tokens, gchar code, guint i, guint from, guint to, gboolean quoted )
+{
+	const gchar *value;
+	gboolean first;
+	guint n;
+
+	switch( code ){
+		/* mimetypes are never quoted
+		 */
+		case 'm':
+			quoted = FALSE;
+			/* fall through */
+
+		case 'b':
+		case 'd':
+		case 'f':
+		case 'u':
+		case 'w':
+		case 'x':
+			value = file_get( tokens, i, code );
+			if( value ){
+				quote_string( output, value, quoted );
+			}
+			break;
+
+		case 'M':
+			quoted = FALSE;
+			/* fall through */
+
+		/* space-separated lists, in the order of the selection
+		 */
+		case 'B':
+		case 'D':
+		case 'F':
+		case 'U':
+		case 'W':
+		case 'X':
+			for( n = from, first = TRUE ; n < to ; ++n ){
+				value = file_get( tokens, n, g_ascii_tolower( code ));
+				if( value ){
+					if( !first ){
+						g_string_append_c( output, ' ' );
 					}
+					quote_string( output, value, quoted );
+					first = FALSE;
 				}
-				break;
-
-			case 'F':
-				if( tokens->private->filenames ){
-					output = quote_string_list( output, tokens->private->filenames, quoted );
-				}
-				break;
-
-			case 'h':
-				if( tokens->private->hostname ){
-					output = quote_string( output, tokens->private->hostname, quoted );
-				}
-				break;
+			}
+			break;
+
+		/* the count of the items of the command line, which is the count
+		 * of the selected items unless the selection is split in chunks
+		 */
+		case 'c':
+			g_string_append_printf( output, "%u", to-from );
+			break;
+
+		case 'h':
+			if( tokens->private->hostname ){
+				quote_string( output, tokens->private->hostname, quoted );
+			}
+			break;
 
-			/* mimetypes are never quoted
-			 */
-			case 'm':
-				if( tokens->private->mimetypes ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->mimetypes, i );
-					if( nth ){
-						output = quote_string( output, nth, FALSE );
-					}
-				}
-				break;
+		/* no-op operators */
+		case 'o':
+		case 'O':
+			break;
 
-			case 'M':
-				if( tokens->private->mimetypes ){
-					output = quote_string_list( output, tokens->private->mimetypes, FALSE );
-				}
-				break;
+		case 'n':
+			if( tokens->private->username ){
+				quote_string( output, tokens->private->username, quoted );
+			}
+			break;
 
-			/* no-op operators */
-			case 'o':
-			case 'O':
-				break;
+		/* port number is never quoted
+		 */
+		case 'p':
+			if( tokens->private->port > 0 ){
+				g_string_append_printf( output, "%d", tokens->private->port );
+			}
+			break;
 
-			case 'n':
-				if( tokens->private->username ){
-					output = quote_string( output, tokens->private->username, quoted );
-				}
-				break;
+		case 's':
+			if( tokens->private->scheme ){
+				quote_string( output, tokens->private->scheme, quoted );
+			}
+			break;
+	}
+}
 
-			/* port number is never quoted
-			 */
-			case 'p':
-				if( tokens->private->port > 0 ){
-					g_string_append_printf( output, "%d", tokens->private->port );
-				}
-				break;
+/*
+ * returns the value of the field of the @i-th selected item which
+ * corresponds to the @code singular token, computing it on first need,
+ * so that a field is only computed if a template actually references it
+ */
+static const gchar *
+file_get( const NATokens *tokens, guint i, gchar code )
+{
+	TokensFile *file;
 
-			case 's':
-				if( tokens->private->scheme ){
-					output = quote_string( output, tokens->private->scheme, quoted );
-				}
-				break;
+	if( i >= tokens->private->count ){
+		return( NULL );
+	}
 
-			case 'u':
-				if( tokens->private->uris ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->uris, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
-				}
-				break;
+	file = tokens->private->files+i;
 
-			case 'U':
-				if( tokens->private->uris ){
-					output = quote_string_list( output, tokens->private->uris, quoted );
-				}
-				break;
+	switch( code ){
+		case 'u':
+			if( !( file->done & FILE_URI )){
+				file->uri = na_selected_info_get_uri( file->info );
+				file->done |= FILE_URI;
+			}
+			return( file->uri );
 
-			case 'w':
-				if( tokens->private->basenames_woext ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->basenames_woext, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
-				}
-				break;
+		case 'f':
+			if( !( file->done & FILE_FILENAME )){
+				file->filename = na_selected_info_get_path( file->info );
+				file->done |= FILE_FILENAME;
+			}
+			return( file->filename );
 
-			case 'W':
-				if( tokens->private->basenames_woext ){
-					output = quote_string_list( output, tokens->private->basenames_woext, quoted );
-				}
-				break;
+		case 'd':
+			if( !( file->done & FILE_BASEDIR )){
+				file->basedir = na_intern_ref( na_selected_info_peek_dirname( file->info ));
+				file->done |= FILE_BASEDIR;
+			}
+			return( file->basedir );
 
-			case 'x':
-				if( tokens->private->exts ){
-					nth = ( const gchar * ) g_slist_nth_data( tokens->private->exts, i );
-					if( nth ){
-						output = quote_string( output, nth, quoted );
-					}
-				}
-				break;
+		case 'b':
+			if( !( file->done & FILE_BASENAME )){
+				file->basename = na_selected_info_get_basename( file->info );
+				file->done |= FILE_BASENAME;
+			}
+			return( file->basename );
 
-			case 'X':
-				if( tokens->private->exts ){
-					output = quote_string_list( output, tokens->private->exts, quoted );
+		case 'w':
+		case 'x':
+			if( !( file->done & FILE_SPLIT )){
+				if( file_get( tokens, i, 'b' )){
+					na_core_utils_dir_split_ext( file->basename, &file->basename_woext, &file->ext );
 				}
-				break;
-
-			/* a percent sign
-			 */
-			case '%':
-				output = g_string_append_c( output, '%' );
-				break;
-		}
+				file->done |= FILE_SPLIT;
+			}
+			return( code == 'w' ? file->basename_woext : file->ext );
 
-		iter += 2;			/* skip the % sign and the character after */
-		prev_iter = iter;	/* store the new start of the string */
+		case 'm':
+			if( !( file->done & FILE_MIMETYPE )){
+				file->mimetype = na_intern_ref( na_selected_info_peek_mime_type( file->info ));
+				file->done |= FILE_MIMETYPE;
+			}
+			return( file->mimetype );
 	}
 
-	output = g_string_append_len( output, prev_iter, strlen( prev_iter ));
-
-	return( g_string_free( output, FALSE ));
+	return( NULL );
 }
 
-static GString *
-quote_string( GString *input, const gchar *name, gboolean quoted )
+static void
+quote_string( GString *output, const gchar *name, gboolean quoted )
 {
 	gchar *tmp;
 
 	if( quoted ){
 		tmp = g_shell_quote( name );
-		input = g_string_append( input, tmp );
+		g_string_append( output, tmp );
 		g_free( tmp );
 
 	} else {
-		input = g_string_append( input, name );
-	}
-
-	return( input );
-}
-
-static GString *
-quote_string_list( GString *input, GSList *names, gboolean quoted )
-{
-	GSList *it;
-	gchar *tmp;
-
-	if( quoted ){
-		GSList *quoted_names = NULL;
-		for( it = names ; it ; it = it->next ){
-			quoted_names = g_slist_append( quoted_names, g_shell_quote(( const gchar * ) it->data ));
-		}
-		tmp = na_core_utils_slist_join_at_end( quoted_names, " " );
-		na_core_utils_slist_free( quoted_names );
-
-	} else {
-		tmp = na_core_utils_slist_join_at_end( g_slist_reverse( names ), " " );
+		g_string_append( output, name );
 	}
-
-	input = g_string_append( input, tmp );
-	g_free( tmp );
-
-	return( input );
 }
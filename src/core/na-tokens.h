@@ -48,8 +48,8 @@
  * Adding a parameter requires updating of:
  * - doc/nact/C/figures/nact-legend.png screenshot
  * - doc/nact/C/nact-execution.xml "Multiple execution" paragraph
- * - src/core/na-tokens.c::is_singular_exec() function
- * - src/core/na-tokens.c::parse_singular() function
+ * - src/core/na-tokens.c::template_compile() function
+ * - src/core/na-tokens.c::render_token() function
  * - src/nact/nautilus-actions-config-tool.ui:LegendDialog labels
  * - src/core/na-object-profile-factory.c:NAFO_DATA_PARAMETERS comment
  *
@@ -77,6 +77,11 @@
  * %x: (first) extension
  * %X: space-separated list of extensions
  * %%: the « % » character
+ *
+ * A string which may embed tokens may be compiled once as a
+ * #NATokensTemplate, i.e. a vector of literal slices and token codes,
+ * and then rendered against as many #NATokens objects as needed without
+ * being parsed again.
  */
 
 #include <api/na-object-profile.h>
@@ -108,6 +113,8 @@ typedef struct {
 }
 	NATokensClass;
 
+typedef struct _NATokensTemplate      NATokensTemplate;
+
 GType     na_tokens_get_type            ( void );
 
 NATokens *na_tokens_new_for_example     ( void );
@@ -116,6 +123,11 @@ NATokens *na_tokens_new_from_selection  ( GList *selection );
 gchar    *na_tokens_parse_for_display   ( const NATokens *tokens, const gchar *string, gboolean utf8 );
 void      na_tokens_execute_action      ( const NATokens *tokens, const NAObjectProfile *profile );
 
+NATokensTemplate *na_tokens_template_new       ( const gchar *string );
+void              na_tokens_template_free      ( NATokensTemplate *template );
+gboolean          na_tokens_template_has_tokens( const NATokensTemplate *template );
+gchar            *na_tokens_template_render    ( const NATokensTemplate *template, const NATokens *tokens, guint i, gboolean quoted );
+
 gchar    *na_tokens_command_for_terminal( const gchar *pattern, const gchar *command );
 
 G_END_DECLS
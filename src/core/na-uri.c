@@ -0,0 +1,383 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2014 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+
+#include "na-uri.h"
+
+static void   set_slice( const NAUri *nau, NAUriSlice *slice, const gchar *begin, const gchar *end );
+static gchar *dup_slice( const NAUri *nau, const NAUriSlice *slice );
+
+/*
+ * na_uri_parse:
+ * @nau: the #NAUri structure to be set.
+ * @uri: the URI to be decomposed.
+ *
+ * Decomposes the @uri in one pass, as:
+ *   [scheme:][//[user[:password]@]host[:port]]path[#fragment]
+ *
+ * The @nau structure keeps its own copy of @uri, and should be released
+ * with na_uri_clear().
+ */
+void
+na_uri_parse( NAUri *nau, const gchar *uri )
+{
+	const gchar *p, *q, *end, *auth, *auth_end, *at, *colon, *slash, *dot, *base;
+
+	memset( nau, 0, sizeof( NAUri ));
+	nau->uri = g_strdup( uri ? uri : "" );
+	p = nau->uri;
+
+	/* scheme
+	 */
+	for( q = p ; g_ascii_isalnum( *q ) || *q == '+' || *q == '-' || *q == '.' ; ++q )
+		;
+	if( *q == ':' && q > p ){
+		set_slice( nau, &nau->scheme, p, q );
+		p = q+1;
+	}
+
+	/* the fragment identifier is not part of the path
+	 */
+	end = strchr( p, '#' );
+	if( !end ){
+		end = p + strlen( p );
+	}
+
+	/* authority: the user and the password are the part before the
+	 * last '@'
+	 */
+	if( p[0] == '/' && p[1] == '/' ){
+		auth = p+2;
+		at = NULL;
+		for( auth_end = auth ; auth_end < end && *auth_end != '/' ; ++auth_end ){
+			if( *auth_end == '@' ){
+				at = auth_end;
+			}
+		}
+
+		if( at ){
+			for( colon = auth ; colon < at && *colon != ':' ; ++colon )
+				;
+			set_slice( nau, &nau->user, auth, colon );
+			if( colon < at ){
+				set_slice( nau, &nau->password, colon+1, at );
+			}
+			auth = at+1;
+		}
+
+		/* an IPv6 address is kept with its brackets */
+		if( *auth == '[' ){
+			for( q = auth ; q < auth_end && *q != ']' ; ++q )
+				;
+			if( q < auth_end ){
+				++q;
+			}
+		} else {
+			for( q = auth ; q < auth_end && *q != ':' ; ++q )
+				;
+		}
+		set_slice( nau, &nau->host, auth, q );
+
+		if( q < auth_end && *q == ':' ){
+			for( ++q ; q < auth_end && g_ascii_isdigit( *q ) ; ++q ){
+				nau->port = 10 * nau->port + ( *q - '0' );
+				if( nau->port > 0xffff ){
+					nau->port = 0;
+					break;
+				}
+			}
+		}
+
+		p = auth_end;
+	}
+
+	/* path, with its dirname, basename and extension
+	 */
+	set_slice( nau, &nau->path, p, end );
+	nau->canonical = ( *p == '/' );
+	slash = NULL;
+	dot = NULL;
+
+	for( q = p ; q < end ; ++q ){
+		switch( *q ){
+			case '/':
+				if( q > p && q[-1] == '/' ){
+					nau->canonical = FALSE;
+				}
+				slash = q;
+				dot = NULL;
+				break;
+
+			case '.':
+				if( q > p && q[-1] == '/' &&
+						( q+1 == end || q[1] == '/' || ( q[1] == '.' && ( q+2 == end || q[2] == '/' )))){
+					nau->canonical = FALSE;
+				}
+				dot = q;
+				break;
+
+			case '%':
+				nau->canonical = FALSE;
+				break;
+		}
+	}
+
+	if( end-p > 1 && end[-1] == '/' ){
+		nau->canonical = FALSE;
+	}
+
+	base = slash ? slash+1 : p;
+	if( slash ){
+		set_slice( nau, &nau->dirname, p, slash == p ? slash+1 : slash );
+	}
+	set_slice( nau, &nau->basename, base, end );
+
+	if( dot && dot > base ){
+		set_slice( nau, &nau->extension, dot+1, end );
+	}
+}
+
+/*
+ * na_uri_clear:
+ * @nau: a #NAUri structure.
+ *
+ * Releases the resources allocated by na_uri_parse().
+ */
+void
+na_uri_clear( NAUri *nau )
+{
+	g_free( nau->uri );
+	memset( nau, 0, sizeof( NAUri ));
+}
+
+/*
+ * na_uri_get_scheme:
+ * @nau: a #NAUri structure.
+ *
+ * Returns: the lowercased scheme of the URI, defaulting to 'file', as a
+ * newly allocated string which should be g_free() by the caller.
+ */
+gchar *
+na_uri_get_scheme( const NAUri *nau )
+{
+	if( !nau->scheme.length ){
+		return( g_strdup( "file" ));
+	}
+
+	return( g_ascii_strdown( nau->uri + nau->scheme.offset, nau->scheme.length ));
+}
+
+/*
+ * na_uri_get_user:
+ * @nau: a #NAUri structure.
+ *
+ * Returns: the unescaped user of the URI, or %NULL, as a newly allocated
+ * string which should be g_free() by the caller.
+ */
+gchar *
+na_uri_get_user( const NAUri *nau )
+{
+	const gchar *begin;
+
+	if( !nau->user.length ){
+		return( NULL );
+	}
+
+	begin = nau->uri + nau->user.offset;
+
+	return( g_uri_unescape_segment( begin, begin + nau->user.length, NULL ));
+}
+
+/*
+ * na_uri_get_password:
+ * @nau: a #NAUri structure.
+ *
+ * Returns: the unescaped password of the URI, or %NULL, as a newly
+ * allocated string which should be g_free() by the caller.
+ */
+gchar *
+na_uri_get_password( const NAUri *nau )
+{
+	const gchar *begin;
+
+	if( !nau->password.length ){
+		return( NULL );
+	}
+
+	begin = nau->uri + nau->password.offset;
+
+	return( g_uri_unescape_segment( begin, begin + nau->password.length, NULL ));
+}
+
+/*
+ * na_uri_get_host:
+ * @nau: a #NAUri structure.
+ *
+ * Returns: the host of the URI, or %NULL, as a newly allocated string
+ * which should be g_free() by the caller.
+ */
+gchar *
+na_uri_get_host( const NAUri *nau )
+{
+	return( dup_slice( nau, &nau->host ));
+}
+
+/*
+ * na_uri_get_port:
+ * @nau: a #NAUri structure.
+ *
+ * Returns: the port of the URI, or zero.
+ */
+guint
+na_uri_get_port( const NAUri *nau )
+{
+	return( nau->port );
+}
+
+/*
+ * na_uri_get_path:
+ * @nau: a #NAUri structure.
+ *
+ * Returns: the path of the URI, as found in the URI, or '/' if empty,
+ * as a newly allocated string which should be g_free() by the caller.
+ */
+gchar *
+na_uri_get_path( const NAUri *nau )
+{
+	if( !nau->path.length ){
+		return( g_strdup( "/" ));
+	}
+
+	return( dup_slice( nau, &nau->path ));
+}
+
+/*
+ * na_uri_get_dirname:
+ * @nau: a #NAUri structure.
+ *
+ * Returns: the dirname of the path of the URI, which, for a canonical
+ * path, has the same semantic
+ * than g_path_get_dirname(), as a newly allocated string which should
+ * be g_free() by the caller.
+ */
+gchar *
+na_uri_get_dirname( const NAUri *nau )
+{
+	if( !nau->dirname.length ){
+		return( g_strdup( nau->path.length ? "." : "/" ));
+	}
+
+	return( dup_slice( nau, &nau->dirname ));
+}
+
+/*
+ * na_uri_get_basename:
+ * @nau: a #NAUri structure.
+ *
+ * Returns: the basename of the path of the URI, which, for a canonical
+ * path, has the same semantic
+ * than g_path_get_basename(), as a newly allocated string which should
+ * be g_free() by the caller.
+ */
+gchar *
+na_uri_get_basename( const NAUri *nau )
+{
+	if( !nau->basename.length ){
+		return( g_strdup( "/" ));
+	}
+
+	return( dup_slice( nau, &nau->basename ));
+}
+
+/*
+ * na_uri_get_extension:
+ * @nau: a #NAUri structure.
+ *
+ * Returns: the part of the basename after its last dot, or %NULL, as a
+ * newly allocated string which should be g_free() by the caller.
+ */
+gchar *
+na_uri_get_extension( const NAUri *nau )
+{
+	return( dup_slice( nau, &nau->extension ));
+}
+
+/*
+ * na_uri_has_scheme:
+ * @nau: a #NAUri structure.
+ * @scheme: a scheme.
+ *
+ * Returns: %TRUE if the scheme of the URI is @scheme, case insensitively,
+ * %FALSE else.
+ */
+gboolean
+na_uri_has_scheme( const NAUri *nau, const gchar *scheme )
+{
+	if( !nau->scheme.length ){
+		return( g_ascii_strcasecmp( scheme, "file" ) == 0 );
+	}
+
+	return( strlen( scheme ) == nau->scheme.length &&
+			g_ascii_strncasecmp( nau->uri + nau->scheme.offset, scheme, nau->scheme.length ) == 0 );
+}
+
+/*
+ * na_uri_is_canonical:
+ * @nau: a #NAUri structure.
+ *
+ * Returns: %TRUE if the path of the URI is already canonical, so that its
+ * dirname and basename do not need any further interpretation.
+ */
+gboolean
+na_uri_is_canonical( const NAUri *nau )
+{
+	return( nau->canonical );
+}
+
+static void
+set_slice( const NAUri *nau, NAUriSlice *slice, const gchar *begin, const gchar *end )
+{
+	slice->offset = begin - nau->uri;
+	slice->length = end - begin;
+}
+
+static gchar *
+dup_slice( const NAUri *nau, const NAUriSlice *slice )
+{
+	if( !slice->length ){
+		return( NULL );
+	}
+
+	return( g_strndup( nau->uri + slice->offset, slice->length ));
+}
@@ -0,0 +1,94 @@
+/*
+ * Nautilus-Actions
+ * A Nautilus extension which offers configurable context menu actions.
+ *
+ * Copyright (C) 2005 The GNOME Foundation
+ * Copyright (C) 2006-2008 Frederic Ruaudel and others (see AUTHORS)
+ * Copyright (C) 2009-2014 Pierre Wieser and others (see AUTHORS)
+ *
+ * Nautilus-Actions is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Nautilus-Actions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Nautilus-Actions; see the file COPYING. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *   Frederic Ruaudel <grumz@grumz.net>
+ *   Rodrigo Moya <rodrigo@gnome-db.org>
+ *   Pierre Wieser <pwieser@trychlos.org>
+ *   ... and many others (see AUTHORS)
+ */
+
+#ifndef __CORE_NA_URI_H__
+#define __CORE_NA_URI_H__
+
+/* @title: NAUri
+ * @short_description: A single-pass decomposition of an URI.
+ * @include: core/na-uri.h
+ *
+ * na_uri_parse() keeps one copy of the URI, and only records the
+ * offset and length of its components: the scheme, the user, the
+ * password, the host, the port, the path, and the dirname, basename and
+ * extension of the path.
+ *
+ * The components are only allocated when they are actually requested,
+ * through the na_uri_get_*() functions.
+ *
+ * Contrarily to na_gnome_vfs_uri_parse(), the path is not canonicalized:
+ * na_uri_is_canonical() tells if the path of the URI is already in a
+ * canonical form, i.e. an absolute path without escaped character, empty,
+ * '.' or '..' segment, nor trailing slash.
+ */
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct {
+	guint offset;
+	guint length;
+}
+	NAUriSlice;
+
+typedef struct {
+	gchar      *uri;
+	NAUriSlice  scheme;					/* empty if implicit 'file' */
+	NAUriSlice  user;
+	NAUriSlice  password;
+	NAUriSlice  host;
+	guint       port;
+	NAUriSlice  path;
+	NAUriSlice  dirname;
+	NAUriSlice  basename;
+	NAUriSlice  extension;
+	gboolean    canonical;
+}
+	NAUri;
+
+void     na_uri_parse        ( NAUri *nau, const gchar *uri );
+void     na_uri_clear        ( NAUri *nau );
+
+gchar   *na_uri_get_scheme   ( const NAUri *nau );
+gchar   *na_uri_get_user     ( const NAUri *nau );
+gchar   *na_uri_get_password ( const NAUri *nau );
+gchar   *na_uri_get_host     ( const NAUri *nau );
+guint    na_uri_get_port     ( const NAUri *nau );
+gchar   *na_uri_get_path     ( const NAUri *nau );
+gchar   *na_uri_get_dirname  ( const NAUri *nau );
+gchar   *na_uri_get_basename ( const NAUri *nau );
+gchar   *na_uri_get_extension( const NAUri *nau );
+
+gboolean na_uri_has_scheme   ( const NAUri *nau, const gchar *scheme );
+gboolean na_uri_is_canonical ( const NAUri *nau );
+
+G_END_DECLS
+
+#endif /* __CORE_NA_URI_H__ */
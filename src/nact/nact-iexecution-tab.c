@@ -69,6 +69,7 @@ static void            on_terminal_mode_toggled( GtkToggleButton *togglebutton,
 static void            on_embedded_mode_toggled( GtkToggleButton *togglebutton, NactIExecutionTab *instance );
 static void            on_display_mode_toggled( GtkToggleButton *togglebutton, NactIExecutionTab *instance );
 static void            execution_mode_toggle( NactIExecutionTab *instance, GtkToggleButton *togglebutton, GCallback cb, const gchar *mode );
+static void            on_execution_chunked_toggled( GtkToggleButton *togglebutton, NactIExecutionTab *instance );
 static void            on_startup_notify_toggled( GtkToggleButton *togglebutton, NactIExecutionTab *instance );
 static void            on_startup_class_changed( GtkEntry *entry, NactIExecutionTab *instance );
 static void            on_execute_as_changed( GtkEntry *entry, NactIExecutionTab *instance );
@@ -227,6 +228,12 @@ on_base_initialize_window( NactIExecutionTab *instance, void *user_data )
 			"toggled",
 			G_CALLBACK( on_display_mode_toggled ));
 
+	base_window_signal_connect_by_name(
+			BASE_WINDOW( instance ),
+			"ExecutionChunkedButton",
+			"toggled",
+			G_CALLBACK( on_execution_chunked_toggled ));
+
 	base_window_signal_connect_by_name(
 			BASE_WINDOW( instance ),
 			"StartupNotifyButton",
@@ -255,8 +262,8 @@ on_main_selection_changed( NactIExecutionTab *instance, GList *selected_items, g
 	gboolean enable_tab;
 	gchar *mode;
 	GtkWidget *normal_toggle, *terminal_toggle, *embedded_toggle, *display_toggle;
-	gboolean notify;
-	GtkWidget *notify_check, *frame;
+	gboolean notify, chunked;
+	GtkWidget *notify_check, *chunked_check, *frame;
 	gchar *class, *user;
 	GtkWidget *entry;
 	IExecutionData *data;
@@ -314,6 +321,11 @@ on_main_selection_changed( NactIExecutionTab *instance, GList *selected_items, g
 
 	g_free( mode );
 
+	chunked = profile ? na_object_get_execution_chunked( profile ) : FALSE;
+	chunked_check = base_window_get_widget( BASE_WINDOW( instance ), "ExecutionChunkedButton" );
+	base_gtk_utils_set_editable( G_OBJECT( chunked_check ), editable );
+	gtk_toggle_button_set_active( GTK_TOGGLE_BUTTON( chunked_check ), chunked );
+
 	frame = base_window_get_widget( BASE_WINDOW( instance ), "StartupModeFrame" );
 	gtk_widget_set_sensitive( frame, FALSE );
 
@@ -401,6 +413,34 @@ execution_mode_toggle( NactIExecutionTab *instance, GtkToggleButton *toggle_butt
 	}
 }
 
+static void
+on_execution_chunked_toggled( GtkToggleButton *toggle_button, NactIExecutionTab *instance )
+{
+	NAObjectProfile *profile;
+	gboolean editable;
+	gboolean active;
+
+	g_object_get(
+			G_OBJECT( instance ),
+			MAIN_PROP_PROFILE, &profile,
+			MAIN_PROP_EDITABLE, &editable,
+			NULL );
+
+	if( profile ){
+		active = gtk_toggle_button_get_active( toggle_button );
+
+		if( editable ){
+			na_object_set_execution_chunked( profile, active );
+			g_signal_emit_by_name( G_OBJECT( instance ), TAB_UPDATABLE_SIGNAL_ITEM_UPDATED, profile, 0 );
+
+		} else {
+			g_signal_handlers_block_by_func(( gpointer ) toggle_button, on_execution_chunked_toggled, instance );
+			gtk_toggle_button_set_active( toggle_button, !active );
+			g_signal_handlers_unblock_by_func(( gpointer ) toggle_button, on_execution_chunked_toggled, instance );
+		}
+	}
+}
+
 static void
 on_startup_notify_toggled( GtkToggleButton *toggle_button, NactIExecutionTab *instance )
 {
@@ -989,12 +989,10 @@ append_item( GtkTreeStore *model, GtkTreeView *treeview, GtkTreeIter *parent, Gt
 static void
 display_item( GtkTreeStore *model, GtkTreeView *treeview, GtkTreeIter *iter, const NAObject *object )
 {
-	gchar *label = na_object_get_label( object );
-	gtk_tree_store_set( model, iter, TREE_COLUMN_LABEL, label, -1 );
-	g_free( label );
+	gtk_tree_store_set( model, iter, TREE_COLUMN_LABEL, na_object_peek_label( object ), -1 );
 
 	if( NA_IS_OBJECT_ITEM( object )){
-		gchar *icon_name = na_object_get_icon( object );
+		const gchar *icon_name = na_object_peek_icon( object );
 		GdkPixbuf *icon = base_gtk_utils_get_pixbuf( icon_name, GTK_WIDGET( treeview ), GTK_ICON_SIZE_MENU );
 		gtk_tree_store_set( model, iter, TREE_COLUMN_ICON, icon, -1 );
 		g_object_unref( icon );
@@ -1149,7 +1149,6 @@ static void
 display_label( GtkTreeViewColumn *column, GtkCellRenderer *cell, GtkTreeModel *model, GtkTreeIter *iter, NactTreeView *view )
 {
 	NAObject *object;
-	gchar *label;
 
 	g_return_if_fail( view->private->mode == TREE_MODE_EDITION );
 
@@ -1159,7 +1158,6 @@ display_label( GtkTreeViewColumn *column, GtkCellRenderer *cell, GtkTreeModel *m
 		g_object_unref( object );
 		g_return_if_fail( NA_IS_OBJECT( object ));
 
-		label = na_object_get_label( object );
 		g_object_set( cell, "style-set", FALSE, NULL );
 		g_object_set( cell, "foreground-set", FALSE, NULL );
 
@@ -1171,8 +1169,7 @@ display_label( GtkTreeViewColumn *column, GtkCellRenderer *cell, GtkTreeModel *m
 			g_object_set( cell, "foreground", "Red", "foreground-set", TRUE, NULL );
 		}
 
-		g_object_set( cell, "text", label, NULL );
-		g_free( label );
+		g_object_set( cell, "text", na_object_peek_label( object ), NULL );
 	}
 }
 
@@ -31,7 +31,9 @@
 #include <config.h>
 #endif
 
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <glib/gi18n.h>
 
@@ -45,6 +47,7 @@
 
 #include <core/na-pivot.h>
 #include <core/na-about.h>
+#include <core/na-dynamic-condition.h>
 #include <core/na-selected-info.h>
 #include <core/na-tokens.h>
 
@@ -64,11 +67,115 @@ struct _NautilusActionsPrivate {
 	gulong    items_changed_handler;
 	gulong    settings_changed_handler;
 	NATimeout change_timeout;
+
+	/* menu cache
+	 */
+	GHashTable *menu_cache;
+	GQueue     *menu_lru;
+	gint        count_limit;
+	gint        needs_attributes;
+	guint       cache_hits;
+	guint       cache_misses;
+
+	/* selected items cache
+	 */
+	GHashTable *info_cache;
+	GQueue     *info_lru;
+};
+
+/* the menu cache
+ *
+ * the selections are characterized by a signature, which only contains
+ * the informations the candidacy of a 'static' item depends on (see
+ * na_icontext_is_static()); two selections which share the same
+ * signature so have the same candidate items and profiles.
+ *
+ * the cache keeps the candidates found for the most recently seen
+ * signatures, so that only the tokens expansion has to be done when the
+ * user comes back to a selection of same shape.
+ *
+ * a non-static item is kept as 'volatile', and fully re-evaluated each
+ * time the menu is built.
+ */
+typedef struct {
+	gchar *signature;
+	GList *candidates;
+}
+	MenuCacheEntry;
+
+typedef struct {
+	NAObjectItem *item;
+	gboolean      is_volatile;
+	gchar        *profile_id;
+	GList        *children;
+}
+	MenuCandidate;
+
+/* a distinct tuple of the selection signature
+ * the strings are interned, and owned by the NASelectedInfo objects
+ */
+typedef struct {
+	const gchar *mimetype;
+	const gchar *scheme;
+	const gchar *dirname;
+	guint        flags;
+}
+	SignatureTuple;
+
+/* the selected items cache
+ *
+ * the NASelectedInfo objects built for the most recently selected files
+ * are kept, keyed by URI, so that extending a selection, or coming back
+ * to it, only has to build the new items.
+ *
+ * an entry is invalidated when the file manager signals that its file
+ * has changed, when this file is finalized, or after a short TTL.
+ */
+typedef struct {
+	gchar            *uri;
+	NASelectedInfo   *info;
+	NautilusFileInfo *file;				/* not referenced */
+	gulong            changed_handler;
+	gint64            stamp;
+	NautilusActions  *plugin;
+}
+	InfoCacheEntry;
+
+/* the fields which may embed tokens
+ *
+ * a bitmap of the fields which actually embed tokens is attached to each
+ * item and profile when the items are loaded, so that only these fields
+ * have to be expanded when building the menu
+ *
+ * these fields are compiled at the same time, and their templates are
+ * attached to the item or profile, indexed by the bit of the field
+ * (but the items list, which is expanded item by item)
+ */
+enum {
+	TOKENS_LABEL              = 1 << 0,
+	TOKENS_TOOLTIP            = 1 << 1,
+	TOKENS_ICON               = 1 << 2,
+	TOKENS_TOOLBAR_LABEL      = 1 << 3,
+	TOKENS_ITEMS_SLIST        = 1 << 4,
+	TOKENS_WORKING_DIR        = 1 << 5,
+	TOKENS_TRY_EXEC           = 1 << 6,
+	TOKENS_SHOW_IF_REGISTERED = 1 << 7,
+	TOKENS_SHOW_IF_TRUE       = 1 << 8,
+	TOKENS_SHOW_IF_RUNNING    = 1 << 9,
+	TOKENS_PROFILES           = 1 << 10,
+	TOKENS_COMPUTED           = 1 << 11
 };
 
+#define TOKENS_FIELDS					10
+
+#define NAUTILUS_ACTIONS_DATA_TOKENS	"nautilus-actions-data-tokens"
+#define NAUTILUS_ACTIONS_DATA_TEMPLATES	"nautilus-actions-data-templates"
+
 static GObjectClass *st_parent_class  = NULL;
 static GType         st_actions_type  = 0;
 static gint          st_burst_timeout = 100;		/* burst timeout in msec */
+static guint         st_menu_cache_size = 16;		/* count of cached signatures */
+static guint         st_info_cache_size = 4096;		/* count of cached selected items */
 
 static void              class_init( NautilusActionsClass *klass );
 static void              instance_init( GTypeInstance *instance, gpointer klass );
@@ -85,11 +192,26 @@ static GList            *menu_provider_get_toolbar_items( NautilusMenuProvider *
 #endif
 
 static GList            *build_nautilus_menu( NautilusActions *plugin, guint target, GList *selection );
-static GList            *build_nautilus_menu_rec( GList *tree, guint target, GList *selection, NATokens *tokens );
+static GList            *build_nautilus_menu_rec( GList *tree, guint target, GList *selection, NATokens *tokens, GHashTable *filter, GList **candidates );
+static GList            *build_nautilus_menu_from_cache( GList *candidates, guint target, GList *selection, NATokens *tokens );
+static GList            *append_submenu( GList *nautilus_menu, NAObjectMenu *menu, GList *submenu, guint target );
+static void              dispatch_dynamic_conditions_rec( GList *tree, guint target, GList *selection, NATokens *tokens, GHashTable *filter );
+static void              dispatch_dynamic_conditions_from_cache( GList *candidates, guint target, GList *selection, NATokens *tokens );
+static void              dispatch_dynamic_conditions_context( const NAObject *object, NATokens *tokens );
+static void              dispatch_dynamic_condition( const NAObject *object, guint field, NADynamicCondition type, const gchar *value, NATokens *tokens );
+static gboolean          is_static_item( const NAObjectItem *item );
 static NAObjectItem     *expand_tokens_item( const NAObjectItem *item, NATokens *tokens );
-static void              expand_tokens_context( NAIContext *context, NATokens *tokens );
+static NAObjectProfile  *expand_tokens_profile( const NAObjectProfile *profile, NATokens *tokens );
+static void              expand_tokens_context( const NAIContext *src, NAIContext *context, NATokens *tokens, guint mask );
+static guint             get_tokens_mask( const NAObject *object );
+static guint             get_tokens_context_mask( const NAIContext *context );
+static void              set_tokens_mask_rec( GList *tree );
+static gboolean          has_tokens( const gchar *string );
+static guint             compile_template( const NAObject *object, guint field, const gchar *string );
+static gchar            *render_template( const NAObject *object, guint field, NATokens *tokens );
+static void              free_templates( NATokensTemplate **templates );
 static NAObjectProfile  *get_candidate_profile( NAObjectAction *action, guint target, GList *files );
-static NautilusMenuItem *create_item_from_profile( NAObjectProfile *profile, guint target, GList *files, NATokens *tokens );
+static NautilusMenuItem *create_item_from_profile( NAObjectAction *action, NAObjectProfile *profile, guint target, GList *files, NATokens *tokens );
 static NautilusMenuItem *create_item_from_menu( NAObjectMenu *menu, GList *subitems, guint target );
 static NautilusMenuItem *create_menu_item( const NAObjectItem *item, guint target );
 static void              weak_notify_menu_item( void *user_data /* =NULL */, NautilusMenuItem *item );
@@ -105,6 +227,30 @@ static void              execute_about( NautilusMenuItem *item, NautilusActions
 static void              on_pivot_items_changed_handler( NAPivot *pivot, NautilusActions *plugin );
 static void              on_settings_key_changed_handler( const gchar *group, const gchar *key, gconstpointer new_value, gboolean mandatory, NautilusActions *plugin );
 static void              on_change_event_timeout( NautilusActions *plugin );
+static void              on_dynamic_condition_late( NautilusActions *plugin );
+
+static gchar            *menu_cache_get_signature( NautilusActions *plugin, guint target, GList *selection );
+static guint             signature_tuple_hash( const SignatureTuple *tuple );
+static gboolean          signature_tuple_equal( const SignatureTuple *a, const SignatureTuple *b );
+static gint              signature_tuple_compare( const SignatureTuple *a, const SignatureTuple *b );
+static gint              menu_cache_get_count_limit( GList *tree );
+static gboolean          menu_cache_get_needs_attributes( GList *tree );
+static MenuCacheEntry   *menu_cache_lookup( NautilusActions *plugin, const gchar *signature );
+static void              menu_cache_insert( NautilusActions *plugin, gchar *signature, GList *candidates );
+static void              menu_cache_flush( NautilusActions *plugin );
+static void              menu_cache_entry_free( MenuCacheEntry *entry );
+static GList            *info_cache_get_list_from_item( NautilusActions *plugin, NautilusFileInfo *item );
+static GList            *info_cache_get_list_from_list( NautilusActions *plugin, GList *files );
+static NASelectedInfo   *info_cache_get( NautilusActions *plugin, NautilusFileInfo *file, guint ttl, gint64 now );
+static void              info_cache_remove( NautilusActions *plugin, InfoCacheEntry *entry );
+static void              info_cache_flush( NautilusActions *plugin );
+static void              info_cache_entry_free( InfoCacheEntry *entry );
+static gint64            info_cache_get_time( void );
+static void              on_info_cache_file_changed( NautilusFileInfo *file, InfoCacheEntry *entry );
+static void              on_info_cache_file_finalized( InfoCacheEntry *entry, GObject *file );
+static MenuCandidate    *menu_candidate_new( const NAObjectItem *item, gboolean is_volatile );
+static void              menu_candidate_free( MenuCandidate *candidate );
+static void              menu_candidate_list_free( GList *candidates );
 
 GType
 nautilus_actions_get_type( void )
@@ -183,6 +329,16 @@ instance_init( GTypeInstance *instance, gpointer klass )
 	self->private->change_timeout.handler = ( NATimeoutFunc ) on_change_event_timeout;
 	self->private->change_timeout.user_data = self;
 	self->private->change_timeout.source_id = 0;
+
+	self->private->menu_cache = g_hash_table_new( g_str_hash, g_str_equal );
+	self->private->menu_lru = g_queue_new();
+	self->private->count_limit = -1;
+	self->private->needs_attributes = -1;
+	self->private->cache_hits = 0;
+	self->private->cache_misses = 0;
+
+	self->private->info_cache = g_hash_table_new( g_str_hash, g_str_equal );
+	self->private->info_lru = g_queue_new();
 }
 
 /*
@@ -221,6 +377,7 @@ instance_constructed( GObject *object )
 		 */
 		na_pivot_set_loadable( priv->pivot, !PIVOT_LOAD_DISABLED & !PIVOT_LOAD_INVALID );
 		na_pivot_load_items( priv->pivot );
+		set_tokens_mask_rec( na_pivot_get_items( priv->pivot ));
 
 		/* register against NAPivot to be notified of items changes
 		 */
@@ -259,6 +416,13 @@ instance_constructed( GObject *object )
 				NA_IPREFS_ITEMS_LIST_ORDER_MODE,
 				G_CALLBACK( on_settings_key_changed_handler ),
 				object );
+
+		/* be notified when the result of a dynamic condition arrives
+		 * after the deadline of its menu
+		 */
+		na_dynamic_condition_set_late_handler(
+				( NADynamicConditionFunc ) on_dynamic_condition_late,
+				object );
 	}
 }
 
@@ -276,11 +440,16 @@ instance_dispose( GObject *object )
 
 		self->private->dispose_has_run = TRUE;
 
+		na_dynamic_condition_set_late_handler( NULL, NULL );
+
 		if( self->private->items_changed_handler ){
 			g_signal_handler_disconnect( self->private->pivot, self->private->items_changed_handler );
 		}
 		g_object_unref( self->private->pivot );
 
+		menu_cache_flush( self );
+		info_cache_flush( self );
+
 		/* chain up to the parent class */
 		if( G_OBJECT_CLASS( st_parent_class )->dispose ){
 			G_OBJECT_CLASS( st_parent_class )->dispose( object );
@@ -298,6 +467,11 @@ instance_finalize( GObject *object )
 	g_return_if_fail( NAUTILUS_IS_ACTIONS( object ));
 	self = NAUTILUS_ACTIONS( object );
 
+	g_hash_table_destroy( self->private->menu_cache );
+	g_queue_free( self->private->menu_lru );
+	g_hash_table_destroy( self->private->info_cache );
+	g_queue_free( self->private->info_lru );
+
 	g_free( self->private );
 
 	/* chain up to the parent class */
@@ -350,7 +524,7 @@ menu_provider_get_background_items( NautilusMenuProvider *provider, GtkWidget *w
 
 	if( !NAUTILUS_ACTIONS( provider )->private->dispose_has_run ){
 
-		selected = na_selected_info_get_list_from_item( current_folder );
+		selected = info_cache_get_list_from_item( NAUTILUS_ACTIONS( provider ), current_folder );
 
 		if( selected ){
 			uri = nautilus_file_info_get_uri( current_folder );
@@ -395,7 +569,7 @@ menu_provider_get_file_items( NautilusMenuProvider *provider, GtkWidget *window,
 			return(( GList * ) NULL );
 		}
 
-		selected = na_selected_info_get_list_from_list(( GList * ) files );
+		selected = info_cache_get_list_from_list( NAUTILUS_ACTIONS( provider ), files );
 
 		if( selected ){
 			g_debug( "%s: provider=%p, window=%p, files=%p, count=%d",
@@ -447,7 +621,7 @@ menu_provider_get_toolbar_items( NautilusMenuProvider *provider, GtkWidget *wind
 
 	if( !NAUTILUS_ACTIONS( provider )->private->dispose_has_run ){
 
-		selected = na_selected_info_get_list_from_item( current_folder );
+		selected = info_cache_get_list_from_item( NAUTILUS_ACTIONS( provider ), current_folder );
 
 		if( selected ){
 			uri = nautilus_file_info_get_uri( current_folder );
@@ -483,24 +657,84 @@ menu_provider_get_toolbar_items( NautilusMenuProvider *provider, GtkWidget *wind
  *
  * Build the Nautilus menu as a list of NautilusMenuItem items
  *
+ * The candidates found for a selection are cached, so that a next
+ * selection of same shape only has to expand the tokens.
+ *
  * Returns: the Nautilus menu
  */
 static GList *
 build_nautilus_menu( NautilusActions *plugin, guint target, GList *selection )
 {
+	static const gchar *thisfn = "nautilus_actions_build_nautilus_menu";
 	GList *nautilus_menu;
 	NATokens *tokens;
 	GList *tree;
 	gboolean items_add_about_item;
 	gboolean items_create_root_menu;
+	gchar *signature;
+	MenuCacheEntry *entry;
+	GList *candidates;
+	GHashTable *filter;
 
 	g_return_val_if_fail( NA_IS_PIVOT( plugin->private->pivot ), NULL );
 
 	tokens = na_tokens_new_from_selection( selection );
 
-	tree = na_pivot_get_items( plugin->private->pivot );
+	/* the per-file conditions are evaluated once per class of files
+	 */
+	na_icontext_begin_selection( selection );
+
+	/* when at least one item depends on them, the attributes of the
+	 * selected items are queried in parallel, within a deadline
+	 */
+	if( plugin->private->needs_attributes < 0 ){
+		plugin->private->needs_attributes = menu_cache_get_needs_attributes( na_pivot_get_items( plugin->private->pivot ));
+	}
+	if( plugin->private->needs_attributes ){
+		na_selected_info_query_list( selection,
+				na_settings_get_uint( NA_IPREFS_SELECTION_ATTRIBUTES_MAX_QUERIES, NULL, NULL ),
+				na_settings_get_uint( NA_IPREFS_SELECTION_ATTRIBUTES_DEADLINE, NULL, NULL ));
+	}
+
+	signature = menu_cache_get_signature( plugin, target, selection );
+	entry = menu_cache_lookup( plugin, signature );
+
+	/* the dynamic conditions of the menu are evaluated within a deadline:
+	 * those of all the items which may be candidate are first dispatched
+	 * to the worker threads, so that they are evaluated in parallel, and
+	 * their results are then read when checking each item
+	 */
+	na_dynamic_condition_begin_menu();
+
+	if( entry ){
+		plugin->private->cache_hits += 1;
+		g_debug( "%s: menu cache hit (hits=%u, misses=%u)",
+				thisfn, plugin->private->cache_hits, plugin->private->cache_misses );
+
+		dispatch_dynamic_conditions_from_cache( entry->candidates, target, selection, tokens );
+		nautilus_menu = build_nautilus_menu_from_cache( entry->candidates, target, selection, tokens );
+		g_free( signature );
+
+	} else {
+		plugin->private->cache_misses += 1;
+		g_debug( "%s: menu cache miss (hits=%u, misses=%u)",
+				thisfn, plugin->private->cache_hits, plugin->private->cache_misses );
+
+		tree = na_pivot_get_items( plugin->private->pivot );
+		filter = na_pivot_get_candidates( plugin->private->pivot, selection );
+		candidates = NULL;
 
-	nautilus_menu = build_nautilus_menu_rec( tree, target, selection, tokens );
+		dispatch_dynamic_conditions_rec( tree, target, selection, tokens, filter );
+		nautilus_menu = build_nautilus_menu_rec( tree, target, selection, tokens, filter, &candidates );
+		menu_cache_insert( plugin, signature, candidates );
+
+		if( filter ){
+			g_hash_table_destroy( filter );
+		}
+	}
+
+	na_icontext_end_selection();
+	na_dynamic_condition_end_menu();
 
 	/* the NATokens object has been attached (and reffed) by each found
 	 * candidate profile, so it will be actually finalized only on actual
@@ -524,8 +758,14 @@ build_nautilus_menu( NautilusActions *plugin, guint target, GList *selection )
 	return( nautilus_menu );
 }
 
+/*
+ * @filter: if not NULL, the set of items which may be candidate, as
+ *  returned by the NAPivot index; other items are ignored.
+ * @candidates: if not NULL, the list where found candidates are to be
+ *  recorded for the menu cache.
+ */
 static GList *
-build_nautilus_menu_rec( GList *tree, guint target, GList *selection, NATokens *tokens )
+build_nautilus_menu_rec( GList *tree, guint target, GList *selection, NATokens *tokens, GHashTable *filter, GList **candidates )
 {
 	static const gchar *thisfn = "nautilus_actions_build_nautilus_menu_rec";
 	GList *nautilus_menu;
@@ -536,6 +776,7 @@ build_nautilus_menu_rec( GList *tree, guint target, GList *selection, NATokens *
 	NAObjectProfile *profile;
 	NautilusMenuItem *menu_item;
 	gchar *label;
+	MenuCandidate *candidate;
 
 	nautilus_menu = NULL;
 
@@ -545,19 +786,61 @@ build_nautilus_menu_rec( GList *tree, guint target, GList *selection, NATokens *
 		label = na_object_get_label( it->data );
 		g_debug( "%s: examining %s", thisfn, label );
 
+		/* a non-static item is recorded as volatile, whether it is
+		 * candidate or not, and nothing is recorded below it
+		 */
+		candidate = NULL;
+		if( candidates ){
+			if( is_static_item( NA_OBJECT_ITEM( it->data ))){
+				candidate = menu_candidate_new( NA_OBJECT_ITEM( it->data ), FALSE );
+
+			} else {
+				*candidates = g_list_append( *candidates, menu_candidate_new( NA_OBJECT_ITEM( it->data ), TRUE ));
+			}
+		}
+
+		/* a menu may have been filtered out by the index because of the
+		 * basenames of its subitems: it cannot be cached as static
+		 */
+		if( filter && !g_hash_table_lookup( filter, it->data )){
+			g_debug( "%s: is not candidate (NAPivot index): %s", thisfn, label );
+			if( candidate ){
+				if( NA_IS_OBJECT_MENU( it->data )){
+					candidate->is_volatile = TRUE;
+					*candidates = g_list_append( *candidates, candidate );
+				} else {
+					menu_candidate_free( candidate );
+				}
+			}
+			g_free( label );
+			continue;
+		}
+
 		if( !na_icontext_is_candidate( NA_ICONTEXT( it->data ), target, selection )){
 			g_debug( "%s: is not candidate (NAIContext): %s", thisfn, label );
+			if( candidate ){
+				menu_candidate_free( candidate );
+			}
 			g_free( label );
 			continue;
 		}
 
+		if( candidate ){
+			*candidates = g_list_append( *candidates, candidate );
+		}
+
 		item = expand_tokens_item( NA_OBJECT_ITEM( it->data ), tokens );
 
 		/* but we have to re-check for validity as a label may become
 		 * dynamically empty - thus the NAObjectItem invalid :(
+		 * as this depends of the tokens, the item has to be fully
+		 * re-evaluated on each cache hit
 		 */
 		if( !na_object_is_valid( item )){
 			g_debug( "%s: item %s becomes invalid after tokens expansion", thisfn, label );
+			if( candidate ){
+				candidate->is_volatile = TRUE;
+			}
 			g_object_unref( item );
 			g_free( label );
 			continue;
@@ -572,18 +855,10 @@ build_nautilus_menu_rec( GList *tree, guint target, GList *selection, NATokens *
 			subitems = na_object_get_items( NA_OBJECT( it->data ));
 			g_debug( "%s: menu has %d items", thisfn, g_list_length( subitems ));
 
-			submenu = build_nautilus_menu_rec( subitems, target, selection, tokens );
+			submenu = build_nautilus_menu_rec( subitems, target, selection, tokens, filter, candidate ? &candidate->children : NULL );
 			g_debug( "%s: submenu has %d items", thisfn, g_list_length( submenu ));
 
-			if( submenu ){
-				if( target == ITEM_TARGET_TOOLBAR ){
-					nautilus_menu = g_list_concat( nautilus_menu, submenu );
-
-				} else {
-					menu_item = create_item_from_menu( NA_OBJECT_MENU( item ), submenu, target );
-					nautilus_menu = g_list_append( nautilus_menu, menu_item );
-				}
-			}
+			nautilus_menu = append_submenu( nautilus_menu, NA_OBJECT_MENU( item ), submenu, target );
 			g_object_unref( item );
 			g_free( label );
 			continue;
@@ -595,8 +870,11 @@ build_nautilus_menu_rec( GList *tree, guint target, GList *selection, NATokens *
 		 */
 		profile = get_candidate_profile( NA_OBJECT_ACTION( item ), target, selection );
 		if( profile ){
-			menu_item = create_item_from_profile( profile, target, selection, tokens );
+			menu_item = create_item_from_profile( NA_OBJECT_ACTION( item ), profile, target, selection, tokens );
 			nautilus_menu = g_list_append( nautilus_menu, menu_item );
+			if( candidate ){
+				candidate->profile_id = na_object_get_id( profile );
+			}
 
 		} else {
 			g_debug( "%s: %s does not have any valid candidate profile", thisfn, label );
@@ -609,6 +887,200 @@ build_nautilus_menu_rec( GList *tree, guint target, GList *selection, NATokens *
 	return( nautilus_menu );
 }
 
+/*
+ * rebuild the menu from the candidates recorded in the menu cache:
+ * only the tokens expansion has to be done for static items
+ */
+static GList *
+build_nautilus_menu_from_cache( GList *candidates, guint target, GList *selection, NATokens *tokens )
+{
+	static const gchar *thisfn = "nautilus_actions_build_nautilus_menu_from_cache";
+	GList *nautilus_menu;
+	GList *ic;
+	MenuCandidate *candidate;
+	GList *tree;
+	NAObjectItem *item;
+	GList *submenu;
+	NAObjectProfile *profile;
+	NautilusMenuItem *menu_item;
+
+	nautilus_menu = NULL;
+
+	for( ic = candidates ; ic ; ic = ic->next ){
+		candidate = ( MenuCandidate * ) ic->data;
+
+		if( candidate->is_volatile ){
+			tree = g_list_append( NULL, candidate->item );
+			nautilus_menu = g_list_concat( nautilus_menu,
+					build_nautilus_menu_rec( tree, target, selection, tokens, NULL, NULL ));
+			g_list_free( tree );
+			continue;
+		}
+
+		item = expand_tokens_item( candidate->item, tokens );
+
+		if( !na_object_is_valid( item )){
+			g_debug( "%s: item %p becomes invalid after tokens expansion", thisfn, ( void * ) candidate->item );
+			g_object_unref( item );
+			continue;
+		}
+
+		if( NA_IS_OBJECT_MENU( item )){
+			submenu = build_nautilus_menu_from_cache( candidate->children, target, selection, tokens );
+			nautilus_menu = append_submenu( nautilus_menu, NA_OBJECT_MENU( item ), submenu, target );
+
+		} else if( candidate->profile_id ){
+			profile = NA_OBJECT_PROFILE( na_object_get_item( item, candidate->profile_id ));
+			if( profile ){
+				menu_item = create_item_from_profile( NA_OBJECT_ACTION( item ), profile, target, selection, tokens );
+				nautilus_menu = g_list_append( nautilus_menu, menu_item );
+			}
+		}
+
+		g_object_unref( item );
+	}
+
+	return( nautilus_menu );
+}
+
+/*
+ * @submenu: the list of NautilusMenuItem's built for the @menu subitems;
+ *  it is released here.
+ */
+static GList *
+append_submenu( GList *nautilus_menu, NAObjectMenu *menu, GList *submenu, guint target )
+{
+	NautilusMenuItem *menu_item;
+
+	if( submenu ){
+		if( target == ITEM_TARGET_TOOLBAR ){
+			nautilus_menu = g_list_concat( nautilus_menu, submenu );
+
+		} else {
+			menu_item = create_item_from_menu( menu, submenu, target );
+			nautilus_menu = g_list_append( nautilus_menu, menu_item );
+		}
+	}
+
+	return( nautilus_menu );
+}
+
+/*
+ * starts the evaluation of the dynamic conditions of the items of the
+ * @tree which may be candidate, as build_nautilus_menu_rec() will check
+ * them: an item is checked as is, while the profiles of an action are
+ * checked after the tokens expansion
+ */
+static void
+dispatch_dynamic_conditions_rec( GList *tree, guint target, GList *selection, NATokens *tokens, GHashTable *filter )
+{
+	GList *it, *ip;
+
+	for( it = tree ; it ; it = it->next ){
+
+		if( filter && !g_hash_table_lookup( filter, it->data )){
+			continue;
+		}
+
+		if( !na_icontext_may_be_candidate( NA_ICONTEXT( it->data ), target, selection )){
+			continue;
+		}
+
+		dispatch_dynamic_conditions_context( NA_OBJECT( it->data ), NULL );
+
+		if( NA_IS_OBJECT_MENU( it->data )){
+			dispatch_dynamic_conditions_rec( na_object_get_items( it->data ), target, selection, tokens, filter );
+
+		} else {
+			for( ip = na_object_get_items( it->data ) ; ip ; ip = ip->next ){
+				if( na_icontext_may_be_candidate( NA_ICONTEXT( ip->data ), target, selection )){
+					dispatch_dynamic_conditions_context( NA_OBJECT( ip->data ), tokens );
+				}
+			}
+		}
+	}
+}
+
+/*
+ * only the volatile candidates are checked again on a menu cache hit
+ */
+static void
+dispatch_dynamic_conditions_from_cache( GList *candidates, guint target, GList *selection, NATokens *tokens )
+{
+	GList *ic, *tree;
+	MenuCandidate *candidate;
+
+	for( ic = candidates ; ic ; ic = ic->next ){
+		candidate = ( MenuCandidate * ) ic->data;
+
+		if( candidate->is_volatile ){
+			tree = g_list_append( NULL, candidate->item );
+			dispatch_dynamic_conditions_rec( tree, target, selection, tokens, NULL );
+			g_list_free( tree );
+
+		} else if( candidate->children ){
+			dispatch_dynamic_conditions_from_cache( candidate->children, target, selection, tokens );
+		}
+	}
+}
+
+/*
+ * @tokens: if not %NULL, the conditions which embed tokens are expanded
+ *  before being dispatched.
+ */
+static void
+dispatch_dynamic_conditions_context( const NAObject *object, NATokens *tokens )
+{
+	dispatch_dynamic_condition( object, TOKENS_TRY_EXEC,
+			DYNAMIC_CONDITION_TRY_EXEC, na_object_peek_try_exec( object ), tokens );
+	dispatch_dynamic_condition( object, TOKENS_SHOW_IF_REGISTERED,
+			DYNAMIC_CONDITION_SHOW_IF_REGISTERED, na_object_peek_show_if_registered( object ), tokens );
+	dispatch_dynamic_condition( object, TOKENS_SHOW_IF_TRUE,
+			DYNAMIC_CONDITION_SHOW_IF_TRUE, na_object_peek_show_if_true( object ), tokens );
+	dispatch_dynamic_condition( object, TOKENS_SHOW_IF_RUNNING,
+			DYNAMIC_CONDITION_SHOW_IF_RUNNING, na_object_peek_show_if_running( object ), tokens );
+}
+
+static void
+dispatch_dynamic_condition( const NAObject *object, guint field, NADynamicCondition type, const gchar *value, NATokens *tokens )
+{
+	gchar *expanded;
+
+	if( value && strlen( value )){
+		if( tokens && ( get_tokens_mask( object ) & field )){
+			expanded = render_template( object, field, tokens );
+			na_dynamic_condition_dispatch( type, expanded );
+			g_free( expanded );
+
+		} else {
+			na_dynamic_condition_dispatch( type, value );
+		}
+	}
+}
+
+/*
+ * the candidacy of an action depends of its own conditions, and of
+ * those of its profiles; the candidacy of a menu only depends of its
+ * own conditions, subitems being individually recorded
+ */
+static gboolean
+is_static_item( const NAObjectItem *item )
+{
+	gboolean is_static;
+	GList *profiles, *ip;
+
+	is_static = na_icontext_is_static( NA_ICONTEXT( item ));
+
+	if( is_static && NA_IS_OBJECT_ACTION( item )){
+		profiles = na_object_get_items( item );
+		for( ip = profiles ; ip && is_static ; ip = ip->next ){
+			is_static = na_icontext_is_static( NA_ICONTEXT( ip->data ));
+		}
+	}
+
+	return( is_static );
+}
+
 /*
  * expand_tokens_item:
  * @item: a NAObjectItem read from the NAPivot.
@@ -621,124 +1093,318 @@ build_nautilus_menu_rec( GList *tree, guint target, GList *selection, NATokens *
  * - the menu (itself)
  * - the action and its profiles
  *
- * Returns: a duplicated object which has to be g_object_unref() by the caller.
+ * Only the fields which actually embed tokens are expanded:
+ * - an item without any token is returned as is;
+ * - else the item is duplicated without its subitems, and only the
+ *   profiles which embed tokens are themselves duplicated, others being
+ *   shared with the original action.
+ *
+ * Returns: a new reference on either the @item itself or on an expanded
+ * copy, which has to be g_object_unref() by the caller.
  */
 static NAObjectItem *
 expand_tokens_item( const NAObjectItem *src, NATokens *tokens )
 {
 	gchar *old, *new;
 	GSList *subitems_slist, *its, *new_slist;
-	GList *subitems, *it;
+	GList *it, *profiles;
 	NAObjectItem *item;
+	NAObjectProfile *profile;
+	guint mask;
 
-	item = NA_OBJECT_ITEM( na_object_duplicate( src, DUPLICATE_OBJECT ));
+	mask = get_tokens_mask( NA_OBJECT( src ));
+
+	if( !( mask & ~TOKENS_COMPUTED )){
+		return( NA_OBJECT_ITEM( g_object_ref(( gpointer ) src )));
+	}
+
+	item = NA_OBJECT_ITEM( na_object_duplicate( src, DUPLICATE_ONLY ));
 
 	/* label, tooltip and icon name
 	 * plus the toolbar label if this is an action
 	 */
-	old = na_object_get_label( item );
-	new = na_tokens_parse_for_display( tokens, old, TRUE );
-	na_object_set_label( item, new );
-	g_free( old );
-	g_free( new );
-
-	old = na_object_get_tooltip( item );
-	new = na_tokens_parse_for_display( tokens, old, TRUE );
-	na_object_set_tooltip( item, new );
-	g_free( old );
-	g_free( new );
-
-	old = na_object_get_icon( item );
-	new = na_tokens_parse_for_display( tokens, old, TRUE );
-	na_object_set_icon( item, new );
-	g_free( old );
-	g_free( new );
+	if( mask & TOKENS_LABEL ){
+		new = render_template( NA_OBJECT( src ), TOKENS_LABEL, tokens );
+		na_object_set_label( item, new );
+		g_free( new );
+	}
 
-	if( NA_IS_OBJECT_ACTION( item )){
-		old = na_object_get_toolbar_label( item );
-		new = na_tokens_parse_for_display( tokens, old, TRUE );
+	if( mask & TOKENS_TOOLTIP ){
+		new = render_template( NA_OBJECT( src ), TOKENS_TOOLTIP, tokens );
+		na_object_set_tooltip( item, new );
+		g_free( new );
+	}
+
+	if( mask & TOKENS_ICON ){
+		new = render_template( NA_OBJECT( src ), TOKENS_ICON, tokens );
+		na_object_set_icon( item, new );
+		g_free( new );
+	}
+
+	if( mask & TOKENS_TOOLBAR_LABEL ){
+		new = render_template( NA_OBJECT( src ), TOKENS_TOOLBAR_LABEL, tokens );
 		na_object_set_toolbar_label( item, new );
-		g_free( old );
 		g_free( new );
 	}
 
 	/* A NAObjectItem, whether it is an action or a menu, is also a NAIContext
 	 */
-	expand_tokens_context( NA_ICONTEXT( item ), tokens );
+	expand_tokens_context( NA_ICONTEXT( src ), NA_ICONTEXT( item ), tokens, mask );
 
 	/* subitems lists, whether this is the profiles list of an action
 	 * or the items list of a menu, may be dynamic and embed a command;
 	 * this command itself may embed parameters
 	 */
-	subitems_slist = na_object_get_items_slist( item );
-	new_slist = NULL;
-	for( its = subitems_slist ; its ; its = its->next ){
-		old = ( gchar * ) its->data;
-		if( old[0] == '[' && old[strlen(old)-1] == ']' ){
-			new = na_tokens_parse_for_display( tokens, old, FALSE );
-		} else {
-			new = g_strdup( old );
+	if( mask & TOKENS_ITEMS_SLIST ){
+		subitems_slist = na_object_get_items_slist( item );
+		new_slist = NULL;
+		for( its = subitems_slist ; its ; its = its->next ){
+			old = ( gchar * ) its->data;
+			if( old[0] == '[' && old[strlen(old)-1] == ']' ){
+				new = na_tokens_parse_for_display( tokens, old, FALSE );
+			} else {
+				new = g_strdup( old );
+			}
+			new_slist = g_slist_prepend( new_slist, new );
 		}
-		new_slist = g_slist_prepend( new_slist, new );
+		na_object_set_items_slist( item, new_slist );
+		na_core_utils_slist_free( subitems_slist );
+		na_core_utils_slist_free( new_slist );
 	}
-	na_object_set_items_slist( item, new_slist );
-	na_core_utils_slist_free( subitems_slist );
-	na_core_utils_slist_free( new_slist );
 
 	/* last, deal with profiles of an action
+	 * profiles which do not embed any token are shared with the source
 	 */
 	if( NA_IS_OBJECT_ACTION( item )){
+		profiles = NULL;
+
+		for( it = na_object_get_items( src ) ; it ; it = it->next ){
+			profile = expand_tokens_profile( NA_OBJECT_PROFILE( it->data ), tokens );
+			if( profile != it->data ){
+				na_object_set_parent( profile, item );
+			}
+			profiles = g_list_prepend( profiles, profile );
+		}
+
+		na_object_set_items( item, g_list_reverse( profiles ));
+	}
+
+	return( item );
+}
+
+/*
+ * Returns: a new reference on either the @src profile itself or on an
+ * expanded copy.
+ */
+static NAObjectProfile *
+expand_tokens_profile( const NAObjectProfile *src, NATokens *tokens )
+{
+	NAObjectProfile *profile;
+	gchar *new;
+	guint mask;
 
-		subitems = na_object_get_items( item );
+	mask = get_tokens_mask( NA_OBJECT( src ));
 
-		for( it = subitems ; it ; it = it->next ){
+	if( !( mask & ~TOKENS_COMPUTED )){
+		return( NA_OBJECT_PROFILE( g_object_ref(( gpointer ) src )));
+	}
+
+	profile = NA_OBJECT_PROFILE( na_object_duplicate( src, DUPLICATE_ONLY ));
+
+	/* desktop Exec key = GConf path+parameters
+	 * do not touch them here
+	 */
+	if( mask & TOKENS_WORKING_DIR ){
+		new = render_template( NA_OBJECT( src ), TOKENS_WORKING_DIR, tokens );
+		na_object_set_working_dir( profile, new );
+		g_free( new );
+	}
 
-			/* desktop Exec key = GConf path+parameters
-			 * do not touch them here
-			 */
-			old = na_object_get_working_dir( it->data );
-			new = na_tokens_parse_for_display( tokens, old, FALSE );
-			na_object_set_working_dir( it->data, new );
-			g_free( old );
-			g_free( new );
+	/* a NAObjectProfile is also a NAIContext
+	 */
+	expand_tokens_context( NA_ICONTEXT( src ), NA_ICONTEXT( profile ), tokens, mask );
 
-			/* a NAObjectProfile is also a NAIContext
-			 */
-			expand_tokens_context( NA_ICONTEXT( it->data ), tokens );
+	return( profile );
+}
+
+static void
+expand_tokens_context( const NAIContext *src, NAIContext *context, NATokens *tokens, guint mask )
+{
+	gchar *new;
+
+	if( mask & TOKENS_TRY_EXEC ){
+		new = render_template( NA_OBJECT( src ), TOKENS_TRY_EXEC, tokens );
+		na_object_set_try_exec( context, new );
+		g_free( new );
+	}
+
+	if( mask & TOKENS_SHOW_IF_REGISTERED ){
+		new = render_template( NA_OBJECT( src ), TOKENS_SHOW_IF_REGISTERED, tokens );
+		na_object_set_show_if_registered( context, new );
+		g_free( new );
+	}
+
+	if( mask & TOKENS_SHOW_IF_TRUE ){
+		new = render_template( NA_OBJECT( src ), TOKENS_SHOW_IF_TRUE, tokens );
+		na_object_set_show_if_true( context, new );
+		g_free( new );
+	}
+
+	if( mask & TOKENS_SHOW_IF_RUNNING ){
+		new = render_template( NA_OBJECT( src ), TOKENS_SHOW_IF_RUNNING, tokens );
+		na_object_set_show_if_running( context, new );
+		g_free( new );
+	}
+}
+
+/*
+ * returns the bitmap of the fields of the @object which embed tokens,
+ * computing it if not already done
+ */
+static guint
+get_tokens_mask( const NAObject *object )
+{
+	guint mask;
+	const GSList *is;
+	GList *it;
+
+	mask = GPOINTER_TO_UINT( g_object_get_data( G_OBJECT( object ), NAUTILUS_ACTIONS_DATA_TOKENS ));
+
+	if( !mask ){
+		mask = TOKENS_COMPUTED;
+
+		if( NA_IS_OBJECT_ITEM( object )){
+			mask |= compile_template( object, TOKENS_LABEL, na_object_peek_label( object ));
+			mask |= compile_template( object, TOKENS_TOOLTIP, na_object_peek_tooltip( object ));
+			mask |= compile_template( object, TOKENS_ICON, na_object_peek_icon( object ));
+
+			for( is = na_object_peek_items_slist( object ) ; is ; is = is->next ){
+				mask |= has_tokens(( const gchar * ) is->data ) ? TOKENS_ITEMS_SLIST : 0;
+			}
 		}
+
+		if( NA_IS_OBJECT_ACTION( object )){
+			mask |= compile_template( object, TOKENS_TOOLBAR_LABEL, na_object_peek_toolbar_label( object ));
+
+			for( it = na_object_get_items( object ) ; it ; it = it->next ){
+				mask |= ( get_tokens_mask( NA_OBJECT( it->data )) & ~TOKENS_COMPUTED ) ? TOKENS_PROFILES : 0;
+			}
+		}
+
+		if( NA_IS_OBJECT_PROFILE( object )){
+			mask |= compile_template( object, TOKENS_WORKING_DIR, na_object_peek_working_dir( object ));
+		}
+
+		mask |= get_tokens_context_mask( NA_ICONTEXT( object ));
+
+		g_object_set_data( G_OBJECT( object ), NAUTILUS_ACTIONS_DATA_TOKENS, GUINT_TO_POINTER( mask ));
 	}
 
-	return( item );
+	return( mask );
+}
+
+static guint
+get_tokens_context_mask( const NAIContext *context )
+{
+	guint mask;
+
+	mask = 0;
+
+	mask |= compile_template( NA_OBJECT( context ), TOKENS_TRY_EXEC, na_object_peek_try_exec( context ));
+	mask |= compile_template( NA_OBJECT( context ), TOKENS_SHOW_IF_REGISTERED, na_object_peek_show_if_registered( context ));
+	mask |= compile_template( NA_OBJECT( context ), TOKENS_SHOW_IF_TRUE, na_object_peek_show_if_true( context ));
+	mask |= compile_template( NA_OBJECT( context ), TOKENS_SHOW_IF_RUNNING, na_object_peek_show_if_running( context ));
+
+	return( mask );
 }
 
+/*
+ * computes the tokens bitmap of all items of the tree, just after they
+ * have been loaded
+ */
 static void
-expand_tokens_context( NAIContext *context, NATokens *tokens )
+set_tokens_mask_rec( GList *tree )
 {
-	gchar *old, *new;
+	GList *it;
+
+	for( it = tree ; it ; it = it->next ){
+		get_tokens_mask( NA_OBJECT( it->data ));
 
-	old = na_object_get_try_exec( context );
-	new = na_tokens_parse_for_display( tokens, old, FALSE );
-	na_object_set_try_exec( context, new );
-	g_free( old );
-	g_free( new );
+		if( NA_IS_OBJECT_MENU( it->data )){
+			set_tokens_mask_rec( na_object_get_items( it->data ));
+		}
+	}
+}
+
+static gboolean
+has_tokens( const gchar *string )
+{
+	return( string && strchr( string, '%' ) != NULL );
+}
+
+/*
+ * compiles the @string value of the @field of the @object, and attaches
+ * the template to the @object if it actually embeds tokens
+ *
+ * Returns: the @field if it embeds tokens, zero else.
+ */
+static guint
+compile_template( const NAObject *object, guint field, const gchar *string )
+{
+	NATokensTemplate *template;
+	NATokensTemplate **templates;
 
-	old = na_object_get_show_if_registered( context );
-	new = na_tokens_parse_for_display( tokens, old, FALSE );
-	na_object_set_show_if_registered( context, new );
-	g_free( old );
-	g_free( new );
+	if( !has_tokens( string )){
+		return( 0 );
+	}
+
+	template = na_tokens_template_new( string );
+
+	if( !na_tokens_template_has_tokens( template )){
+		na_tokens_template_free( template );
+		return( 0 );
+	}
 
-	old = na_object_get_show_if_true( context );
-	new = na_tokens_parse_for_display( tokens, old, FALSE );
-	na_object_set_show_if_true( context, new );
-	g_free( old );
-	g_free( new );
+	templates = ( NATokensTemplate ** ) g_object_get_data( G_OBJECT( object ), NAUTILUS_ACTIONS_DATA_TEMPLATES );
 
-	old = na_object_get_show_if_running( context );
-	new = na_tokens_parse_for_display( tokens, old, FALSE );
-	na_object_set_show_if_running( context, new );
-	g_free( old );
-	g_free( new );
+	if( !templates ){
+		templates = g_new0( NATokensTemplate *, TOKENS_FIELDS );
+		g_object_set_data_full( G_OBJECT( object ),
+				NAUTILUS_ACTIONS_DATA_TEMPLATES, templates, ( GDestroyNotify ) free_templates );
+	}
+
+	na_tokens_template_free( templates[g_bit_nth_lsf( field, -1 )] );
+	templates[g_bit_nth_lsf( field, -1 )] = template;
+
+	return( field );
+}
+
+/*
+ * Returns: the @field of the @object, expanded against the @tokens,
+ * as a newly allocated string which should be g_free() by the caller.
+ */
+static gchar *
+render_template( const NAObject *object, guint field, NATokens *tokens )
+{
+	NATokensTemplate **templates;
+
+	templates = ( NATokensTemplate ** ) g_object_get_data( G_OBJECT( object ), NAUTILUS_ACTIONS_DATA_TEMPLATES );
+
+	g_return_val_if_fail( templates, NULL );
+
+	return( na_tokens_template_render( templates[g_bit_nth_lsf( field, -1 )], tokens, 0, FALSE ));
+}
+
+static void
+free_templates( NATokensTemplate **templates )
+{
+	guint i;
+
+	for( i = 0 ; i < TOKENS_FIELDS ; ++i ){
+		na_tokens_template_free( templates[i] );
+	}
+
+	g_free( templates );
 }
 
 /*
@@ -773,14 +1439,17 @@ get_candidate_profile( NAObjectAction *action, guint target, GList *files )
 	return( candidate );
 }
 
+/*
+ * @action: the (maybe expanded) action the @profile belongs to; as
+ *  the @profile may be shared with the original action, its parent
+ *  cannot be used here.
+ */
 static NautilusMenuItem *
-create_item_from_profile( NAObjectProfile *profile, guint target, GList *files, NATokens *tokens )
+create_item_from_profile( NAObjectAction *action, NAObjectProfile *profile, guint target, GList *files, NATokens *tokens )
 {
 	NautilusMenuItem *item;
-	NAObjectAction *action;
 	NAObjectProfile *duplicate;
 
-	action = NA_OBJECT_ACTION( na_object_get_parent( profile ));
 	duplicate = NA_OBJECT_PROFILE( na_object_duplicate( profile, DUPLICATE_ONLY ));
 	na_object_set_parent( duplicate, NULL );
 
@@ -846,23 +1515,16 @@ static NautilusMenuItem *
 create_menu_item( const NAObjectItem *item, guint target )
 {
 	NautilusMenuItem *menu_item;
-	gchar *id, *name, *label, *tooltip, *icon;
+	gchar *name;
 
-	id = na_object_get_id( item );
-	name = g_strdup_printf( "%s-%s-%s-%d", PACKAGE, G_OBJECT_TYPE_NAME( item ), id, target );
-	label = na_object_get_label( item );
-	tooltip = na_object_get_tooltip( item );
-	icon = na_object_get_icon( item );
+	name = g_strdup_printf( "%s-%s-%s-%d", PACKAGE, G_OBJECT_TYPE_NAME( item ), na_object_peek_id( item ), target );
 
-	menu_item = nautilus_menu_item_new( name, label, tooltip, icon );
+	menu_item = nautilus_menu_item_new( name,
+			na_object_peek_label( item ), na_object_peek_tooltip( item ), na_object_peek_icon( item ));
 
 	g_object_weak_ref( G_OBJECT( menu_item ), ( GWeakNotify ) weak_notify_menu_item, NULL );
 
-	g_free( icon );
- 	g_free( tooltip );
- 	g_free( label );
- 	g_free( name );
- 	g_free( id );
+	g_free( name );
 
 	return( menu_item );
 }
@@ -1024,6 +1686,7 @@ on_pivot_items_changed_handler( NAPivot *pivot, NautilusActions *plugin )
 
 	if( !plugin->private->dispose_has_run ){
 
+		menu_cache_flush( plugin );
 		na_timeout_event( &plugin->private->change_timeout );
 	}
 }
@@ -1039,6 +1702,7 @@ on_settings_key_changed_handler( const gchar *group, const gchar *key, gconstpoi
 
 	if( !plugin->private->dispose_has_run ){
 
+		menu_cache_flush( plugin );
 		na_timeout_event( &plugin->private->change_timeout );
 	}
 }
@@ -1053,5 +1717,475 @@ on_change_event_timeout( NautilusActions *plugin )
 	g_debug( "%s: timeout expired", thisfn );
 
 	na_pivot_load_items( plugin->private->pivot );
+	set_tokens_mask_rec( na_pivot_get_items( plugin->private->pivot ));
+	menu_cache_flush( plugin );
 	nautilus_menu_provider_emit_items_updated_signal( NAUTILUS_MENU_PROVIDER( plugin ));
 }
+
+/*
+ * the result of some dynamic conditions have only been known after the
+ * deadline of their menu, and differ from what has been displayed:
+ * have the file manager rebuild its menus
+ * the late results are consumed by the next menu build
+ */
+static void
+on_dynamic_condition_late( NautilusActions *plugin )
+{
+	static const gchar *thisfn = "nautilus_actions_on_dynamic_condition_late";
+
+	g_return_if_fail( NAUTILUS_IS_ACTIONS( plugin ));
+
+	if( !plugin->private->dispose_has_run ){
+		g_debug( "%s: plugin=%p", thisfn, ( void * ) plugin );
+		nautilus_menu_provider_emit_items_updated_signal( NAUTILUS_MENU_PROVIDER( plugin ));
+	}
+}
+
+/*
+ * the signature of the selection is built from the distinct
+ * (mimetype, scheme, dirname, file type and capabilities) tuples of the
+ * selected items, plus the target and the count of selected items
+ *
+ * the count itself is bounded to the greatest limit found in the
+ * SelectionCount conditions: above this limit, all counts give the same
+ * result
+ *
+ * the file type and the capabilities are only considered when at least
+ * one item depends on them, so that the attributes of the selected items
+ * do not have to be queried else
+ *
+ * the tuples are collected from the interned strings of the selected
+ * items, so that they are compared by pointer without any copy: only the
+ * distinct tuples are then written in the signature, which must hold the
+ * strings themselves as it is kept across menu builds
+ */
+static gchar *
+menu_cache_get_signature( NautilusActions *plugin, guint target, GList *selection )
+{
+	GHashTable *distincts;
+	GList *it, *keys;
+	NASelectedInfo *nsi;
+	SignatureTuple *tuple;
+	const gchar *login;
+	guint count;
+	GString *signature;
+
+	if( plugin->private->count_limit < 0 ){
+		plugin->private->count_limit = menu_cache_get_count_limit( na_pivot_get_items( plugin->private->pivot ));
+	}
+
+	login = plugin->private->needs_attributes ? getlogin() : NULL;
+	distincts = g_hash_table_new_full(
+			( GHashFunc ) signature_tuple_hash, ( GEqualFunc ) signature_tuple_equal, g_free, NULL );
+	tuple = NULL;
+
+	for( it = selection ; it ; it = it->next ){
+		nsi = NA_SELECTED_INFO( it->data );
+
+		if( !tuple ){
+			tuple = g_new0( SignatureTuple, 1 );
+		}
+		tuple->mimetype = na_selected_info_peek_mime_type( nsi );
+		tuple->scheme = na_selected_info_peek_uri_scheme( nsi );
+		tuple->dirname = na_selected_info_peek_dirname( nsi );
+		tuple->flags = ( na_selected_info_is_local( nsi ) ? 1 << 3 : 0 );
+
+		if( plugin->private->needs_attributes ){
+			tuple->flags |=
+				( na_selected_info_is_directory( nsi ) ? 1 << 0 : 0 ) |
+				( na_selected_info_is_regular( nsi ) ? 1 << 1 : 0 ) |
+				( na_selected_info_is_executable( nsi ) ? 1 << 2 : 0 ) |
+				( na_selected_info_is_owner( nsi, login ) ? 1 << 4 : 0 ) |
+				( na_selected_info_is_readable( nsi ) ? 1 << 5 : 0 ) |
+				( na_selected_info_is_writable( nsi ) ? 1 << 6 : 0 ) |
+				( na_selected_info_is_unresolved( nsi ) ? 1 << 7 : 0 );
+		}
+
+		if( !g_hash_table_lookup_extended( distincts, tuple, NULL, NULL )){
+			g_hash_table_insert( distincts, tuple, NULL );
+			tuple = NULL;
+		}
+	}
+
+	g_free( tuple );
+
+	count = MIN( g_list_length( selection ), ( guint ) plugin->private->count_limit+1 );
+	signature = g_string_new( "" );
+	g_string_append_printf( signature, "%u\n%u", target, count );
+
+	keys = g_list_sort( g_hash_table_get_keys( distincts ), ( GCompareFunc ) signature_tuple_compare );
+	for( it = keys ; it ; it = it->next ){
+		tuple = ( SignatureTuple * ) it->data;
+		g_string_append_printf( signature, "\n%s\t%s\t%s\t%u",
+				tuple->mimetype ? tuple->mimetype : "",
+				tuple->scheme ? tuple->scheme : "",
+				tuple->dirname ? tuple->dirname : "",
+				tuple->flags );
+	}
+	g_list_free( keys );
+
+	g_hash_table_destroy( distincts );
+
+	return( g_string_free( signature, FALSE ));
+}
+
+static guint
+signature_tuple_hash( const SignatureTuple *tuple )
+{
+	return( g_direct_hash( tuple->mimetype ) ^
+			( g_direct_hash( tuple->scheme ) << 1 ) ^
+			( g_direct_hash( tuple->dirname ) << 2 ) ^
+			tuple->flags );
+}
+
+/*
+ * the strings are interned: they are equal if and only if they are the
+ * same pointer
+ */
+static gboolean
+signature_tuple_equal( const SignatureTuple *a, const SignatureTuple *b )
+{
+	return( a->mimetype == b->mimetype &&
+			a->scheme == b->scheme &&
+			a->dirname == b->dirname &&
+			a->flags == b->flags );
+}
+
+/*
+ * the signature must not depend on the order of the selected items
+ */
+static gint
+signature_tuple_compare( const SignatureTuple *a, const SignatureTuple *b )
+{
+	gint cmp;
+
+	cmp = g_strcmp0( a->mimetype, b->mimetype );
+	if( !cmp ){
+		cmp = g_strcmp0( a->scheme, b->scheme );
+	}
+	if( !cmp ){
+		cmp = g_strcmp0( a->dirname, b->dirname );
+	}
+	if( !cmp ){
+		cmp = ( a->flags < b->flags ) ? -1 : ( a->flags > b->flags ? 1 : 0 );
+	}
+
+	return( cmp );
+}
+
+static gint
+menu_cache_get_count_limit( GList *tree )
+{
+	GList *it;
+	const gchar *selection_count;
+	gint limit, sublimit;
+
+	limit = 0;
+
+	for( it = tree ; it ; it = it->next ){
+		selection_count = na_object_peek_selection_count( it->data );
+		if( selection_count && strlen( selection_count )){
+			limit = MAX( limit, atoi( selection_count+1 ));
+		}
+
+		if( NA_IS_OBJECT_ITEM( it->data )){
+			sublimit = menu_cache_get_count_limit( na_object_get_items( it->data ));
+			limit = MAX( limit, sublimit );
+		}
+	}
+
+	return( limit );
+}
+
+static gboolean
+menu_cache_get_needs_attributes( GList *tree )
+{
+	GList *it;
+	gboolean needs;
+
+	needs = FALSE;
+
+	for( it = tree ; it && !needs ; it = it->next ){
+		needs = na_icontext_needs_attributes( NA_ICONTEXT( it->data ));
+
+		if( !needs && NA_IS_OBJECT_ITEM( it->data )){
+			needs = menu_cache_get_needs_attributes( na_object_get_items( it->data ));
+		}
+	}
+
+	return( needs );
+}
+
+/*
+ * returns the cached entry for this @signature, moving it at the head
+ * of the LRU list, or NULL
+ */
+static MenuCacheEntry *
+menu_cache_lookup( NautilusActions *plugin, const gchar *signature )
+{
+	GList *link;
+
+	link = ( GList * ) g_hash_table_lookup( plugin->private->menu_cache, signature );
+
+	if( link ){
+		g_queue_unlink( plugin->private->menu_lru, link );
+		g_queue_push_head_link( plugin->private->menu_lru, link );
+		return(( MenuCacheEntry * ) link->data );
+	}
+
+	return( NULL );
+}
+
+/*
+ * takes ownership of @signature and @candidates
+ */
+static void
+menu_cache_insert( NautilusActions *plugin, gchar *signature, GList *candidates )
+{
+	MenuCacheEntry *entry;
+
+	entry = g_new0( MenuCacheEntry, 1 );
+	entry->signature = signature;
+	entry->candidates = candidates;
+
+	g_queue_push_head( plugin->private->menu_lru, entry );
+	g_hash_table_insert( plugin->private->menu_cache, entry->signature, plugin->private->menu_lru->head );
+
+	while( g_queue_get_length( plugin->private->menu_lru ) > st_menu_cache_size ){
+		entry = ( MenuCacheEntry * ) g_queue_pop_tail( plugin->private->menu_lru );
+		g_hash_table_remove( plugin->private->menu_cache, entry->signature );
+		menu_cache_entry_free( entry );
+	}
+}
+
+static void
+menu_cache_flush( NautilusActions *plugin )
+{
+	static const gchar *thisfn = "nautilus_actions_menu_cache_flush";
+	MenuCacheEntry *entry;
+
+	g_debug( "%s: plugin=%p, count=%u (hits=%u, misses=%u)",
+			thisfn, ( void * ) plugin, g_queue_get_length( plugin->private->menu_lru ),
+			plugin->private->cache_hits, plugin->private->cache_misses );
+
+	g_hash_table_remove_all( plugin->private->menu_cache );
+
+	while(( entry = ( MenuCacheEntry * ) g_queue_pop_head( plugin->private->menu_lru )) != NULL ){
+		menu_cache_entry_free( entry );
+	}
+
+	plugin->private->count_limit = -1;
+	plugin->private->needs_attributes = -1;
+}
+
+static void
+menu_cache_entry_free( MenuCacheEntry *entry )
+{
+	menu_candidate_list_free( entry->candidates );
+	g_free( entry->signature );
+	g_free( entry );
+}
+
+static GList *
+info_cache_get_list_from_item( NautilusActions *plugin, NautilusFileInfo *item )
+{
+	GList *files, *selected;
+
+	files = g_list_prepend( NULL, item );
+	selected = info_cache_get_list_from_list( plugin, files );
+	g_list_free( files );
+
+	return( selected );
+}
+
+/*
+ * returns a list of NASelectedInfo, to be na_selected_info_free_list()
+ * by the caller, taking the already known items from the cache
+ */
+static GList *
+info_cache_get_list_from_list( NautilusActions *plugin, GList *files )
+{
+	static const gchar *thisfn = "nautilus_actions_info_cache_get_list_from_list";
+	GList *selected, *it;
+	NASelectedInfo *info;
+	guint ttl;
+	gint64 now;
+
+	selected = NULL;
+	ttl = na_settings_get_uint( NA_IPREFS_SELECTION_CACHE_TTL, NULL, NULL );
+	now = info_cache_get_time();
+
+	for( it = files ; it ; it = it->next ){
+		info = info_cache_get( plugin, NAUTILUS_FILE_INFO( it->data ), ttl, now );
+
+		if( info ){
+			selected = g_list_prepend( selected, info );
+		}
+	}
+
+	g_debug( "%s: count=%u, cached=%u", thisfn,
+			g_list_length( selected ), g_queue_get_length( plugin->private->info_lru ));
+
+	return( selected ? g_list_reverse( selected ) : NULL );
+}
+
+/*
+ * returns a new reference on the NASelectedInfo for this @file
+ *
+ * an unresolved item is not reused, so that its attributes are queried
+ * again
+ */
+static NASelectedInfo *
+info_cache_get( NautilusActions *plugin, NautilusFileInfo *file, guint ttl, gint64 now )
+{
+	GList *link, *list;
+	InfoCacheEntry *entry;
+	NASelectedInfo *info;
+	gchar *uri;
+
+	uri = nautilus_file_info_get_uri( file );
+	link = ( GList * ) g_hash_table_lookup( plugin->private->info_cache, uri );
+
+	if( link ){
+		entry = ( InfoCacheEntry * ) link->data;
+
+		if( entry->file == file &&
+				now - entry->stamp < ( gint64 ) ttl * 1000 &&
+				!na_selected_info_is_unresolved( entry->info )){
+
+			g_queue_unlink( plugin->private->info_lru, link );
+			g_queue_push_head_link( plugin->private->info_lru, link );
+			g_free( uri );
+
+			return( NA_SELECTED_INFO( g_object_ref( entry->info )));
+		}
+
+		info_cache_remove( plugin, entry );
+	}
+
+	list = na_selected_info_get_list_from_item( file );
+	if( !list ){
+		g_free( uri );
+		return( NULL );
+	}
+
+	info = NA_SELECTED_INFO( list->data );
+	g_list_free( list );
+
+	entry = g_new0( InfoCacheEntry, 1 );
+	entry->uri = uri;
+	entry->info = NA_SELECTED_INFO( g_object_ref( info ));
+	entry->file = file;
+	entry->stamp = now;
+	entry->plugin = plugin;
+	entry->changed_handler = g_signal_connect( file, "changed", G_CALLBACK( on_info_cache_file_changed ), entry );
+	g_object_weak_ref( G_OBJECT( file ), ( GWeakNotify ) on_info_cache_file_finalized, entry );
+
+	g_queue_push_head( plugin->private->info_lru, entry );
+	g_hash_table_insert( plugin->private->info_cache, entry->uri, plugin->private->info_lru->head );
+
+	while( g_queue_get_length( plugin->private->info_lru ) > st_info_cache_size ){
+		info_cache_remove( plugin, ( InfoCacheEntry * ) g_queue_peek_tail( plugin->private->info_lru ));
+	}
+
+	return( info );
+}
+
+static void
+info_cache_remove( NautilusActions *plugin, InfoCacheEntry *entry )
+{
+	GList *link;
+
+	link = ( GList * ) g_hash_table_lookup( plugin->private->info_cache, entry->uri );
+	g_hash_table_remove( plugin->private->info_cache, entry->uri );
+	g_queue_delete_link( plugin->private->info_lru, link );
+
+	info_cache_entry_free( entry );
+}
+
+static void
+info_cache_flush( NautilusActions *plugin )
+{
+	InfoCacheEntry *entry;
+
+	g_hash_table_remove_all( plugin->private->info_cache );
+
+	while(( entry = ( InfoCacheEntry * ) g_queue_pop_head( plugin->private->info_lru )) != NULL ){
+		info_cache_entry_free( entry );
+	}
+}
+
+static void
+info_cache_entry_free( InfoCacheEntry *entry )
+{
+	if( entry->file ){
+		g_signal_handler_disconnect( entry->file, entry->changed_handler );
+		g_object_weak_unref( G_OBJECT( entry->file ), ( GWeakNotify ) on_info_cache_file_finalized, entry );
+	}
+
+	g_object_unref( entry->info );
+	g_free( entry->uri );
+	g_free( entry );
+}
+
+static gint64
+info_cache_get_time( void )
+{
+#if GLIB_CHECK_VERSION( 2, 28, 0 )
+	return( g_get_monotonic_time());
+#else
+	GTimeVal now;
+
+	g_get_current_time( &now );
+
+	return(( gint64 ) now.tv_sec * G_USEC_PER_SEC + now.tv_usec );
+#endif
+}
+
+static void
+on_info_cache_file_changed( NautilusFileInfo *file, InfoCacheEntry *entry )
+{
+	info_cache_remove( entry->plugin, entry );
+}
+
+static void
+on_info_cache_file_finalized( InfoCacheEntry *entry, GObject *file )
+{
+	entry->file = NULL;
+
+	info_cache_remove( entry->plugin, entry );
+}
+
+/*
+ * the candidate keeps a reference on the NAObjectItem, so that it stays
+ * safe even if NAPivot reloads its items before the cache be flushed
+ */
+static MenuCandidate *
+menu_candidate_new( const NAObjectItem *item, gboolean is_volatile )
+{
+	MenuCandidate *candidate;
+
+	candidate = g_new0( MenuCandidate, 1 );
+	candidate->item = NA_OBJECT_ITEM( g_object_ref(( gpointer ) item ));
+	candidate->is_volatile = is_volatile;
+	candidate->profile_id = NULL;
+	candidate->children = NULL;
+
+	return( candidate );
+}
+
+static void
+menu_candidate_free( MenuCandidate *candidate )
+{
+	menu_candidate_list_free( candidate->children );
+	g_free( candidate->profile_id );
+	g_object_unref( candidate->item );
+	g_free( candidate );
+}
+
+static void
+menu_candidate_list_free( GList *candidates )
+{
+	g_list_foreach( candidates, ( GFunc ) menu_candidate_free, NULL );
+	g_list_free( candidates );
+}